@@ -194,13 +194,14 @@ SpectrumView::SpectrumView(const VSTGUI::CRect& size, IControlListener* listener
     // --- buffer being drawn, only ever used by draw code
     currentFFTMagBuffer = nullptr;
 
-    // --- FFTW inits
-    data        = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
-    fft_result  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
-    ifft_result = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
+    // --- FFTW inits; real input so the r2c/c2r transforms only need the half spectrum
+    data        = (double*) fftw_malloc(sizeof(double) * FFT_LEN);
+    fft_result  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_BINS);
+    ifft_result = (double*) fftw_malloc(sizeof(double) * FFT_LEN);
 
-    plan_forward  = fftw_plan_dft_1d(FFT_LEN, data, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
-    plan_backward = fftw_plan_dft_1d(FFT_LEN, fft_result, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
+    // --- the plans are shared with the FFT objects through the registry
+    plan_forward  = FFTWPlanRegistry::getInstance().getPlan(FFT_LEN, fftwPlanType::kRealToComplex);
+    plan_backward = FFTWPlanRegistry::getInstance().getPlan(FFT_LEN, fftwPlanType::kComplexToReal);
 
     // --- window
     setWindow(spectrumViewWindowType::kBlackmanHarrisWindow);
@@ -208,9 +209,7 @@ SpectrumView::SpectrumView(const VSTGUI::CRect& size, IControlListener* listener
 
 SpectrumView::~SpectrumView()
 {
-    fftw_destroy_plan( plan_forward );
-    fftw_destroy_plan( plan_backward );
-
+    // --- the plans belong to the FFTWPlanRegistry
     fftw_free( data );
     fftw_free( fft_result );
     fftw_free( ifft_result );
@@ -252,8 +251,7 @@ bool SpectrumView::addFFTInputData(double inputSample)
     if(fftInputCounter >= FFT_LEN)
         return false;
 
-    data[fftInputCounter][0] = inputSample*fftWindow[fftInputCounter]; // stick your audio samples in here
-    data[fftInputCounter][1] = 0.0; // use this if your data is complex valued
+    data[fftInputCounter] = inputSample*fftWindow[fftInputCounter]; // stick your audio samples in here
 
     fftInputCounter++;
     if(fftInputCounter == FFT_LEN)
@@ -294,7 +292,7 @@ void SpectrumView::updateView()
     if(fftReady)
     {
         // do the FFT
-        fftw_execute(plan_forward);
+        fftw_execute_dft_r2c(plan_forward, data, fft_result);
 
         double* bufferToFill = nullptr;
         fftMagBuffersEmpty->try_dequeue(bufferToFill);
@@ -307,13 +305,14 @@ void SpectrumView::updateView()
         }
 
         int maxIndex = 0;
-        for(int i=0; i<FFT_LEN; i++)
+        for(int i=0; i<FFT_BINS; i++)
         {
             bufferToFill[i] = (getMagnitude(fft_result[i][0], fft_result[i][1]));
         }
 
         // --- normalize the FFT buffer for max = 1.0 (note this is NOT dB!!)
-        normalizeBufferGetFMax(bufferToFill, 512, &maxIndex);
+        //     the upper half of the spectrum mirrors the lower, so the half spectrum has the same max
+        normalizeBufferGetFMax(bufferToFill, FFT_BINS, &maxIndex);
 
         // 1) homework = do plot in dB
         // 2) homework = add other windows
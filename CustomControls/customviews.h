@@ -96,6 +96,7 @@ private:
 #ifdef HAVE_FFTW
 // --- FFTW (REQUIRED)
 #include "fftw3.h"
+#include "../PluginObjects/fxobjects.h"	// --- FFTWPlanRegistry
 
 /**
 \enum spectrumViewWindowType
@@ -114,6 +115,7 @@ enum class spectrumViewWindowType {kRectWindow, kHannWindow, kBlackmanHarrisWind
 
 // --- change this for higher accuracy; needs to be power of 2
 const int FFT_LEN = 512;
+const int FFT_BINS = FFT_LEN / 2 + 1;	///< bins in the half spectrum of the real FFT
 
 // --- SpectrumView
 /*
@@ -173,11 +175,11 @@ protected:
 	spectrumViewWindowType window = spectrumViewWindowType::kRectWindow; ///< window type
 
     // --- setup FFTW
-    fftw_complex* data = nullptr;			///< fft input data
-	fftw_complex* fft_result = nullptr;		///< fft output data
-	fftw_complex* ifft_result = nullptr;	///< ifft output (not used)
-	fftw_plan plan_forward;					///< plan for FFT
-	fftw_plan plan_backward;				///< plan for IFFT (not used)
+    double* data = nullptr;					///< fft input data (real)
+	fftw_complex* fft_result = nullptr;		///< fft output data (half spectrum, FFT_BINS long)
+	double* ifft_result = nullptr;			///< ifft output (not used)
+	fftw_plan plan_forward;					///< plan for FFT, shared from the FFTWPlanRegistry
+	fftw_plan plan_backward;				///< plan for IFFT (not used), shared from the FFTWPlanRegistry
 
     // --- for FFT data input
     int fftInputCounter = 0;				///< input counter for FFT
@@ -189,8 +191,8 @@ protected:
     bool addFFTInputData(double inputSample);
 
     // --- a double buffer pair of magnitude arrays
-    double fftMagnitudeArray_A[FFT_LEN] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
-    double fftMagnitudeArray_B[FFT_LEN] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
+    double fftMagnitudeArray_A[FFT_BINS] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
+    double fftMagnitudeArray_B[FFT_BINS] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
 
     // --- buffer for the assigned window
     double fftWindow[FFT_LEN] = {1.0}; ///< window buffer
@@ -406,16 +406,16 @@ bool PluginCore::reset(ResetInfo& resetInfo)
     audioProcDescriptor.sampleRate = resetInfo.sampleRate;
     audioProcDescriptor.bitDepth = resetInfo.bitDepth;
 
-	// --- RESET is in 2 parts: first the normal call
+	// --- the 2 second delay buffers were reserved in initialize( ), so a sample rate
+	//     change only re-cooks and flushes; nothing is allocated here
 	monoDelay.reset(resetInfo.sampleRate);
 
-	// --- THEN create 2 second delay buffers
-	monoDelay.createDelayBuffers(resetInfo.sampleRate, 2000.0);
-
 	// --- modulated delay FX
 	modDelay.reset(resetInfo.sampleRate);
 
-	
+	// --- sample rate dependent values must be re-cooked
+	re201ParamsDirty = true;
+	modDelayParamsDirty = true;
 	
     // --- other reset inits
     return PluginBase::reset(resetInfo);
@@ -431,6 +431,18 @@ bool PluginCore::initialize(PluginInfo& pluginInfo)
 {
 	// --- add one-time init stuff here
 
+	// --- pre-allocate (and pre-fault) the delay lines for the worst case sample rate, off the audio thread
+	if (delayMemoryReserved == 0)
+	{
+		delayMemoryReserved = RE201FloatExact::getDelayMemoryBytes(kMaxSampleRate, kTapeLength_mSec) +
+							  ModulatedDelay::getDelayMemoryBytes(kMaxSampleRate);
+		DelayMemoryArena::getInstance().reserve(delayMemoryReserved);
+
+		// --- allocate once for the highest rate; this also sets the tape length
+		monoDelay.reserveDelayBuffers(kMaxSampleRate, kTapeLength_mSec);
+		modDelay.reserveDelayBuffers(kMaxSampleRate);
+	}
+
 	return true;
 }
 
@@ -454,11 +466,30 @@ bool PluginCore::preProcessAudioBuffers(ProcessBufferInfo& processInfo)
     //     want to use the auto-variable-binding
     syncInBoundVariables();
 
+	// --- tempo is read once per buffer; the RE201 re-cooks its synced heads only if it changed,
+	//     and tracks it even when sync is off so that switching sync on lands on the right note
+	if (processInfo.hostInfo && processInfo.hostInfo->dBPM != lastHostBPM)
+	{
+		lastHostBPM = processInfo.hostInfo->dBPM;
+		monoDelay.getHostBPM(processInfo.hostInfo);
+	}
+
     return true;
 }
 
 // --- updater
-void PluginCore::updateParameters() {
+void PluginCore::updateParameters()
+{
+	if (re201ParamsDirty)
+		updateRE201Parameters();
+
+	if (modDelayParamsDirty)
+		updateModDelayParameters();
+}
+
+void PluginCore::updateRE201Parameters()
+{
+	re201ParamsDirty = false;
 
 	// ** MULTI TAP DELAY **
 	// --- get
@@ -486,6 +517,7 @@ void PluginCore::updateParameters() {
 
 	// --- sidechain
 	params.sidechainThresh_db = sidechainThresh_db;
+	params.sidechainAmount = sidechainAmt;
 	params.enableSidechain = enableSidechain;
 	if (!compareIntToEnum(sidechainTarget, sidechainTargetEnum::Delay))
 		params.enableSidechain = false;
@@ -501,9 +533,16 @@ void PluginCore::updateParameters() {
 	// --- mode
 	params.mode = mode;
 
+	// --- Hermite keeps the top end through tape speed changes without oversampling
+	params.interpolation = delayInterpolation::kHermite;
+
 	// --- set
 	monoDelay.setParameters(params);
+}
 
+void PluginCore::updateModDelayParameters()
+{
+	modDelayParamsDirty = false;
 
 	// ** MODULATED DELAY **
 	ModulatedDelayParameters modParams = modDelay.getParameters();
@@ -532,9 +571,10 @@ void PluginCore::updateParameters() {
 	if (!compareIntToEnum(sidechainTarget, sidechainTargetEnum::FX))
 		modParams.enableSidechain = false;
 
+	// --- Hermite keeps the top end of the swept reads without oversampling
+	modParams.interpolation = delayInterpolation::kHermite;
 
 	modDelay.setParameters(modParams);
-
 }
 
 /**
@@ -564,11 +604,6 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 	double xnR = processFrameInfo.audioInputFrame[1];
 
 	float bufferFrame[2];
-
-	// --- bpm
-	if (enableBPM) {
-		monoDelay.getHostBPM(processFrameInfo.hostInfo);
-	}
 		
 
 	// ** SIDECHAIN **
@@ -650,6 +685,129 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 }
 
 
+/**
+\brief buffer-processing method
+
+Operation:
+- sync the bound variables and cook any dirty parameters once for the buffer
+- walk the frames only to fire MIDI events and perform smoothing/VST3 sample accurate updates
+- the audio is processed in runs of frames between parameter changes with processAudioBlock( ),
+  so the output is sample-identical to the frame-based path in processAudioFrame( )
+- I/O combinations without a block path fall back to the base class frame processing
+
+\param processBufferInfo structure of information about *buffer* processing
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
+{
+	// --- only mono->mono, mono->stereo and stereo->stereo have a block path
+	bool supportedIO = processBufferInfo.numAudioInChannels > 0 &&
+		processBufferInfo.numAudioInChannels <= 2 &&
+		processBufferInfo.numAudioOutChannels >= processBufferInfo.numAudioInChannels &&
+		processBufferInfo.numAudioOutChannels <= 2;
+
+	if (!supportedIO)
+		return PluginBase::processAudioBuffers(processBufferInfo);
+
+	double sampleInterval = 1.0 / audioProcDescriptor.sampleRate;
+
+	// --- sync internal bound variables
+	preProcessAudioBuffers(processBufferInfo);
+
+	// --- cook whatever changed, once for the buffer
+	updateParameters();
+
+	bool fireMIDIEvents = processBufferInfo.midiEventQueue &&
+		processBufferInfo.midiEventQueue->getEventCount() > 0;
+
+	uint32_t startFrame = 0;
+	for (uint32_t frame = 0; frame < processBufferInfo.numFramesToProcess; frame++)
+	{
+		// --- fire any MIDI events for this sample interval
+		if (fireMIDIEvents)
+			processBufferInfo.midiEventQueue->fireMidiEvents(frame);
+
+		// --- do per-frame updates; VST automation and parameter smoothing
+		doSampleAccurateParameterUpdates();
+
+		// --- a change point: finish the run with the old values, then re-cook
+		if (parametersDirty())
+		{
+			processAudioBlock(processBufferInfo, startFrame, frame - startFrame);
+			startFrame = frame;
+			updateParameters();
+		}
+
+		// --- update per-frame
+		processBufferInfo.hostInfo->uAbsoluteFrameBufferIndex += 1;
+		processBufferInfo.hostInfo->dAbsoluteFrameBufferTime += sampleInterval;
+	}
+
+	// --- the remainder
+	processAudioBlock(processBufferInfo, startFrame, processBufferInfo.numFramesToProcess - startFrame);
+
+	// --- generally not used
+	postProcessAudioBuffers(processBufferInfo);
+
+	return true; /// processed
+}
+
+/**
+\brief process a run of frames with the current parameter settings
+
+\param processBufferInfo structure of information about *buffer* processing
+\param startFrame the first frame of the run
+\param numFrames the number of frames in the run
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames)
+{
+	if (numFrames == 0)
+		return true;
+
+	uint32_t numInputChannels = processBufferInfo.numAudioInChannels;
+	uint32_t numOutputChannels = processBufferInfo.numAudioOutChannels;
+
+	const float* inputs[2] = { nullptr, nullptr };
+	float* outputs[2] = { nullptr, nullptr };
+	const float* auxInputs[2] = { nullptr, nullptr };
+
+	for (uint32_t i = 0; i < numInputChannels; i++)
+		inputs[i] = &processBufferInfo.inputs[i][startFrame];
+
+	for (uint32_t i = 0; i < numOutputChannels; i++)
+		outputs[i] = &processBufferInfo.outputs[i][startFrame];
+
+	// ** SIDECHAIN **
+	if (processBufferInfo.numAuxAudioInChannels > 0)
+	{
+		uint32_t numAuxChannels = processBufferInfo.numAuxAudioInChannels > 2 ? 2 : processBufferInfo.numAuxAudioInChannels;
+
+		for (uint32_t i = 0; i < numAuxChannels; i++)
+			auxInputs[i] = &processBufferInfo.auxInputs[i][startFrame];
+
+		monoDelay.enableAuxInput(true);
+		monoDelay.processAuxInputAudioBlock(auxInputs, numAuxChannels);
+
+		modDelay.enableAuxInput(true);
+		modDelay.processAuxInputAudioBlock(auxInputs, numAuxChannels);
+	}
+
+	// ** DELAY **
+	bool processed = monoDelay.processAudioBlock(inputs, outputs, numFrames, numInputChannels);
+
+	// --- mono in, stereo out: duplicate the left output
+	if (numInputChannels == 1 && numOutputChannels == 2)
+		memcpy(outputs[1], outputs[0], numFrames * sizeof(float));
+
+	// ** MODULATED DELAY **
+	if (!enableDelayFX)
+		return processed;
+
+	return modDelay.processAudioBlock(outputs, outputs, numFrames, numOutputChannels);
+}
 
 /**
 \brief do anything needed prior to arrival of audio buffers
@@ -736,18 +894,83 @@ bool PluginCore::postUpdatePluginParameter(int32_t controlID, double controlValu
     // --- now do any post update cooking; be careful with VST Sample Accurate automation
     //     If enabled, then make sure the cooking functions are short and efficient otherwise disable it
     //     for the Parameter involved
-    /*switch(controlID)
+    //
+    // --- here we only flag the member objects that consume the parameter; the cooking happens
+    //     in updateParameters( ) once per buffer or at the next sample accurate change point
+    switch(controlID)
     {
-        case 0:
-        {
-            return true;    /// handled
-        }
+		// --- RE201 only
+		case controlID::delay_ms:
+		case controlID::feedback1_pct:
+		case controlID::wetVolume_db:
+		case controlID::dryVolume_db:
+		case controlID::mode:
+		case controlID::enableBPM:
+		case controlID::delay1_bpm:
+		case controlID::sidechainAmt:
+		{
+			if (controlValueChanged(controlID, controlValue))
+				re201ParamsDirty = true;
+			return true;    /// handled
+		}
+
+		// --- ModulatedDelay only
+		case controlID::delayFX:
+		case controlID::fxRate:
+		case controlID::fxDepth:
+		case controlID::fxFeedback:
+		{
+			if (controlValueChanged(controlID, controlValue))
+				modDelayParamsDirty = true;
+			return true;    /// handled
+		}
+
+		// --- modulators and their targets feed both objects
+		case controlID::threshold_db:
+		case controlID::envAmount:
+		case controlID::enableEnvelope:
+		case controlID::envTarget:
+		case controlID::enableSidechain:
+		case controlID::sidechainTarget:
+		case controlID::sidechainThresh_db:
+		case controlID::enableLFO:
+		case controlID::lfoTarget:
+		case controlID::lfoRate_hz:
+		case controlID::lfoAmount:
+		{
+			if (controlValueChanged(controlID, controlValue))
+			{
+				re201ParamsDirty = true;
+				modDelayParamsDirty = true;
+			}
+			return true;    /// handled
+		}
 
         default:
             return false;   /// not handled
-    }*/
+    }
+}
+
+/**
+\brief compares a control value with the last one seen for its controlID; syncInBoundVariables( ) posts every
+	   bound parameter at the top of each buffer, so this is what keeps an unchanged parameter from re-cooking
 
-    return false;
+\param controlID the control ID value of the parameter
+\param controlValue the new control value
+
+\return true if the value changed (or is the first one seen), false otherwise
+*/
+bool PluginCore::controlValueChanged(int32_t controlID, double controlValue)
+{
+	if (controlID < 0 || controlID >= kMaxCookedControlID)
+		return true;
+
+	if (cookedControlValid[controlID] && cookedControlValue[controlID] == controlValue)
+		return false;
+
+	cookedControlValid[controlID] = true;
+	cookedControlValue[controlID] = controlValue;
+	return true;
 }
 
 /**
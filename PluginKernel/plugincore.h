@@ -76,8 +76,8 @@ class PluginCore : public PluginBase
 public:
     PluginCore();
 
-	/** Destructor: empty in default version */
-    virtual ~PluginCore(){}
+	/** Destructor: withdraw the delay memory reservation made in initialize( ) */
+    virtual ~PluginCore(){ DelayMemoryArena::getInstance().unreserve(delayMemoryReserved); }
 
 	// --- PluginBase Overrides ---
 	//
@@ -96,9 +96,8 @@ public:
 	/** process frames of data */
 	virtual bool processAudioFrame(ProcessFrameInfo& processFrameInfo);
 
-	// --- uncomment and override this for buffer processing; see base class implementation for
-	//     help on breaking up buffers and getting info from processBufferInfo
-	//virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
+	/** process buffers: runs the RE201 and modulated delay on blocks of frames instead of single frames */
+	virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
 
 	/** preProcess: do any post-buffer processing required; default operation is to send metering data to GUI  */
 	virtual bool postProcessAudioBuffers(ProcessBufferInfo& processInfo);
@@ -129,9 +128,37 @@ public:
 
 	// --- BEGIN USER VARIABLES AND FUNCTIONS -------------------------------------- //
 	//	   Add your variables and methods here
-	RE201 monoDelay;
+	RE201FloatExact monoDelay;	///< float, exact-length tape: the 2 second delay lines dominate the memory footprint
 	ModulatedDelay modDelay;
+
+	/** re-cook only the member objects whose parameters are dirty */
 	void updateParameters();
+	void updateRE201Parameters();
+	void updateModDelayParameters();
+
+	/** process a run of frames [startFrame, startFrame + numFrames) of the current buffer with the current parameters */
+	bool processAudioBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames);
+
+	/** true if any member object needs re-cooking; the buffer processor splits the block here */
+	bool parametersDirty() { return re201ParamsDirty || modDelayParamsDirty; }
+
+	// --- dirty flags, set in postUpdatePluginParameter( ) and cleared when the object is re-cooked
+	bool re201ParamsDirty = true;		///< RE201 needs setParameters( )
+	bool modDelayParamsDirty = true;	///< ModulatedDelay needs setParameters( )
+
+	/** true if controlValue differs from the last value seen for controlID; remembers it */
+	bool controlValueChanged(int32_t controlID, double controlValue);
+
+	// --- syncInBoundVariables( ) posts every bound parameter each buffer; only real changes set the dirty flags
+	static const int32_t kMaxCookedControlID = 128;				///< controlIDs are below this
+	double cookedControlValue[kMaxCookedControlID] = { 0.0 };	///< last value passed to postUpdatePluginParameter( )
+	bool cookedControlValid[kMaxCookedControlID] = { false };	///< false until the first value arrives
+	double lastHostBPM = 0.0;			///< tempo last pushed to the RE201, checked once per buffer
+
+	// --- delay memory is reserved in initialize( ) for the worst case so that reset( ) does not go to the OS
+	static constexpr double kTapeLength_mSec = 2000.0;		///< RE201 delay buffer length
+	static constexpr double kMaxSampleRate = 192000.0;		///< highest sample rate covered by the reservation
+	size_t delayMemoryReserved = 0;							///< bytes reserved in the DelayMemoryArena
 
 
 	// --- END USER VARIABLES AND FUNCTIONS -------------------------------------- //
@@ -64,6 +64,9 @@ struct RE201Parameters
 		// --- mode
 		mode = params.mode;
 
+		// --- tape heads
+		interpolation = params.interpolation;
+
 		// --- MUST be last
 		return *this;
 	}
@@ -100,14 +103,58 @@ struct RE201Parameters
 	// --- mode
 	int mode = 9;
 
+	// --- tape heads
+	delayInterpolation interpolation = delayInterpolation::kLinear;	///< head read interpolator
+
 };
 
+/**
+\struct RE201HeadMix
+\ingroup FX-Objects
+\brief
+One playback head combination (mode) of the RE201: the gain scaling and pan position of each of the four heads.
+setParameters( ) compiles the selected entry into a cached tap-to-output gain matrix, so new head combinations
+only need a new table entry.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+const unsigned int RE201_NUM_HEADS = 4;
+const unsigned int RE201_NUM_MODES = 6;
+const double kTapMatrixRamp_mSec = 20.0;	///< mode/echo volume crossfade time
+const unsigned int kTapBlockSize = 64;		///< longest run of head reads done ahead of the writes
+const unsigned int kDuckingControlPeriod = 32;	///< samples between envelope/sidechain ducking gain updates
+const double kDelayTimeRamp_mSec = 50.0;		///< tape speed glide when the delay time or tempo changes
+
+// --- length of each rateBPM note value in beats; the two triplet entries keep the original 3/2 and 3/4 scaling
+const unsigned int RE201_NUM_RATES = 6;
+const double re201RateBeats[RE201_NUM_RATES] = { 2.0, 1.0, 1.5, 0.5, 0.75, 0.25 };
+
+struct RE201HeadMix
+{
+	double headGain[RE201_NUM_HEADS];	///< gain scaling of each head, 0.0 = head off
+	double headPan[RE201_NUM_HEADS];	///< pan position of each head, -1.0 (left) to +1.0 (right)
+};
+
+// --- index 0 is used for any mode outside of [1, RE201_NUM_MODES]: all heads, unity gain, centered
+const RE201HeadMix re201HeadMixTable[RE201_NUM_MODES + 1] =
+{
+	{ { 1.0,  1.0,  1.0,  1.0  }, { 0.0, 0.0,  0.0, 0.0 } },	// --- all heads
+	{ { 1.0,  0.0,  0.0,  0.0  }, { 0.0, 0.0,  0.0, 0.0 } },	// --- mode 1
+	{ { 0.5,  0.5,  0.0,  0.0  }, { 0.0, 1.0,  0.0, 0.0 } },	// --- mode 2
+	{ { 0.5,  0.0,  0.5,  0.0  }, { 0.0, 0.0, -1.0, 0.0 } },	// --- mode 3
+	{ { 0.5,  0.0,  0.0,  0.5  }, { 0.0, 0.0,  0.0, 0.7 } },	// --- mode 4
+	{ { 0.33, 0.0,  0.33, 0.33 }, { 0.0, 0.0,  1.0, -1.0 } },	// --- mode 5
+	{ { 0.25, 0.25, 0.25, 0.25 }, { 0.0, 1.0,  0.5, -1.0 } }	// --- mode 6
+};
 
 /**
-\class RE201
+\class RE201T
 \ingroup FX-Objects
 \brief
-The RE201 object implements ....
+The RE201T object implements ....
 
 Audio I/O:
 - Processes mono input to mono output.
@@ -116,16 +163,23 @@ Audio I/O:
 Control I/F:
 - Use RE201Parameters structure to get/set object params.
 
+Storage:
+- StorageType is the tape (delay line) sample type; all arithmetic is double. The 2 second tape is
+  large, so RE201Float halves the footprint of each instance; RE201 keeps double storage.
+- DelayLine is CircularBuffer (power of two, the default) or ExactCircularBuffer; RE201FloatExact
+  combines float storage with an exact-length tape.
+
 \author <Your Name> <http://www.yourwebsite.com>
 \remark <Put any remarks or notes here>
 \version Revision : 1.0
 \date Date : 2019 / 01 / 31
 */
-class RE201 : public IAudioSignalProcessor
+template <typename StorageType, template <typename> class DelayLine = CircularBuffer>
+class RE201T : public IAudioSignalProcessor
 {
 public:
-	RE201(void) {}	/* C-TOR */
-	~RE201(void) {}	/* D-TOR */
+	RE201T(void) {}	/* C-TOR */
+	~RE201T(void) {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
@@ -138,17 +192,38 @@ public:
 			delayBuffer[1].flushBuffer();
 		}
 		else
+		{
+			// --- no allocation if reserveDelayBuffers( ) covered this rate; re-cook the delay times for it
 			createDelayBuffers(_sampleRate, bufferLength_mSec);
+			cookRateTable();
+		}
+
+		// --- the tape is silent, so the heads jump to their positions instead of gliding
+		delayTimesLive = false;
+		cookDelayTimes();
+
+		// --- no need to crossfade into silence
+		compileTapMatrix(false);
 
 		// ** MODULATION **
-		// --- detector
-		detector.reset(_sampleRate);
-		AudioDetectorParameters detectorParams = detector.getParameters();
+		// --- detectors: stereo-linked, one on the input and one on the sidechain
+		AudioDetectorParameters detectorParams = envelopeDetector.getParameters();
 		detectorParams.clampToUnityMax = false;
 		detectorParams.detect_dB = true;
+		detectorParams.fastLog = true;
 		detectorParams.attackTime_mSec = 10.0;
 		detectorParams.releaseTime_mSec = 50.0;
-		detector.setParameters(detectorParams);
+
+		envelopeDetector.reset(_sampleRate);
+		envelopeDetector.setParameters(detectorParams);
+		sidechainDetector.reset(_sampleRate);
+		sidechainDetector.setParameters(detectorParams);
+
+		// --- ducking starts open
+		envelopeGain = envelopeGainTarget = 1.0;
+		sidechainGain = sidechainGainTarget = 1.0;
+		envelopeGainInc = sidechainGainInc = 0.0;
+		duckingCounter = 0;
 
 		// --- lfo
 		modLFO.reset(_sampleRate);
@@ -164,10 +239,33 @@ public:
 		return 0.0;
 	}
 
-	//** get bpm from the hostinfo pointer
+	/** process the sidechain block by saving the buffer pointers for the upcoming processAudioBlock() call */
+	virtual void processAuxInputAudioBlock(const float* const* auxInputs, uint32_t numAuxChannels)
+	{
+		auxInputBlock = auxInputs;
+		numAuxInputChannels = numAuxChannels;
+	}
+
+	/** get bpm from the hostinfo pointer; call once per buffer */
 	virtual void getHostBPM(HostInfo* hostInfo)
 	{
-		bpm = hostInfo->dBPM;
+		setBPM(hostInfo->dBPM);
+	}
+
+	/** set the tempo; the note value table and (when synced) the heads are only re-cooked if it changed */
+	/**
+	\param _bpm tempo in beats per minute; <= 0 is ignored
+	*/
+	void setBPM(double _bpm)
+	{
+		if (_bpm <= 0.0 || _bpm == bpm)
+			return;
+
+		bpm = _bpm;
+		cookRateTable();
+
+		if (parameters.enableBPM)
+			cookDelayTimes();
 	}
 
 	/** process MONO input */
@@ -189,139 +287,12 @@ public:
 					     uint32_t inputChannels,
 					     uint32_t outputChannels)
 	{
-		// --- read delay
-		double ynL[4];
-		double ynR[4];
-
-		double detectorReduction[2] = { 1.0, 1.0 };
-		
-
-		// ** DETECTOR **
-		if (parameters.enableEnv)
-		{
-			double detect_db[2];
-			double output_db[2];
-			double gainReduction[2];
-
-			for (int i = 0; i < 2; i++)
-			{
-				detect_db[i] = detector.processAudioSample(inputFrame[i]);
-
-				if (detect_db[i] > parameters.threshold_db)
-				{
-					output_db[i] = parameters.threshold_db + 
-									(detect_db[i] - parameters.threshold_db) / parameters.envAmount;
-
-					gainReduction[i] = output_db[i] - detect_db[i];
-					detectorReduction[i] = pow(10, (gainReduction[i]) / 20);
-				}
-			}
-				
-		}
-
-		// ** LFO **
-		double lfoModifier = 1.0;
-
-		if (parameters.enableLFO)
-		{
-			SignalModulatorOutput lfoOutput = modLFO.renderModulatorOutput();
-
-			double uniModulator = bipolarToUnipolar(lfoOutput.normalOutput);
-			lfoModifier = doUnipolarModulationFromMax(uniModulator, 0.0, 1.0);
-		}
-
-
-		// ** SIDECHAIN **
-		double sidechainModulator[2] = { 1.0, 1.0 };
-
-		if (parameters.enableSidechain)
-		{
-			double detect_db[2];
-			double output_db[2];
-			double gainReduction[2];
-
-			for (int i = 0; i < 2; i++)
-			{
-				detect_db[i] = detector.processAudioSample(inputFrame[i]);
-
-				if (detect_db[i] > parameters.sidechainThresh_db)
-				{
-					output_db[i] = parameters.sidechainThresh_db +
-						(detect_db[i] - parameters.sidechainThresh_db) / parameters.envAmount;
-
-					gainReduction[i] = output_db[i] - detect_db[i];
-					detectorReduction[i] = pow(10, (gainReduction[i]) / 20);
-				}
-			}
-		}
-
-		// ** OUTPUT **
-		for (int i = 0; i < 4; i++)
-		{
-			ynL[i] = delayBuffer[0].readBuffer(delayInSamples[i]);
-			ynR[i] = delayBuffer[1].readBuffer(delayInSamples[i]);
-		}
-
-		// --- create input for delay buffer
-		double dn[2];
+		double outputL = 0.0;
+		double outputR = 0.0;
+		delayTimesLive = true;
 
-		for (int i = 0; i < 2; i++)
-			dn[i] = inputFrame[i];
-
-
-		// --- mode
-		dn[0] += feedback_cooked * ynL[0];
-		dn[1] += feedback_cooked * ynR[0];
-
-		// --- write to delay buffer
-		for (int i = 0; i < 2; i++)
-			delayBuffer[i].writeBuffer(dn[i]);
-
-
-
-		// ** LEFT **
-		// --- pan modifier
-		double panModifier[4];
-
-		for (int i = 0; i < 4; i++)
-			panModifier[i] = cos((panCenter[i] + 1.0) * (kPi / 4.0));
-
-		// --- incorporate panning
-		for (int i = 0; i < 4; i++)
-			ynL[i] *= panModifier[i];
-
-
-		// ** RIGHT **
-		// --- pan modifier
-		for (int i = 0; i < 4; i++)
-			panModifier[i] = sin((panCenter[i] + 1.0) * (kPi / 4.0));
-
-		// --- incorporate panning
-		for (int i = 0; i < 4; i++)
-		{
-			ynR[i] *= panModifier[i];
-		}
-			
-
-
-
-		// --- form mixture out = dry*xn + wet*yn
-		for (int i = 0; i < 4; i++)
-		{
-			ynL[i] *= lfoModifier * detectorReduction[0] * wetMix[i] * sidechainModulator[0];
-			ynR[i] *= lfoModifier * detectorReduction[1] * wetMix[i] * sidechainModulator[1];
-		}
+		processStereoFrame(inputFrame[0], inputFrame[1], outputL, outputR);
 
-		double outputL = inputFrame[0] * dryMix;
-		double outputR = inputFrame[1] * dryMix;
-		
-		for (int i = 0; i < 4; i++)
-		{
-			outputL += ynL[i];
-			outputR += ynR[i];
-		}
-			
-		
 		if (inputChannels == 1 && outputChannels == 1)
 		{
 			outputFrame[0] = outputL;
@@ -340,6 +311,33 @@ public:
 			outputFrame[1] = outputR;
 			return true;
 		}
+
+		return false;
+	}
+
+	/** process a block of non-interleaved audio; sample-identical to calling processAudioFrame( ) once per frame */
+	/**
+	\param inputs input buffers, inputs[channel][frame]
+	\param outputs output buffers, outputs[channel][frame]; may alias inputs
+	\param numFrames number of frames in each buffer
+	\param numChannels 1 = mono (right input is silent), 2 = stereo
+	\return true if processed
+	*/
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		// --- channel decode is hoisted out of the per-sample loop
+		if (numChannels == 1)
+			processStereoBlock(inputs[0], nullptr, outputs[0], nullptr, numFrames);
+		else if (numChannels == 2)
+			processStereoBlock(inputs[0], inputs[1], outputs[0], outputs[1], numFrames);
+		else
+			return false;
+
+		auxInputBlock = nullptr;
+		return true;
 	}
 
 	/** creation function */
@@ -358,6 +356,24 @@ public:
 		delayBuffer[1].createCircularBuffer(bufferLength);
 	}
 
+	/** allocate the tape once for the highest sample rate; later resets at any rate up to it only flush
+	    the part in use; also sets the tape length used by reset( ) */
+	void reserveDelayBuffers(double _maxSampleRate, double _bufferLength_mSec)
+	{
+		bufferLength_mSec = _bufferLength_mSec;
+		unsigned int maxLength = (unsigned int)(_bufferLength_mSec*(_maxSampleRate / 1000.0)) + 1;
+
+		delayBuffer[0].reserveCircularBuffer(maxLength);
+		delayBuffer[1].reserveCircularBuffer(maxLength);
+	}
+
+	/** DelayMemoryArena bytes used by createDelayBuffers( ) with these arguments; for DelayMemoryArena::reserve( ) */
+	static size_t getDelayMemoryBytes(double _sampleRate, double _bufferLength_mSec)
+	{
+		unsigned int length = (unsigned int)(_bufferLength_mSec*(_sampleRate / 1000.0)) + 1;
+		return 2 * DelayLine<StorageType>::getAllocationBytes(length);
+	}
+
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
@@ -381,7 +397,7 @@ public:
 
 		// --- delay parameters
 
-		if (true || parameters.delay_ms != params.delay_ms
+		if (parameters.delay_ms != params.delay_ms
 			|| parameters.enableBPM != params.enableBPM
 			|| parameters.delay_bpm != params.delay_bpm)
 		{
@@ -389,31 +405,7 @@ public:
 			parameters.enableBPM = params.enableBPM;
 			parameters.delay_bpm = params.delay_bpm;
 
-			if (!parameters.enableBPM)
-				delayInSamples[0] = parameters.delay_ms * samplesPerMSec;
-			else
-			{
-				double sPB = 60 / (bpm);
-				double bpmDelay = sPB * sampleRate;
-
-				if (parameters.delay_bpm == rateBPM::kHalf)
-					delayInSamples[0] = 2 * bpmDelay;
-				else if (parameters.delay_bpm == rateBPM::kQuarter)
-					delayInSamples[0] = bpmDelay;
-				else if (parameters.delay_bpm == rateBPM::kQuarter_Triplet)
-					delayInSamples[0] = 3 / 2 * bpmDelay;
-				else if (parameters.delay_bpm == rateBPM::kEighth)
-					delayInSamples[0] = bpmDelay / 2;
-				else if (parameters.delay_bpm == rateBPM::kEighth_Triplet)
-					delayInSamples[0] = bpmDelay * 3 / 4;
-				else if (parameters.delay_bpm == rateBPM::kSixteenth)
-					delayInSamples[0] = bpmDelay / 4;
-			}
-
-			delayInSamples[1] = delayInSamples[0] / 2;
-			delayInSamples[2] = delayInSamples[0] * 3;
-			delayInSamples[3] = delayInSamples[0] * 2;
-			
+			cookDelayTimes();
 		}
 
 		// --- dry signal
@@ -423,72 +415,15 @@ public:
 			dryMix = pow(10, parameters.dryVolume / 20);
 		}
 
-		/*if (parameters.wetVolume != params.wetVolume ||
-			parameters.mode != params.mode)
-		{
-			parameters.wetVolume = params.wetVolume;
-			for (int i = 0; i < 4; i++)
-				wetMix[i] = pow(10, parameters.wetVolume / 20);
-		}*/
-
 		// ** MODE **
 		if (parameters.mode != params.mode ||
 			parameters.wetVolume != params.wetVolume)
 		{
 			parameters.wetVolume = params.wetVolume;
-			for (int i = 0; i < 4; i++)
-				wetMix[i] = pow(10, parameters.wetVolume / 20);
-
 			parameters.mode = params.mode;
 
-			if (parameters.mode == 1)
-			{
-				for (int i = 1; i < 4; i++)
-					wetMix[i] = 0.0;
-			}
-			else if (parameters.mode == 2)
-			{
-				wetMix[0] *= 0.5;
-				wetMix[1] *= 0.5;
-				wetMix[2] = 0.0;
-				wetMix[3] = 0.0;
-				panCenter[1] = 1.0;
-			}
-			else if (parameters.mode == 3)
-			{ 
-				wetMix[0] *= 0.5;
-				wetMix[1] = 0.0;
-				wetMix[2] *= 0.5;
-				wetMix[3] = 0.0;
-				panCenter[2] = -1.0;
-			}
-			else if (parameters.mode == 4)
-			{
-				wetMix[0] *= 0.5;
-				wetMix[1] = 0.0;
-				wetMix[2] = 0.0;
-				wetMix[3] *= 0.5;
-				panCenter[3] = 0.7;
-			}
-			else if (parameters.mode == 5)
-			{
-				wetMix[0] *= 0.33;
-				wetMix[1] = 0.0;
-				wetMix[2] *= 0.33;
-				wetMix[3] *= 0.33;
-				panCenter[2] = 1.0;
-				panCenter[3] = -1.0;
-			}
-			else if (parameters.mode == 6)
-			{
-				wetMix[0] *= 0.25;
-				wetMix[1] *= 0.25;
-				wetMix[2] *= 0.25;
-				wetMix[3] *= 0.25;
-				panCenter[1] = 1;
-				panCenter[2] = 0.5;
-				panCenter[3] = -1.0;
-			}
+			// --- crossfade to the new matrix to avoid clicks
+			compileTapMatrix(true);
 		}
 
 		if (parameters.sidechainThresh_db != params.sidechainThresh_db)
@@ -511,15 +446,370 @@ public:
 		}
 
 		// ** LFO **
-		SuperLFOParameters lfoParams = modLFO.getParameters();
-		lfoParams.frequency_Hz = params.lfoRate_hz;
-		lfoParams.outputAmplitude = (params.lfoAmount / 10);
-		modLFO.setParameters(lfoParams);
+		if (parameters.lfoRate_hz != params.lfoRate_hz ||
+			parameters.lfoAmount != params.lfoAmount)
+		{
+			SuperLFOParameters lfoParams = modLFO.getSource().getParameters();
+			lfoParams.frequency_Hz = params.lfoRate_hz;
+			lfoParams.outputAmplitude = (params.lfoAmount / 10);
+			modLFO.getSource().setParameters(lfoParams);
+		}
+
+		// ** TAPE HEADS **
+		if (parameters.interpolation != params.interpolation)
+		{
+			delayBuffer[0].setInterpolation(params.interpolation);
+			delayBuffer[1].setInterpolation(params.interpolation);
+		}
 
 		parameters = params;
 	}
 
 private:
+	/** the delay of every note value at the current tempo and sample rate */
+	void cookRateTable()
+	{
+		double samplesPerBeat = bpm > 0.0 ? 60.0 * sampleRate / bpm : 0.0;
+
+		for (unsigned int i = 0; i < RE201_NUM_RATES; i++)
+			rateDelayInSamples[i] = re201RateBeats[i] * samplesPerBeat;
+	}
+
+	/** convert the delay time (or note value) into the four head delays; once audio is running the heads
+	    glide to the new positions over kDelayTimeRamp_mSec, like a change of tape speed */
+	void cookDelayTimes()
+	{
+		double delay = parameters.delay_ms * samplesPerMSec;
+
+		// --- synced, once the host has given us a tempo
+		unsigned int rate = (unsigned int)parameters.delay_bpm;
+		if (parameters.enableBPM && bpm > 0.0 && rate < RE201_NUM_RATES)
+			delay = rateDelayInSamples[rate];
+
+		double target[RE201_NUM_HEADS] = { delay, delay / 2, delay * 3, delay * 2 };
+
+		// --- slow tempos can put the far heads past the end of the tape
+		double maxDelay = bufferLength > 1 ? (double)(bufferLength - 1) : 0.0;
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+			target[i] = fmin(target[i], maxDelay);
+
+		unsigned int rampLength = (unsigned int)(kDelayTimeRamp_mSec * samplesPerMSec);
+
+		if (!delayTimesLive || rampLength == 0)
+		{
+			memcpy(&delayInSamples[0], &target[0], sizeof(delayInSamples));
+			delayRampCount = 0;
+			return;
+		}
+
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+		{
+			delayTarget[i] = target[i];
+			delayInc[i] = (target[i] - delayInSamples[i]) / rampLength;
+		}
+
+		delayRampCount = rampLength;
+	}
+
+	/** advance the head glide by one sample */
+	inline void advanceDelayRamp()
+	{
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+			delayInSamples[i] += delayInc[i];
+
+		// --- land exactly on the target
+		if (--delayRampCount == 0)
+			memcpy(&delayInSamples[0], &delayTarget[0], sizeof(delayInSamples));
+	}
+
+	/** the longest run of frames whose head reads can all be done ahead of the writes */
+	inline uint32_t getMaxHeadRun()
+	{
+		double shortestHead = delayInSamples[0];
+		for (unsigned int i = 1; i < RE201_NUM_HEADS; i++)
+			shortestHead = fmin(shortestHead, delayInSamples[i]);
+
+		// --- the interpolator's newer points must not reach the run
+		shortestHead -= getInterpolatorNewerTaps(parameters.interpolation);
+
+		uint32_t maxRun = kTapBlockSize;
+		if (!(shortestHead + 1.0 >= (double)maxRun))
+			maxRun = shortestHead >= 1.0 ? (uint32_t)shortestHead + 1 : 1;
+
+		return maxRun;
+	}
+
+	/** pick up one frame of the sidechain block; a mono sidechain leaves the right channel silent */
+	inline void readAuxInputFrame(uint32_t frame)
+	{
+		sidechainInputSample[0] = auxInputBlock[0][frame];
+		sidechainInputSample[1] = numAuxInputChannels > 1 ? auxInputBlock[1][frame] : 0.0;
+	}
+
+	/** the core echo algorithm for one stereo frame; shared by the frame and block processing functions */
+	inline void processStereoFrame(double xnL, double xnR, double& outputL, double& outputR)
+	{
+		// --- ducking: gains at control rate, detectors every sample
+		if (duckingCounter == 0)
+			updateDuckingGains();
+
+		if (parameters.enableEnv)
+			envelopeDetector.detectStereoLinkedSample(xnL, xnR);
+		if (parameters.enableSidechain)
+			sidechainDetector.detectStereoLinkedSample(sidechainInputSample[0], sidechainInputSample[1]);
+
+		duckingCounter--;
+
+		// --- read all four heads at once
+		double ynL[RE201_NUM_HEADS];
+		double ynR[RE201_NUM_HEADS];
+
+		delayBuffer[0].readBuffer(&delayInSamples[0], &ynL[0], RE201_NUM_HEADS);
+		delayBuffer[1].readBuffer(&delayInSamples[0], &ynR[0], RE201_NUM_HEADS);
+
+		if (delayRampCount > 0)
+			advanceDelayRamp();
+
+		mixStereoFrame(xnL, xnR, ynL, ynR, outputL, outputR);
+	}
+
+	/** run a block; the heads are read ahead in runs that end before any head reaches a sample written in the run.
+	    inR and outR are null for mono, where the right input is silent */
+	void processStereoBlock(const float* inL, const float* inR, float* outL, float* outR, uint32_t numFrames)
+	{
+		double outputL = 0.0;
+		double outputR = 0.0;
+		delayTimesLive = true;
+
+		// --- the shortest head sets the longest run that can be read ahead
+		uint32_t maxRun = getMaxHeadRun();
+
+		double* headsL[RE201_NUM_HEADS];
+		double* headsR[RE201_NUM_HEADS];
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+		{
+			headsL[i] = &tapBlock[0][i][0];
+			headsR[i] = &tapBlock[1][i][0];
+		}
+
+		uint32_t frame = 0;
+		while (frame < numFrames)
+		{
+			// --- gliding heads move every frame, so they cannot be read ahead; re-measure once they land
+			if (delayRampCount > 0)
+			{
+				if (auxInputBlock)
+					readAuxInputFrame(frame);
+
+				processStereoFrame(inL[frame], inR ? inR[frame] : 0.0, outputL, outputR);
+				outL[frame] = outputL;
+				if (outR) outR[frame] = outputR;
+				frame++;
+
+				if (delayRampCount == 0)
+					maxRun = getMaxHeadRun();
+				continue;
+			}
+
+			uint32_t runLength = numFrames - frame < maxRun ? numFrames - frame : maxRun;
+
+			// --- runs also end at the ducking control points
+			uint32_t framesToUpdate = duckingCounter == 0 ? kDuckingControlPeriod : duckingCounter;
+			runLength = runLength < framesToUpdate ? runLength : framesToUpdate;
+
+			// --- too short to be worth it, or not possible: one frame at a time
+			if (runLength < 2 ||
+				!delayBuffer[0].readBuffer(&delayInSamples[0], &headsL[0], RE201_NUM_HEADS, runLength) ||
+				!delayBuffer[1].readBuffer(&delayInSamples[0], &headsR[0], RE201_NUM_HEADS, runLength))
+			{
+				if (auxInputBlock)
+					readAuxInputFrame(frame);
+
+				processStereoFrame(inL[frame], inR ? inR[frame] : 0.0, outputL, outputR);
+				outL[frame] = outputL;
+				if (outR) outR[frame] = outputR;
+				frame++;
+				continue;
+			}
+
+			// --- ducking: the gains for this run were set at its start, so the detectors can run the whole run now
+			if (duckingCounter == 0)
+				updateDuckingGains();
+
+			if (parameters.enableEnv)
+				envelopeDetector.detectStereoLinkedBlock(&inL[frame], inR ? &inR[frame] : nullptr, runLength);
+
+			if (parameters.enableSidechain)
+			{
+				if (auxInputBlock)
+					sidechainDetector.detectStereoLinkedBlock(&auxInputBlock[0][frame], numAuxInputChannels > 1 ? &auxInputBlock[1][frame] : nullptr, runLength);
+				else
+				{
+					for (uint32_t i = 0; i < runLength; i++)
+						sidechainDetector.detectStereoLinkedSample(sidechainInputSample[0], sidechainInputSample[1]);
+				}
+			}
+
+			duckingCounter -= runLength;
+
+			// --- keep the last sidechain frame for any single frames that follow
+			if (auxInputBlock)
+				readAuxInputFrame(frame + runLength - 1);
+
+			for (uint32_t i = 0; i < runLength; i++, frame++)
+			{
+				double ynL[RE201_NUM_HEADS];
+				double ynR[RE201_NUM_HEADS];
+
+				for (unsigned int head = 0; head < RE201_NUM_HEADS; head++)
+				{
+					ynL[head] = tapBlock[0][head][i];
+					ynR[head] = tapBlock[1][head][i];
+				}
+
+				mixStereoFrame(inL[frame], inR ? inR[frame] : 0.0, ynL, ynR, outputL, outputR);
+				outL[frame] = outputL;
+				if (outR) outR[frame] = outputR;
+			}
+		}
+	}
+
+	/** set the ducking gain targets from the detectors and ramp to them over the next control period */
+	void updateDuckingGains()
+	{
+		// --- land exactly on the last targets
+		envelopeGain = envelopeGainTarget;
+		sidechainGain = sidechainGainTarget;
+
+		envelopeGainTarget = 1.0;
+		sidechainGainTarget = 1.0;
+
+		// ** DETECTOR **
+		if (parameters.enableEnv)
+			envelopeGainTarget = getDuckingGain(envelopeDetector.getDetectedValue(), parameters.threshold_db, parameters.envAmount);
+
+		// ** SIDECHAIN ** the aux bus, with its own threshold and amount
+		if (parameters.enableSidechain)
+			sidechainGainTarget = getDuckingGain(sidechainDetector.getDetectedValue(), parameters.sidechainThresh_db,
+												 parameters.sidechainAmount >= 1.0 ? parameters.sidechainAmount : 1.0);
+
+		envelopeGainInc = (envelopeGainTarget - envelopeGain) / kDuckingControlPeriod;
+		sidechainGainInc = (sidechainGainTarget - sidechainGain) / kDuckingControlPeriod;
+
+		duckingCounter = kDuckingControlPeriod;
+	}
+
+	/** downward compression of the echoes above threshold; amount is the ratio */
+	inline double getDuckingGain(double detect_db, double threshold_db, double amount)
+	{
+		if (detect_db <= threshold_db)
+			return 1.0;
+
+		double output_db = threshold_db + (detect_db - threshold_db) / amount;
+		return fastdB2Raw(output_db - detect_db);
+	}
+
+	/** everything after the head read for one frame: modulation, feedback write and the output mix */
+	inline void mixStereoFrame(double xnL, double xnR, const double* ynL, const double* ynR, double& outputL, double& outputR)
+	{
+		double inputFrame[2] = { xnL, xnR };
+
+		// ** LFO **
+		double lfoModifier = 1.0;
+
+		if (parameters.enableLFO)
+		{
+			modLFO.advance();
+
+			double uniModulator = bipolarToUnipolar(modLFO.getOutput(kModNormal));
+			lfoModifier = doUnipolarModulationFromMax(uniModulator, 0.0, 1.0);
+		}
+
+		// --- ducking ramps
+		envelopeGain += envelopeGainInc;
+		sidechainGain += sidechainGainInc;
+		double wetModulator = lfoModifier * envelopeGain * sidechainGain;
+
+		// --- create input for delay buffer
+		double dn[2];
+
+		for (int i = 0; i < 2; i++)
+			dn[i] = inputFrame[i];
+
+
+		// --- mode
+		dn[0] += feedback_cooked * ynL[0];
+		dn[1] += feedback_cooked * ynR[0];
+
+		// --- write to delay buffer
+		for (int i = 0; i < 2; i++)
+			delayBuffer[i].writeBuffer(dn[i]);
+
+
+
+		// --- advance the mode crossfade
+		if (tapMatrixRampCount > 0)
+		{
+			for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+			{
+				tapMatrix[0][i] += tapMatrixInc[0][i];
+				tapMatrix[1][i] += tapMatrixInc[1][i];
+			}
+
+			// --- land exactly on the target
+			if (--tapMatrixRampCount == 0)
+				memcpy(&tapMatrix[0][0], &tapMatrixTarget[0][0], sizeof(tapMatrix));
+		}
+
+		// --- tap matrix: pan and head gain are pre-cooked, modulation is common to all heads
+		double wetL = 0.0;
+		double wetR = 0.0;
+
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+		{
+			wetL += tapMatrix[0][i] * ynL[i];
+			wetR += tapMatrix[1][i] * ynR[i];
+		}
+
+		// --- form mixture out = dry*xn + wet*yn
+		outputL = inputFrame[0] * dryMix + wetModulator * wetL;
+		outputR = inputFrame[1] * dryMix + wetModulator * wetR;
+	}
+
+	/** compile the current mode and echo volume into the tap-to-output gain matrix; optionally crossfade to it */
+	void compileTapMatrix(bool crossfade)
+	{
+		unsigned int mode = parameters.mode >= 1 && parameters.mode <= (int)RE201_NUM_MODES ? parameters.mode : 0;
+		const RE201HeadMix& headMix = re201HeadMixTable[mode];
+
+		double wetMix = pow(10, parameters.wetVolume / 20);
+
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+		{
+			double panAngle = (headMix.headPan[i] + 1.0) * (kPi / 4.0);
+			tapMatrixTarget[0][i] = wetMix * headMix.headGain[i] * cos(panAngle);
+			tapMatrixTarget[1][i] = wetMix * headMix.headGain[i] * sin(panAngle);
+		}
+
+		unsigned int rampLength = (unsigned int)(kTapMatrixRamp_mSec * samplesPerMSec);
+
+		// --- no sample rate yet, or asked to jump
+		if (!crossfade || rampLength == 0)
+		{
+			memcpy(&tapMatrix[0][0], &tapMatrixTarget[0][0], sizeof(tapMatrix));
+			tapMatrixRampCount = 0;
+			return;
+		}
+
+		for (unsigned int i = 0; i < RE201_NUM_HEADS; i++)
+		{
+			tapMatrixInc[0][i] = (tapMatrixTarget[0][i] - tapMatrix[0][i]) / rampLength;
+			tapMatrixInc[1][i] = (tapMatrixTarget[1][i] - tapMatrix[1][i]) / rampLength;
+		}
+
+		tapMatrixRampCount = rampLength;
+	}
+
 	RE201Parameters parameters; ///< object parameters
 
 	// --- local variables used by this object
@@ -532,34 +822,60 @@ private:
 
 	// --- wet dry mix
 	double dryMix = 0.707;
-	double wetMix[4] = { 0.707 };
+
+	// --- tap-to-output gain matrix [channel][head]: echo volume, head gain and pan
+	double tapMatrix[2][RE201_NUM_HEADS] = { { 0.0 } };		///< current matrix
+	double tapMatrixTarget[2][RE201_NUM_HEADS] = { { 0.0 } };	///< matrix for the current mode
+	double tapMatrixInc[2][RE201_NUM_HEADS] = { { 0.0 } };		///< per-sample crossfade increment
+	unsigned int tapMatrixRampCount = 0;						///< crossfade samples remaining
 
 	// --- tap
-	double delayInSamples[4];;	///< double includes fractional part
+	double delayInSamples[RE201_NUM_HEADS] = { 0.0 };	///< double includes fractional part
+	double delayTarget[RE201_NUM_HEADS] = { 0.0 };		///< head delays at the end of the glide
+	double delayInc[RE201_NUM_HEADS] = { 0.0 };			///< per-sample glide increment
+	unsigned int delayRampCount = 0;					///< glide samples remaining
+	bool delayTimesLive = false;						///< audio has run since reset( ); delay changes glide
 	double feedback_cooked = 0.0;
 
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer[2];	///< delay buffer of doubles
+	// --- delay buffers (the tape)
+	DelayLine<StorageType> delayBuffer[2];	///< delay buffers
+
+	// --- block head reads [channel][head][frame]
+	double tapBlock[2][RE201_NUM_HEADS][kTapBlockSize] = { { { 0.0 } } };
 
 	// --- bpm
-	double bpm = 0.0;
+	double bpm = 0.0;										///< host tempo, 0 until known
+	double rateDelayInSamples[RE201_NUM_RATES] = { 0.0 };	///< delay of each rateBPM at this tempo and sample rate
 
 	// ** MODULATION **
-	// --- detector
-	AudioDetector detector;
+	// --- detectors
+	AudioDetector envelopeDetector;		///< stereo-linked detector on the input
+	AudioDetector sidechainDetector;	///< stereo-linked detector on the sidechain
 	double threshold_cooked = 0.0;
 
+	// --- ducking gains: targets every kDuckingControlPeriod samples, ramped in between
+	double envelopeGain = 1.0;			///< current input ducking gain
+	double envelopeGainTarget = 1.0;	///< input ducking gain at the end of the period
+	double envelopeGainInc = 0.0;		///< per-sample ramp
+	double sidechainGain = 1.0;			///< current sidechain ducking gain
+	double sidechainGainTarget = 1.0;	///< sidechain ducking gain at the end of the period
+	double sidechainGainInc = 0.0;		///< per-sample ramp
+	unsigned int duckingCounter = 0;	///< samples until the next gain update
+
 	// --- sidechain
-	double sidechainInputSample[2];
+	double sidechainInputSample[2] = { 0.0, 0.0 };
 	double sidechainThresh_cooked;
+	const float* const* auxInputBlock = nullptr;	///< sidechain buffers for the next processAudioBlock( ) call
+	uint32_t numAuxInputChannels = 0;				///< sidechain channel count
 	
 	// --- lfo
-	SuperLFO modLFO;
-
-	// --- pan
-	double panCenter[4] = { 0.0 };
+	ControlRateModulator<SuperLFO> modLFO;	///< wet level LFO, evaluated at control rate
 
 
 };
 
+typedef RE201T<double> RE201;			///< double storage
+typedef RE201T<float> RE201Float;		///< float storage, double arithmetic
+typedef RE201T<float, ExactCircularBuffer> RE201FloatExact;	///< float storage, exact-length tape
+
 #endif
\ No newline at end of file
@@ -17,8 +17,24 @@
 // -----------------------------------------------------------------------------
 #include <memory>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iterator>
+#include <new>
 #include "fxobjects.h"
 
+// --- OS memory for the DelayMemoryArena
+#if defined _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 
 /**
 \brief process one sample through the biquad
@@ -143,6 +159,13 @@ bool AudioFilter::calculateFilterCoeffs()
 	double Q = audioFilterParameters.Q;
 	double boostCut_dB = audioFilterParameters.boostCut_dB;
 
+	// --- the bilinear designs that only depend on fc through tan(pi*fc/fs); shared with setFcFast( )
+	if (hasPrewarpedCoeffs())
+	{
+		boostCutGain = pow(10.0, boostCut_dB / 20.0);
+		return calculatePrewarpedCoeffs(tan(kPi*fc / sampleRate));
+	}
+
 	// --- decode filter type and calculate accordingly
 	// --- impulse invariabt LPF, matches closely with one-pole version,
 	//     but diverges at VHF
@@ -490,82 +513,6 @@ bool AudioFilter::calculateFilterCoeffs()
 		// --- we updated
 		return true;
 	}
-	else if (algorithm == filterAlgorithm::kBPF2)
-	{
-		// --- see book for formulae
-		double K = tan(kPi*fc / sampleRate);
-		double delta = K*K*Q + K + Q;
-
-		// --- update coeffs
-		coeffArray[a0] = K / delta;;
-		coeffArray[a1] = 0.0;
-		coeffArray[a2] = -K / delta;
-		coeffArray[b1] = 2.0*Q*(K*K - 1) / delta;
-		coeffArray[b2] = (K*K*Q - K + Q) / delta;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kBSF2)
-	{
-		// --- see book for formulae
-		double K = tan(kPi*fc / sampleRate);
-		double delta = K*K*Q + K + Q;
-
-		// --- update coeffs
-		coeffArray[a0] = Q*(1 + K*K) / delta;
-		coeffArray[a1] = 2.0*Q*(K*K - 1) / delta;
-		coeffArray[a2] = Q*(1 + K*K) / delta;
-		coeffArray[b1] = 2.0*Q*(K*K - 1) / delta;
-		coeffArray[b2] = (K*K*Q - K + Q) / delta;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kButterLPF2)
-	{
-		// --- see book for formulae
-		double theta_c = kPi*fc / sampleRate;
-		double C = 1.0 / tan(theta_c);
-
-		// --- update coeffs
-		coeffArray[a0] = 1.0 / (1.0 + kSqrtTwo*C + C*C);
-		coeffArray[a1] = 2.0*coeffArray[a0];
-		coeffArray[a2] = coeffArray[a0];
-		coeffArray[b1] = 2.0*coeffArray[a0] * (1.0 - C*C);
-		coeffArray[b2] = coeffArray[a0] * (1.0 - kSqrtTwo*C + C*C);
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kButterHPF2)
-	{
-		// --- see book for formulae
-		double theta_c = kPi*fc / sampleRate;
-		double C = tan(theta_c);
-
-		// --- update coeffs
-		coeffArray[a0] = 1.0 / (1.0 + kSqrtTwo*C + C*C);
-		coeffArray[a1] = -2.0*coeffArray[a0];
-		coeffArray[a2] = coeffArray[a0];
-		coeffArray[b1] = 2.0*coeffArray[a0] * (C*C - 1.0);
-		coeffArray[b2] = coeffArray[a0] * (1.0 - kSqrtTwo*C + C*C);
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
 	else if (algorithm == filterAlgorithm::kButterBPF2)
 	{
 		// --- see book for formulae
@@ -651,84 +598,6 @@ bool AudioFilter::calculateFilterCoeffs()
 		// --- we updated
 		return true;
 	}
-	else if (algorithm == filterAlgorithm::kLowShelf)
-	{
-		// --- see book for formulae
-		double theta_c = 2.0*kPi*fc / sampleRate;
-		double mu = pow(10.0, boostCut_dB / 20.0);
-
-		double beta = 4.0 / (1.0 + mu);
-		double delta = beta*tan(theta_c / 2.0);
-		double gamma = (1.0 - delta) / (1.0 + delta);
-
-		// --- update coeffs
-		coeffArray[a0] = (1.0 - gamma) / 2.0;
-		coeffArray[a1] = (1.0 - gamma) / 2.0;
-		coeffArray[a2] = 0.0;
-		coeffArray[b1] = -gamma;
-		coeffArray[b2] = 0.0;
-
-		coeffArray[c0] = mu - 1.0;
-		coeffArray[d0] = 1.0;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kHiShelf)
-	{
-		double theta_c = 2.0*kPi*fc / sampleRate;
-		double mu = pow(10.0, boostCut_dB / 20.0);
-
-		double beta = (1.0 + mu) / 4.0;
-		double delta = beta*tan(theta_c / 2.0);
-		double gamma = (1.0 - delta) / (1.0 + delta);
-
-		coeffArray[a0] = (1.0 + gamma) / 2.0;
-		coeffArray[a1] = -coeffArray[a0];
-		coeffArray[a2] = 0.0;
-		coeffArray[b1] = -gamma;
-		coeffArray[b2] = 0.0;
-
-		coeffArray[c0] = mu - 1.0;
-		coeffArray[d0] = 1.0;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kCQParaEQ)
-	{
-		// --- see book for formulae
-		double K = tan(kPi*fc / sampleRate);
-		double Vo = pow(10.0, boostCut_dB / 20.0);
-		bool bBoost = boostCut_dB >= 0 ? true : false;
-
-		double d0 = 1.0 + (1.0 / Q)*K + K*K;
-		double e0 = 1.0 + (1.0 / (Vo*Q))*K + K*K;
-		double alpha = 1.0 + (Vo / Q)*K + K*K;
-		double beta = 2.0*(K*K - 1.0);
-		double gamma = 1.0 - (Vo / Q)*K + K*K;
-		double delta = 1.0 - (1.0 / Q)*K + K*K;
-		double eta = 1.0 - (1.0 / (Vo*Q))*K + K*K;
-
-		// --- update coeffs
-		coeffArray[a0] = bBoost ? alpha / d0 : d0 / e0;
-		coeffArray[a1] = bBoost ? beta / d0 : beta / e0;
-		coeffArray[a2] = bBoost ? gamma / d0 : delta / e0;
-		coeffArray[b1] = bBoost ? beta / d0 : beta / e0;
-		coeffArray[b2] = bBoost ? delta / d0 : eta / e0;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
 	else if (algorithm == filterAlgorithm::kNCQParaEQ)
 	{
 		// --- see book for formulae
@@ -764,74 +633,6 @@ bool AudioFilter::calculateFilterCoeffs()
 		// --- we updated
 		return true;
 	}
-	else if (algorithm == filterAlgorithm::kLWRLPF2)
-	{
-		// --- see book for formulae
-		double omega_c = kPi*fc;
-		double theta_c = kPi*fc / sampleRate;
-
-		double k = omega_c / tan(theta_c);
-		double denominator = k*k + omega_c*omega_c + 2.0*k*omega_c;
-		double b1_Num = -2.0*k*k + 2.0*omega_c*omega_c;
-		double b2_Num = -2.0*k*omega_c + k*k + omega_c*omega_c;
-
-		// --- update coeffs
-		coeffArray[a0] = omega_c*omega_c / denominator;
-		coeffArray[a1] = 2.0*omega_c*omega_c / denominator;
-		coeffArray[a2] = coeffArray[a0];
-		coeffArray[b1] = b1_Num / denominator;
-		coeffArray[b2] = b2_Num / denominator;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kLWRHPF2)
-	{
-		// --- see book for formulae
-		double omega_c = kPi*fc;
-		double theta_c = kPi*fc / sampleRate;
-
-		double k = omega_c / tan(theta_c);
-		double denominator = k*k + omega_c*omega_c + 2.0*k*omega_c;
-		double b1_Num = -2.0*k*k + 2.0*omega_c*omega_c;
-		double b2_Num = -2.0*k*omega_c + k*k + omega_c*omega_c;
-
-		// --- update coeffs
-		coeffArray[a0] = k*k / denominator;
-		coeffArray[a1] = -2.0*k*k / denominator;
-		coeffArray[a2] = coeffArray[a0];
-		coeffArray[b1] = b1_Num / denominator;
-		coeffArray[b2] = b2_Num / denominator;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
-	else if (algorithm == filterAlgorithm::kAPF1)
-	{
-		// --- see book for formulae
-		double alphaNumerator = tan((kPi*fc) / sampleRate) - 1.0;
-		double alphaDenominator = tan((kPi*fc) / sampleRate) + 1.0;
-		double alpha = alphaNumerator / alphaDenominator;
-
-		// --- update coeffs
-		coeffArray[a0] = alpha;
-		coeffArray[a1] = 1.0;
-		coeffArray[a2] = 0.0;
-		coeffArray[b1] = alpha;
-		coeffArray[b2] = 0.0;
-
-		// --- update on calculator
-		biquad.setCoefficients(coeffArray);
-
-		// --- we updated
-		return true;
-	}
 	else if (algorithm == filterAlgorithm::kAPF2)
 	{
 		// --- see book for formulae
@@ -908,38 +709,232 @@ bool AudioFilter::calculateFilterCoeffs()
 }
 
 /**
-\brief process one sample through the audio filter
+\brief calculates the coefficients of the bilinear designs whose only dependence on fc is the prewarped tangent K = tan(pi*fc/fs)
 
 - NOTES:\n
-Uses the modified biquaqd structure that includes the wet and dry signal coefficients c and d.\n
-Here the biquad object does all of the work and we simply combine the wet and dry signals.\n
-// return (dry) + (processed): x(n)*d0 + y(n)*c0\n
+shared by calculateFilterCoeffs( ), which passes the exact tan( ), and setFcFast( ), which passes fastTan( );
+the shelf and parametric gains come from boostCutGain, which calculateFilterCoeffs( ) refreshes\n
 
-\param xn the input sample x(n)
-\returns the biquad processed output y(n)
+\param K the prewarped tangent tan(pi*fc/fs)
+\returns true if the algorithm is one of the prewarped designs and the coefficients were updated
 */
-double AudioFilter::processAudioSample(double xn)
+bool AudioFilter::calculatePrewarpedCoeffs(double K)
 {
-	// --- let biquad do the grunt-work
-	//
-	// return (dry) + (processed): x(n)*d0 + y(n)*c0
-	return coeffArray[d0] * xn + coeffArray[c0] * biquad.processAudioSample(xn);
-}
+	filterAlgorithm algorithm = audioFilterParameters.algorithm;
+	double fc = audioFilterParameters.fc;
+	double Q = audioFilterParameters.Q;
+	double boostCut_dB = audioFilterParameters.boostCut_dB;
 
-/**
-\brief sets the new attack time and re-calculates the time constant
+	if (algorithm == filterAlgorithm::kBPF2)
+	{
+		// --- see book for formulae
+		double delta = K*K*Q + K + Q;
 
-\param attack_in_ms the new attack timme
-\param forceCalc flag to force a re-calculation of time constant even if values have not changed.
-*/
-void AudioDetector::setAttackTime(double attack_in_ms, bool forceCalc)
-{
-	if (!forceCalc && audioDetectorParameters.attackTime_mSec == attack_in_ms)
-		return;
+		// --- update coeffs
+		coeffArray[a0] = K / delta;;
+		coeffArray[a1] = 0.0;
+		coeffArray[a2] = -K / delta;
+		coeffArray[b1] = 2.0*Q*(K*K - 1) / delta;
+		coeffArray[b2] = (K*K*Q - K + Q) / delta;
+	}
+	else if (algorithm == filterAlgorithm::kBSF2)
+	{
+		// --- see book for formulae
+		double delta = K*K*Q + K + Q;
 
-	audioDetectorParameters.attackTime_mSec = attack_in_ms;
-	attackTime = exp(TLD_AUDIO_ENVELOPE_ANALOG_TC / (attack_in_ms * sampleRate * 0.001));
-}
+		// --- update coeffs
+		coeffArray[a0] = Q*(1 + K*K) / delta;
+		coeffArray[a1] = 2.0*Q*(K*K - 1) / delta;
+		coeffArray[a2] = Q*(1 + K*K) / delta;
+		coeffArray[b1] = 2.0*Q*(K*K - 1) / delta;
+		coeffArray[b2] = (K*K*Q - K + Q) / delta;
+	}
+	else if (algorithm == filterAlgorithm::kButterLPF2)
+	{
+		// --- see book for formulae
+		double C = 1.0 / K;
+
+		// --- update coeffs
+		coeffArray[a0] = 1.0 / (1.0 + kSqrtTwo*C + C*C);
+		coeffArray[a1] = 2.0*coeffArray[a0];
+		coeffArray[a2] = coeffArray[a0];
+		coeffArray[b1] = 2.0*coeffArray[a0] * (1.0 - C*C);
+		coeffArray[b2] = coeffArray[a0] * (1.0 - kSqrtTwo*C + C*C);
+	}
+	else if (algorithm == filterAlgorithm::kButterHPF2)
+	{
+		// --- see book for formulae
+		double C = K;
+
+		// --- update coeffs
+		coeffArray[a0] = 1.0 / (1.0 + kSqrtTwo*C + C*C);
+		coeffArray[a1] = -2.0*coeffArray[a0];
+		coeffArray[a2] = coeffArray[a0];
+		coeffArray[b1] = 2.0*coeffArray[a0] * (C*C - 1.0);
+		coeffArray[b2] = coeffArray[a0] * (1.0 - kSqrtTwo*C + C*C);
+	}
+	else if (algorithm == filterAlgorithm::kLowShelf)
+	{
+		// --- see book for formulae; K = tan(theta_c/2)
+		double mu = boostCutGain;
+
+		double beta = 4.0 / (1.0 + mu);
+		double delta = beta*K;
+		double gamma = (1.0 - delta) / (1.0 + delta);
+
+		// --- update coeffs
+		coeffArray[a0] = (1.0 - gamma) / 2.0;
+		coeffArray[a1] = (1.0 - gamma) / 2.0;
+		coeffArray[a2] = 0.0;
+		coeffArray[b1] = -gamma;
+		coeffArray[b2] = 0.0;
+
+		coeffArray[c0] = mu - 1.0;
+		coeffArray[d0] = 1.0;
+	}
+	else if (algorithm == filterAlgorithm::kHiShelf)
+	{
+		// --- K = tan(theta_c/2)
+		double mu = boostCutGain;
+
+		double beta = (1.0 + mu) / 4.0;
+		double delta = beta*K;
+		double gamma = (1.0 - delta) / (1.0 + delta);
+
+		coeffArray[a0] = (1.0 + gamma) / 2.0;
+		coeffArray[a1] = -coeffArray[a0];
+		coeffArray[a2] = 0.0;
+		coeffArray[b1] = -gamma;
+		coeffArray[b2] = 0.0;
+
+		coeffArray[c0] = mu - 1.0;
+		coeffArray[d0] = 1.0;
+	}
+	else if (algorithm == filterAlgorithm::kCQParaEQ)
+	{
+		// --- see book for formulae
+		double Vo = boostCutGain;
+		bool bBoost = boostCut_dB >= 0 ? true : false;
+
+		double d0 = 1.0 + (1.0 / Q)*K + K*K;
+		double e0 = 1.0 + (1.0 / (Vo*Q))*K + K*K;
+		double alpha = 1.0 + (Vo / Q)*K + K*K;
+		double beta = 2.0*(K*K - 1.0);
+		double gamma = 1.0 - (Vo / Q)*K + K*K;
+		double delta = 1.0 - (1.0 / Q)*K + K*K;
+		double eta = 1.0 - (1.0 / (Vo*Q))*K + K*K;
+
+		// --- update coeffs
+		coeffArray[a0] = bBoost ? alpha / d0 : d0 / e0;
+		coeffArray[a1] = bBoost ? beta / d0 : beta / e0;
+		coeffArray[a2] = bBoost ? gamma / d0 : delta / e0;
+		coeffArray[b1] = bBoost ? beta / d0 : beta / e0;
+		coeffArray[b2] = bBoost ? delta / d0 : eta / e0;
+	}
+	else if (algorithm == filterAlgorithm::kLWRLPF2 || algorithm == filterAlgorithm::kLWRHPF2)
+	{
+		// --- see book for formulae
+		double omega_c = kPi*fc;
+
+		double k = omega_c / K;
+		double denominator = k*k + omega_c*omega_c + 2.0*k*omega_c;
+		double b1_Num = -2.0*k*k + 2.0*omega_c*omega_c;
+		double b2_Num = -2.0*k*omega_c + k*k + omega_c*omega_c;
+
+		// --- update coeffs
+		if (algorithm == filterAlgorithm::kLWRLPF2)
+		{
+			coeffArray[a0] = omega_c*omega_c / denominator;
+			coeffArray[a1] = 2.0*omega_c*omega_c / denominator;
+		}
+		else
+		{
+			coeffArray[a0] = k*k / denominator;
+			coeffArray[a1] = -2.0*k*k / denominator;
+		}
+		coeffArray[a2] = coeffArray[a0];
+		coeffArray[b1] = b1_Num / denominator;
+		coeffArray[b2] = b2_Num / denominator;
+	}
+	else if (algorithm == filterAlgorithm::kAPF1)
+	{
+		// --- see book for formulae
+		double alphaNumerator = K - 1.0;
+		double alphaDenominator = K + 1.0;
+		double alpha = alphaNumerator / alphaDenominator;
+
+		// --- update coeffs
+		coeffArray[a0] = alpha;
+		coeffArray[a1] = 1.0;
+		coeffArray[a2] = 0.0;
+		coeffArray[b1] = alpha;
+		coeffArray[b2] = 0.0;
+	}
+	else
+		return false;
+
+	// --- update on calculator
+	biquad.setCoefficients(coeffArray);
+
+	// --- we updated
+	return true;
+}
+
+/**
+\brief change only the cutoff/center frequency, for audio-rate modulation
+
+- NOTES:\n
+the prewarped designs (see calculatePrewarpedCoeffs( )) take the tangent from fastTan( ) and skip the
+transcendental calls for everything else (Q and boost/cut terms are kept from the last full calculation);
+the remaining algorithms fall back to a full calculateFilterCoeffs( )\n
+
+\param fc the new cutoff or center frequency (Hz)
+*/
+void AudioFilter::setFcFast(double fc)
+{
+	if (audioFilterParameters.fc == fc)
+		return;
+
+	audioFilterParameters.fc = fc;
+	if (hasPrewarpedCoeffs())
+		calculatePrewarpedCoeffs(fastTan(kPi*fc / sampleRate));
+	else
+		calculateFilterCoeffs();
+}
+
+/**
+\brief process one sample through the audio filter
+
+- NOTES:\n
+Uses the modified biquaqd structure that includes the wet and dry signal coefficients c and d.\n
+Here the biquad object does all of the work and we simply combine the wet and dry signals.\n
+// return (dry) + (processed): x(n)*d0 + y(n)*c0\n
+
+\param xn the input sample x(n)
+\returns the biquad processed output y(n)
+*/
+double AudioFilter::processAudioSample(double xn)
+{
+	// --- let biquad do the grunt-work
+	//
+	// return (dry) + (processed): x(n)*d0 + y(n)*c0
+	return coeffArray[d0] * xn + coeffArray[c0] * biquad.processAudioSample(xn);
+}
+
+/**
+\brief sets the new attack time and re-calculates the time constant
+
+\param attack_in_ms the new attack timme
+\param forceCalc flag to force a re-calculation of time constant even if values have not changed.
+*/
+void AudioDetector::setAttackTime(double attack_in_ms, bool forceCalc)
+{
+	if (!forceCalc && audioDetectorParameters.attackTime_mSec == attack_in_ms)
+		return;
+
+	audioDetectorParameters.attackTime_mSec = attack_in_ms;
+	attackTime = exp(TLD_AUDIO_ENVELOPE_ANALOG_TC / (attack_in_ms * sampleRate * 0.001));
+}
 
 
 /**
@@ -957,6 +952,180 @@ void AudioDetector::setReleaseTime(double release_in_ms, bool forceCalc)
 	releaseTime = exp(TLD_AUDIO_ENVELOPE_ANALOG_TC / (release_in_ms * sampleRate * 0.001));
 }
 
+/**
+\brief the process-wide delay memory arena; allocated once and intentionally never destroyed
+
+\return the arena
+*/
+DelayMemoryArena& DelayMemoryArena::getInstance()
+{
+	static DelayMemoryArena* arena = new DelayMemoryArena;
+	return *arena;
+}
+
+/**
+\brief gets a chunk of memory from the OS, backed by huge pages where the OS allows it, and pre-faults it
+       so that the pages are mapped (and, on NUMA machines, placed) by the calling thread rather than by the audio thread
+
+\param bytes minimum chunk size
+\return true if the chunk was added to the free list
+*/
+bool DelayMemoryArena::addChunk(size_t bytes)
+{
+	bytes = (bytes + kChunkGranularity - 1) & ~(kChunkGranularity - 1);
+	char* chunk = nullptr;
+
+#if defined _WIN32
+	// --- large pages need SeLockMemoryPrivilege; fall back to normal pages without it
+	SIZE_T largePage = GetLargePageMinimum();
+	if (largePage > 0 && bytes % largePage == 0)
+		chunk = (char*)VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	if (!chunk)
+		chunk = (char*)VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	void* memory = MAP_FAILED;
+	#if defined MAP_HUGETLB
+	// --- explicit huge pages only exist if the admin reserved them
+	memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	#endif
+	if (memory == MAP_FAILED)
+	{
+		memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	#if defined MADV_HUGEPAGE
+		// --- transparent huge pages
+		if (memory != MAP_FAILED)
+			madvise(memory, bytes, MADV_HUGEPAGE);
+	#endif
+	}
+	if (memory != MAP_FAILED)
+		chunk = (char*)memory;
+#endif
+
+	if (!chunk)
+		return false;
+
+	// --- pre-fault: first touch happens here, not in the audio thread
+	memset(chunk, 0, bytes);
+
+	poolSize += bytes;
+	addFreeBlock(chunk, bytes);
+	return true;
+}
+
+/**
+\brief adds a free block to the free list, merging it with its neighbours; caller holds the lock
+
+\param block start of the block
+\param bytes size of the block
+*/
+void DelayMemoryArena::addFreeBlock(char* block, size_t bytes)
+{
+	std::map<char*, size_t>::iterator next = freeBlocks.lower_bound(block);
+
+	// --- merge with the following block
+	if (next != freeBlocks.end() && block + bytes == next->first)
+	{
+		bytes += next->second;
+		next = freeBlocks.erase(next);
+	}
+
+	// --- merge with the preceding block
+	if (next != freeBlocks.begin())
+	{
+		std::map<char*, size_t>::iterator previous = std::prev(next);
+		if (previous->first + previous->second == block)
+		{
+			previous->second += bytes;
+			return;
+		}
+	}
+
+	freeBlocks[block] = bytes;
+}
+
+/**
+\brief promises bytes of pool to a caller; grows the pool now, from this (non-realtime) thread, if needed
+
+\param bytes the worst-case need, computed with getBlockSize( )
+*/
+void DelayMemoryArena::reserve(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(arenaMutex);
+	reservedBytes += bytes;
+
+	if (reservedBytes > poolSize)
+		addChunk(reservedBytes - poolSize);
+}
+
+/**
+\brief withdraws a promise made with reserve( ); the pool keeps the memory for the next user
+
+\param bytes the amount passed to reserve( )
+*/
+void DelayMemoryArena::unreserve(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(arenaMutex);
+	reservedBytes = bytes < reservedBytes ? reservedBytes - bytes : 0;
+}
+
+/**
+\brief first-fit allocation from the pool; only goes to the OS when nothing fits
+
+\param bytes size requested
+\return aligned memory; throws std::bad_alloc if the OS is out of memory
+*/
+void* DelayMemoryArena::allocate(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(arenaMutex);
+	bytes = getBlockSize(bytes > 0 ? bytes : 1);
+
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		for (std::map<char*, size_t>::iterator it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+		{
+			if (it->second < bytes)
+				continue;
+
+			char* block = it->first;
+			size_t remainder = it->second - bytes;
+			freeBlocks.erase(it);
+
+			if (remainder > 0)
+				freeBlocks[block + bytes] = remainder;
+
+			usedBlocks[block] = bytes;
+			return block;
+		}
+
+		// --- not reserved for; this is the slow path
+		if (!addChunk(bytes))
+			break;
+	}
+
+	throw std::bad_alloc();
+}
+
+/**
+\brief returns a block to the pool
+
+\param memory a block from allocate( ), or nullptr
+*/
+void DelayMemoryArena::release(void* memory)
+{
+	if (!memory)
+		return;
+
+	std::lock_guard<std::mutex> lock(arenaMutex);
+	std::map<char*, size_t>::iterator it = usedBlocks.find((char*)memory);
+	if (it == usedBlocks.end())
+		return;
+
+	char* block = it->first;
+	size_t bytes = it->second;
+	usedBlocks.erase(it);
+	addFreeBlock(block, bytes);
+}
+
 /**
 \brief generates the oscillator output for one sample interval; note that there are multiple outputs.
 */
@@ -1019,30 +1188,604 @@ const SignalGenData LFO::renderAudioOutput()
 	return output;
 }
 
+/**
+\brief IModulationSource: render the subscribed LFO outputs at the current position, then advance hopSize samples
+
+\param hopSize samples to the next control point
+\param outputMask subscribed outputs, see modulatorOutputMask( )
+\param values output array, values[kNumModulatorOutputs]
+*/
+void LFO::renderControlPoint(uint32_t hopSize, uint32_t outputMask, double* values)
+{
+	// --- a hop can carry the counter more than one cycle at high rates, so wrap all the way back
+	modCounter -= floor(modCounter);
+
+	if (outputMask & (modulatorOutputMask(kModNormal) | modulatorOutputMask(kModInverted)))
+	{
+		values[kModNormal] = getWaveformValue(modCounter);
+		values[kModInverted] = -values[kModNormal];
+	}
+
+	if (outputMask & (modulatorOutputMask(kModQuadPhasePos) | modulatorOutputMask(kModQuadPhaseNeg)))
+	{
+		modCounterQP = modCounter;
+		advanceAndCheckWrapModulo(modCounterQP, 0.25);
+
+		values[kModQuadPhasePos] = getWaveformValue(modCounterQP);
+		values[kModQuadPhaseNeg] = -values[kModQuadPhasePos];
+	}
+
+	// --- setup for the next control point
+	advanceModulo(modCounter, phaseInc*hopSize);
+}
+
+
+#ifndef HAVE_FFTW
+// --- built-in FFT kernels: complex values are interleaved (re, im) doubles
+#if defined FXOBJECTS_SSE2
+/** (re, im) * (re, im) for one complex value */
+inline __m128d complexMultiplySSE2(__m128d z, __m128d w)
+{
+	const __m128d negateReal = _mm_castsi128_pd(_mm_set_epi64x(0, (long long)0x8000000000000000ULL));
+	__m128d products = _mm_mul_pd(z, _mm_unpacklo_pd(w, w));
+	__m128d crossProducts = _mm_mul_pd(_mm_shuffle_pd(z, z, 1), _mm_unpackhi_pd(w, w));
+	return _mm_add_pd(products, _mm_xor_pd(crossProducts, negateReal));
+}
+
+/** i*z (or -i*z with conjugate) for one complex value */
+inline __m128d multiplyBySqrtMinusOneSSE2(__m128d z, bool conjugate)
+{
+	const __m128d negateReal = _mm_castsi128_pd(_mm_set_epi64x(0, (long long)0x8000000000000000ULL));
+	const __m128d negateImag = _mm_castsi128_pd(_mm_set_epi64x((long long)0x8000000000000000ULL, 0));
+	return _mm_xor_pd(_mm_shuffle_pd(z, z, 1), conjugate ? negateImag : negateReal);
+}
+#endif
+
+#if defined FXOBJECTS_AVX
+/** (re, im) * (re, im) for two complex values */
+inline __m256d complexMultiplyAVX(__m256d z, __m256d w)
+{
+	return _mm256_addsub_pd(_mm256_mul_pd(z, _mm256_movedup_pd(w)), _mm256_mul_pd(_mm256_permute_pd(z, 0x5), _mm256_permute_pd(w, 0xF)));
+}
+
+/** i*z (or -i*z with conjugate) for two complex values */
+inline __m256d multiplyBySqrtMinusOneAVX(__m256d z, bool conjugate)
+{
+	const __m256d negateReal = _mm256_castsi256_pd(_mm256_set_epi64x(0, (long long)0x8000000000000000ULL, 0, (long long)0x8000000000000000ULL));
+	const __m256d negateImag = _mm256_castsi256_pd(_mm256_set_epi64x((long long)0x8000000000000000ULL, 0, (long long)0x8000000000000000ULL, 0));
+	return _mm256_xor_pd(_mm256_permute_pd(z, 0x5), conjugate ? negateImag : negateReal);
+}
+#endif
+
+/**
+\brief builds the twiddle tables; the complex FFT runs radix-4 passes on sub-transforms of length
+       N/2, N/8, ... and the twiddles of each pass are stored in the order the pass reads them
+
+\param _length the real FFT length (power of 2, at least 2)
+\param _inverse true for the complex to real transform
+*/
+fxfft::RealFFT::RealFFT(unsigned int _length, bool _inverse)
+{
+	length = _length;
+	halfLength = length / 2;
+	inverse = _inverse;
+	double sign = inverse ? 1.0 : -1.0;
+
+	// --- radix-4 passes
+	for (unsigned int n = halfLength; n >= 4; n /= 4)
+	{
+		stageOffsets.push_back((unsigned int)stageTwiddles.size());
+		for (unsigned int p = 0; p < n / 4; p++)
+		{
+			for (unsigned int k = 1; k <= 3; k++)
+			{
+				double theta = sign * kTwoPi * (double)(k*p) / (double)n;
+				stageTwiddles.push_back(cos(theta));
+				stageTwiddles.push_back(sin(theta));
+			}
+		}
+	}
+
+	// --- split of the half length FFT into the real FFT, always exp(-2 pi i k/N)
+	for (unsigned int k = 0; k <= length / 4; k++)
+	{
+		double theta = -kTwoPi * (double)k / (double)length;
+		realTwiddles.push_back(cos(theta));
+		realTwiddles.push_back(sin(theta));
+	}
+}
+
+/**
+\brief the N/2 point Stockham (self-sorting) complex FFT: each pass reads one array and writes the other, so
+       there is no bit reversal and no scratch memory
+
+- NOTES:<br>
+A radix-4 pass on sub-transforms of length n with stride s reads x[q + s*(p + k*n/4)] and writes
+y[q + s*(4p + k)], k = 0..3; the inner loop over q is contiguous and vectorized (SSE2 when s = 1).
+
+\param x the input; overwritten
+\param y a second array of N/2 complex values; overwritten
+\return x or y, whichever holds the result
+*/
+double* fxfft::RealFFT::complexFFT(double* x, double* y) const
+{
+	unsigned int n = halfLength;
+	unsigned int s = 1;
+	unsigned int stage = 0;
+
+	while (n >= 4)
+	{
+		const unsigned int m = n / 4;
+		const double* twiddles = &stageTwiddles[stageOffsets[stage++]];
+
+		for (unsigned int p = 0; p < m; p++)
+		{
+			const double* w = &twiddles[6 * p];
+			const double* a = &x[2 * s*p];
+			const double* b = &x[2 * s*(p + m)];
+			const double* c = &x[2 * s*(p + 2 * m)];
+			const double* d = &x[2 * s*(p + 3 * m)];
+			double* y0 = &y[2 * s * 4 * p];
+			double* y1 = y0 + 2 * s;
+			double* y2 = y0 + 4 * s;
+			double* y3 = y0 + 6 * s;
+			unsigned int q = 0;
+
+#if defined FXOBJECTS_AVX
+			if (s >= 2)
+			{
+				__m256d w1 = _mm256_broadcast_pd((const __m128d*)&w[0]);
+				__m256d w2 = _mm256_broadcast_pd((const __m128d*)&w[2]);
+				__m256d w3 = _mm256_broadcast_pd((const __m128d*)&w[4]);
+				for (; q + 2 <= s; q += 2)
+				{
+					__m256d av = _mm256_loadu_pd(&a[2 * q]);
+					__m256d bv = _mm256_loadu_pd(&b[2 * q]);
+					__m256d cv = _mm256_loadu_pd(&c[2 * q]);
+					__m256d dv = _mm256_loadu_pd(&d[2 * q]);
+					__m256d apc = _mm256_add_pd(av, cv);
+					__m256d amc = _mm256_sub_pd(av, cv);
+					__m256d bpd = _mm256_add_pd(bv, dv);
+					__m256d jbmd = multiplyBySqrtMinusOneAVX(_mm256_sub_pd(bv, dv), inverse);
+					_mm256_storeu_pd(&y0[2 * q], _mm256_add_pd(apc, bpd));
+					_mm256_storeu_pd(&y1[2 * q], complexMultiplyAVX(_mm256_sub_pd(amc, jbmd), w1));
+					_mm256_storeu_pd(&y2[2 * q], complexMultiplyAVX(_mm256_sub_pd(apc, bpd), w2));
+					_mm256_storeu_pd(&y3[2 * q], complexMultiplyAVX(_mm256_add_pd(amc, jbmd), w3));
+				}
+			}
+#endif
+#if defined FXOBJECTS_SSE2
+			__m128d w1 = _mm_loadu_pd(&w[0]);
+			__m128d w2 = _mm_loadu_pd(&w[2]);
+			__m128d w3 = _mm_loadu_pd(&w[4]);
+			for (; q < s; q++)
+			{
+				__m128d av = _mm_loadu_pd(&a[2 * q]);
+				__m128d bv = _mm_loadu_pd(&b[2 * q]);
+				__m128d cv = _mm_loadu_pd(&c[2 * q]);
+				__m128d dv = _mm_loadu_pd(&d[2 * q]);
+				__m128d apc = _mm_add_pd(av, cv);
+				__m128d amc = _mm_sub_pd(av, cv);
+				__m128d bpd = _mm_add_pd(bv, dv);
+				__m128d jbmd = multiplyBySqrtMinusOneSSE2(_mm_sub_pd(bv, dv), inverse);
+				_mm_storeu_pd(&y0[2 * q], _mm_add_pd(apc, bpd));
+				_mm_storeu_pd(&y1[2 * q], complexMultiplySSE2(_mm_sub_pd(amc, jbmd), w1));
+				_mm_storeu_pd(&y2[2 * q], complexMultiplySSE2(_mm_sub_pd(apc, bpd), w2));
+				_mm_storeu_pd(&y3[2 * q], complexMultiplySSE2(_mm_add_pd(amc, jbmd), w3));
+			}
+#endif
+			for (; q < s; q++)
+			{
+				double apcRe = a[2 * q] + c[2 * q], apcIm = a[2 * q + 1] + c[2 * q + 1];
+				double amcRe = a[2 * q] - c[2 * q], amcIm = a[2 * q + 1] - c[2 * q + 1];
+				double bpdRe = b[2 * q] + d[2 * q], bpdIm = b[2 * q + 1] + d[2 * q + 1];
+				double bmdRe = b[2 * q] - d[2 * q], bmdIm = b[2 * q + 1] - d[2 * q + 1];
+
+				// --- j(b - d); -j(b - d) for the inverse
+				double jbmdRe = inverse ? bmdIm : -bmdIm;
+				double jbmdIm = inverse ? -bmdRe : bmdRe;
+
+				double re1 = amcRe - jbmdRe, im1 = amcIm - jbmdIm;
+				double re2 = apcRe - bpdRe, im2 = apcIm - bpdIm;
+				double re3 = amcRe + jbmdRe, im3 = amcIm + jbmdIm;
+
+				y0[2 * q] = apcRe + bpdRe;
+				y0[2 * q + 1] = apcIm + bpdIm;
+				y1[2 * q] = re1*w[0] - im1*w[1];
+				y1[2 * q + 1] = re1*w[1] + im1*w[0];
+				y2[2 * q] = re2*w[2] - im2*w[3];
+				y2[2 * q + 1] = re2*w[3] + im2*w[2];
+				y3[2 * q] = re3*w[4] - im3*w[5];
+				y3[2 * q + 1] = re3*w[5] + im3*w[4];
+			}
+		}
+
+		double* swap = x;
+		x = y;
+		y = swap;
+		n = m;
+		s *= 4;
+	}
+
+	// --- odd power of 2: one radix-2 pass, no twiddles
+	if (n == 2)
+	{
+		for (unsigned int q = 0; q < 2 * s; q++)
+		{
+			y[q] = x[q] + x[q + 2 * s];
+			y[q + 2 * s] = x[q] - x[q + 2 * s];
+		}
+		return y;
+	}
+	return x;
+}
+
+/**
+\brief real to complex FFT: the N real points are the N/2 complex points z(n) = x(2n) + i x(2n+1); their FFT Z
+       is split into the even and odd sample spectra E and O, and X(k) = E(k) + exp(-2 pi i k/N) O(k)
+
+\param input N real points; overwritten
+\param output N/2 + 1 interleaved complex points
+*/
+void fxfft::RealFFT::executeForward(double* input, double* output) const
+{
+	double* result = complexFFT(input, output);
+	if (result != output)
+		memcpy(output, result, length * sizeof(double));
+
+	// --- k = 0 and k = N/2
+	double z0Re = output[0];
+	double z0Im = output[1];
+	output[0] = z0Re + z0Im;
+	output[1] = 0.0;
+	output[length] = z0Re - z0Im;
+	output[length + 1] = 0.0;
+
+	// --- k and N/2 - k together: X(k) = E + T, X(N/2 - k) = conj(E - T), T = W^k O
+	for (unsigned int k = 1; k <= halfLength / 2; k++)
+	{
+		unsigned int km = halfLength - k;
+		double aRe = output[2 * k], aIm = output[2 * k + 1];
+		double bRe = output[2 * km], bIm = -output[2 * km + 1];
+
+		double eRe = 0.5*(aRe + bRe), eIm = 0.5*(aIm + bIm);
+		double oRe = 0.5*(aIm - bIm), oIm = -0.5*(aRe - bRe);
+
+		double wRe = realTwiddles[2 * k], wIm = realTwiddles[2 * k + 1];
+		double tRe = wRe*oRe - wIm*oIm;
+		double tIm = wRe*oIm + wIm*oRe;
+
+		output[2 * k] = eRe + tRe;
+		output[2 * k + 1] = eIm + tIm;
+		if (km != k)
+		{
+			output[2 * km] = eRe - tRe;
+			output[2 * km + 1] = -(eIm - tIm);
+		}
+	}
+}
+
+/**
+\brief complex to real FFT: the inverse of executeForward( ), unnormalized (the output is N times the signal), with
+       the imaginary parts of the DC and Nyquist bins ignored, like FFTW
+
+\param input N/2 + 1 interleaved complex points; overwritten
+\param output N real points
+*/
+void fxfft::RealFFT::executeInverse(double* input, double* output) const
+{
+	// --- rebuild Z(k) = (X(k) + conj(X(N/2 - k))) + i exp(2 pi i k/N)(X(k) - conj(X(N/2 - k))) in place; the
+	//     factor of 2 against E + iO makes the N/2 point inverse scale by N
+	double x0Re = input[0];
+	double xnRe = input[length];
+	input[0] = x0Re + xnRe;
+	input[1] = x0Re - xnRe;
+
+	for (unsigned int k = 1; k <= halfLength / 2; k++)
+	{
+		unsigned int km = halfLength - k;
+		double aRe = input[2 * k], aIm = input[2 * k + 1];
+		double bRe = input[2 * km], bIm = -input[2 * km + 1];
+
+		double fRe = aRe + bRe, fIm = aIm + bIm;
+		double dRe = aRe - bRe, dIm = aIm - bIm;
+
+		// --- U = i conj(W^k) D
+		double wRe = realTwiddles[2 * k], wIm = -realTwiddles[2 * k + 1];
+		double vRe = wRe*dRe - wIm*dIm;
+		double vIm = wRe*dIm + wIm*dRe;
+		double uRe = -vIm, uIm = vRe;
+
+		input[2 * k] = fRe + uRe;
+		input[2 * k + 1] = fIm + uIm;
+		if (km != k)
+		{
+			input[2 * km] = fRe - uRe;
+			input[2 * km + 1] = -(fIm - uIm);
+		}
+	}
+
+	// --- z(n) = x(2n) + i x(2n+1) is already the interleaved real output
+	double* result = complexFFT(input, output);
+	if (result != output)
+		memcpy(output, result, length * sizeof(double));
+}
+#endif
+
+/**
+\brief makes a plan: runs the FFTW planner on scratch arrays, since it may write to them (kPlanMeasure), or builds a
+       RealFFT, which ignores the flags
+
+\param length the FFT length
+\param type real-to-complex or complex-to-real (both use length/2 + 1 complex points)
+\param flags planner flags (kPlanMeasure, kPlanEstimate, or FFTW's own with HAVE_FFTW)
+
+\return the plan, or nullptr if FFTW could not make it
+*/
+fxfft::plan fxfft::makePlan(unsigned int length, fftwPlanType type, unsigned int flags)
+{
+#ifdef HAVE_FFTW
+	double* timeData = (double*)allocate(sizeof(double) * length);
+	complex* spectrumData = (complex*)allocate(sizeof(complex) * (length / 2 + 1));
+
+	plan transform = nullptr;
+	if (type == fftwPlanType::kRealToComplex)
+		transform = fftw_plan_dft_r2c_1d(length, timeData, spectrumData, flags);
+	else
+		transform = fftw_plan_dft_c2r_1d(length, spectrumData, timeData, flags);
+
+	release(timeData);
+	release(spectrumData);
+	return transform;
+#else
+	(void)flags;
+	return new RealFFT(length, type == fftwPlanType::kComplexToReal);
+#endif
+}
+
+/**
+\brief imports FFTW wisdom; a missing or stale (other machine or FFTW version) file is not an error, the planner
+       just measures again. On POSIX systems a file that is not a regular file owned by this user is ignored.
+
+\param path the wisdom file; empty for none
 
+\return true if the file was read
+*/
+bool fxfft::importWisdom(const std::string& path)
+{
 #ifdef HAVE_FFTW
+	if (path.empty())
+		return false;
+
+#if defined _WIN32
+	FILE* file = nullptr;
+	if (fopen_s(&file, path.c_str(), "r") != 0)
+		return false;
+#else
+	FILE* file = fopen(path.c_str(), "r");
+	if (!file)
+		return false;
+
+	// --- only trust wisdom this user wrote
+	struct stat status;
+	if (fstat(fileno(file), &status) != 0 || !S_ISREG(status.st_mode) || status.st_uid != geteuid())
+	{
+		fclose(file);
+		return false;
+	}
+#endif
+
+	bool imported = fftw_import_wisdom_from_file(file) != 0;
+	fclose(file);
+	return imported;
+#else
+	(void)path;
+	return false;
+#endif
+}
 
 /**
-\brief destroys the FFTW arrays and plans.
+\brief exports the accumulated FFTW wisdom: it is written to a new, exclusively created file in the same folder,
+       which is then renamed over the wisdom file, so a planted file or link is never written through and readers
+       never see a partial file
+
+\param path the wisdom file; empty for none
+
+\return true if the file was written
 */
-void FastFFT::destroyFFTW()
+bool fxfft::exportWisdom(const std::string& path)
 {
 #ifdef HAVE_FFTW
-	if (plan_forward)
-		fftw_destroy_plan(plan_forward);
-	if (plan_backward)
-		fftw_destroy_plan(plan_backward);
+	if (path.empty())
+		return false;
+
+#if defined _WIN32
+	std::string tempFile = path + ".tmp";
+	remove(tempFile.c_str());
+	FILE* file = nullptr;
+	if (fopen_s(&file, tempFile.c_str(), "wbx") != 0)
+		return false;
+#else
+	std::string tempFile = path + ".XXXXXX";
+	int descriptor = mkstemp(&tempFile[0]);
+	if (descriptor < 0)
+		return false;
+
+	FILE* file = fdopen(descriptor, "wb");
+	if (!file)
+	{
+		close(descriptor);
+		remove(tempFile.c_str());
+		return false;
+	}
+#endif
+
+	fftw_export_wisdom_to_file(file);
+	bool written = ferror(file) == 0;
+	written = fclose(file) == 0 && written;
+
+#if defined _WIN32
+	written = written && MoveFileExA(tempFile.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	written = written && rename(tempFile.c_str(), path.c_str()) == 0;
+#endif
+
+	if (!written)
+		remove(tempFile.c_str());
+	return written;
+#else
+	(void)path;
+	return false;
+#endif
+}
+
+/**
+\brief the process-wide FFTW plan registry; allocated once and intentionally never destroyed
+
+\return the registry
+*/
+FFTWPlanRegistry& FFTWPlanRegistry::getInstance()
+{
+	static FFTWPlanRegistry* registry = new FFTWPlanRegistry;
+	return *registry;
+}
+
+/**
+\brief sets the default wisdom file: one per user in the user's cache folder (%LOCALAPPDATA%, ~/Library/Caches or
+       $XDG_CACHE_HOME, default ~/.cache), shared by all plugins and instances of that user; if there is no such
+       folder the wisdom is not saved
+*/
+FFTWPlanRegistry::FFTWPlanRegistry()
+{
+	const char* fileName = "aspik_fftw_wisdom.txt";
+#if defined _WIN32
+	const char* folder = getenv("LOCALAPPDATA");
+	if (folder)
+		wisdomFile = std::string(folder) + "\\" + fileName;
+#elif defined __APPLE__
+	const char* home = getenv("HOME");
+	if (home)
+		wisdomFile = std::string(home) + "/Library/Caches/" + fileName;
+#else
+	// --- the XDG spec says to ignore a relative $XDG_CACHE_HOME
+	const char* cache = getenv("XDG_CACHE_HOME");
+	const char* home = getenv("HOME");
+	std::string folder;
+	if (cache && cache[0] == '/')
+		folder = cache;
+	else if (home)
+		folder = std::string(home) + "/.cache";
+
+	if (!folder.empty())
+	{
+	#ifdef HAVE_FFTW
+		// --- ~/.cache need not exist yet
+		mkdir(folder.c_str(), 0700);
+	#endif
+		wisdomFile = folder + "/" + fileName;
+	}
+#endif
+}
+
+/**
+\brief sets the wisdom file; the next getPlan( ) imports it
+
+\param path the full path of the wisdom file; empty to not load or save wisdom
+*/
+void FFTWPlanRegistry::setWisdomFile(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	wisdomFile = path;
+	wisdomLoaded = false;
+}
+
+/**
+\brief imports the wisdom file, once; a missing or stale (other machine or FFTW version) file is not an error,
+       the planner just measures again
+
+- NOTES:<br>
+caller holds the lock
+*/
+void FFTWPlanRegistry::loadWisdom()
+{
+	if (wisdomLoaded)
+		return;
+
+	fxfft::importWisdom(wisdomFile);
+	wisdomLoaded = true;
+}
+
+/**
+\brief exports the accumulated wisdom to the wisdom file
+
+- NOTES:<br>
+caller holds the lock
+
+\return true if the file was written
+*/
+bool FFTWPlanRegistry::exportWisdom()
+{
+	return fxfft::exportWisdom(wisdomFile);
+}
+
+/**
+\brief writes the accumulated wisdom to the wisdom file
+
+\return true if the file was written
+*/
+bool FFTWPlanRegistry::saveWisdom()
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	return exportWisdom();
+}
+
+/**
+\brief gets the shared plan for a transform; the first request for a (length, type, flags) key makes the plan
+       and saves the new wisdom
+
+\param length the FFT length
+\param type real-to-complex or complex-to-real (both use length/2 + 1 complex points)
+\param flags planner flags (fxfft::kPlanMeasure, fxfft::kPlanEstimate, ...)
+
+\return the plan, or nullptr if FFTW could not make it
+*/
+fxfft::plan FFTWPlanRegistry::getPlan(unsigned int length, fftwPlanType type, unsigned int flags)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	loadWisdom();
+
+	std::tuple<unsigned int, fftwPlanType, unsigned int> key(length, type, flags);
+	auto it = plans.find(key);
+	if (it != plans.end())
+		return it->second;
+
+	fxfft::plan plan = fxfft::makePlan(length, type, flags);
+	if (plan)
+	{
+		plans[key] = plan;
+		exportWisdom();
+	}
+	return plan;
+}
+
+/**
+\brief destroys the FFTW arrays and releases the plans.
+*/
+void FastFFT::destroyFFTW()
+{
+	// --- the plans belong to the FFTWPlanRegistry
+	plan_forward = nullptr;
+	plan_backward = nullptr;
 
 	if (fft_input)
-		fftw_free(fft_input);
+		fxfft::release(fft_input);
 	if (fft_result)
-		fftw_free(fft_result);
+		fxfft::release(fft_result);
 
 	if (ifft_input)
-		fftw_free(ifft_input);
+		fxfft::release(ifft_input);
 	if (ifft_result)
-		fftw_free(ifft_result);
-#endif
+		fxfft::release(ifft_result);
 }
 
 
@@ -1129,15 +1872,17 @@ void FastFFT::initialize(unsigned int _frameLength, windowType _window)
 	// --- calculate gain correction factor
 	windowGainCorrection = 1.0 / windowGainCorrection;
 
+	// --- real input: the r2c/c2r transforms only need the half spectrum
 	destroyFFTW();
-	fft_input = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	fft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
+	numBins = frameLength / 2 + 1;
+	fft_input = (double*)fxfft::allocate(sizeof(double) * frameLength);
+	fft_result = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
 
-	ifft_input =  (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	ifft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
+	ifft_input =  (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
+	ifft_result = (double*)fxfft::allocate(sizeof(double) * frameLength);
 
-	plan_forward = fftw_plan_dft_1d(frameLength, fft_input, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
-	plan_backward = fftw_plan_dft_1d(frameLength, ifft_input, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
+	plan_forward = FFTWPlanRegistry::getInstance().getPlan(frameLength, fftwPlanType::kRealToComplex);
+	plan_backward = FFTWPlanRegistry::getInstance().getPlan(frameLength, fftwPlanType::kComplexToReal);
 }
 
 /**
@@ -1146,24 +1891,17 @@ void FastFFT::initialize(unsigned int _frameLength, windowType _window)
 - NOTES:<br>
 
 \param inputReal an array of real valued points
-\param inputImag an array of imaginary valued points (will be 0 for audio which is real-valued)
 
-\returns a pointer to a fftw_complex array: a 2D array of real (column 0) and imaginary (column 1) parts
+\returns a pointer to an fxfft::complex array: a 2D array of real (column 0) and imaginary (column 1) parts
+of the half spectrum, getNumBins( ) long; the other bins are the complex conjugates of these
 */
-fftw_complex* FastFFT::doFFT(double* inputReal, double* inputImag)
+fxfft::complex* FastFFT::doFFT(double* inputReal)
 {
 	// ------ load up the FFT input array
-	for (int i = 0; i < frameLength; i++)
-	{
-		fft_input[i][0] = inputReal[i];		// --- real
-		if (inputImag)
-			fft_input[i][1] = inputImag[i]; // --- imag
-		else
-			fft_input[i][1] = 0.0;
-	}
+	memcpy(fft_input, inputReal, frameLength * sizeof(double));
 
 	// --- do the FFT
-	fftw_execute(plan_forward);
+	fxfft::executeRealToComplex(plan_forward, fft_input, fft_result);
 
 	return fft_result;
 }
@@ -1173,15 +1911,15 @@ fftw_complex* FastFFT::doFFT(double* inputReal, double* inputImag)
 
 - NOTES:<br>
 
-\param inputReal an array of real valued points
-\param inputImag an array of imaginary valued points (will be 0 for audio which is real-valued)
+\param inputReal an array of the real parts of the half spectrum, getNumBins( ) long
+\param inputImag an array of the imaginary parts of the half spectrum, getNumBins( ) long (may be NULL)
 
-\returns a pointer to a fftw_complex array: a 2D array of real (column 0) and imaginary (column 1) parts
+\returns a pointer to the real valued output, getFrameLength( ) long
 */
-fftw_complex* FastFFT::doInverseFFT(double* inputReal, double* inputImag)
+double* FastFFT::doInverseFFT(double* inputReal, double* inputImag)
 {
 	// ------ load up the iFFT input array
-	for (int i = 0; i < frameLength; i++)
+	for (unsigned int i = 0; i < numBins; i++)
 	{
 		ifft_input[i][0] = inputReal[i];		// --- real
 		if (inputImag)
@@ -1191,27 +1929,28 @@ fftw_complex* FastFFT::doInverseFFT(double* inputReal, double* inputImag)
 	}
 
 	// --- do the IFFT
-	fftw_execute(plan_backward);
+	fxfft::executeComplexToReal(plan_backward, ifft_input, ifft_result);
 
 	return ifft_result;
 }
 
 /**
-\brief destroys the FFTW arrays and plans.
+\brief destroys the FFTW arrays and releases the plans.
 */
 void PhaseVocoder::destroyFFTW()
 {
-	if (plan_forward)
-		fftw_destroy_plan(plan_forward);
-	if (plan_backward)
-		fftw_destroy_plan(plan_backward);
+	// --- the plans belong to the FFTWPlanRegistry
+	plan_forward = nullptr;
+	plan_backward = nullptr;
 
 	if (fft_input)
-		fftw_free(fft_input);
+		fxfft::release(fft_input);
 	if (fft_result)
-		fftw_free(fft_result);
+		fxfft::release(fft_result);
+	if (ifft_input)
+		fxfft::release(ifft_input);
 	if (ifft_result)
-		fftw_free(ifft_result);
+		fxfft::release(ifft_result);
 }
 
 /**
@@ -1346,15 +2085,16 @@ void PhaseVocoder::initialize(unsigned int _frameLength, unsigned int _hopSize,
 	needInverseFFT = false;
 	needOverlapAdd = false;
 
-#ifdef HAVE_FFTW
+	// --- real input: the r2c/c2r transforms only need the half spectrum
 	destroyFFTW();
-	fft_input = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	fft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-	ifft_result = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * frameLength);
-
-	plan_forward = fftw_plan_dft_1d(frameLength, fft_input, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
-	plan_backward = fftw_plan_dft_1d(frameLength, fft_result, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
-#endif
+	numBins = frameLength / 2 + 1;
+	fft_input = (double*)fxfft::allocate(sizeof(double) * frameLength);
+	fft_result = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
+	ifft_input = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
+	ifft_result = (double*)fxfft::allocate(sizeof(double) * frameLength);
+
+	plan_forward = FFTWPlanRegistry::getInstance().getPlan(frameLength, fftwPlanType::kRealToComplex);
+	plan_backward = FFTWPlanRegistry::getInstance().getPlan(frameLength, fftwPlanType::kComplexToReal);
 }
 
 /**
@@ -1408,15 +2148,14 @@ bool PhaseVocoder::advanceAndCheckFFT()
 	// --- load up the input to the FFT
 	for (int i = 0; i < frameLength; i++)
 	{
-		fft_input[i][0] = inputBuffer[inputReadIndex++] * windowBuffer[i];
-		fft_input[i][1] = 0.0; // use this if your data is complex valued
+		fft_input[i] = inputBuffer[inputReadIndex++] * windowBuffer[i];
 
 		// --- wrap if index > bufferlength - 1
 		inputReadIndex &= wrapMask;
 	}
 
 	// --- do the FFT
-	fftw_execute(plan_forward);
+	fxfft::executeRealToComplex(plan_forward, fft_input, fft_result);
 
 	// --- in case user does not take IFFT, just to prevent zero output
 	needInverseFFT = true;
@@ -1492,8 +2231,11 @@ then you can call this function at the appropriate time - see the PSMVocoder obj
 */
 void PhaseVocoder::doInverseFFT()
 {
+	// --- the c2r transform overwrites its input, so run it on a copy; getFFTData( ) stays valid
+	memcpy(ifft_input, fft_result, numBins * sizeof(fxfft::complex));
+
 	// do the IFFT
-	fftw_execute(plan_backward);
+	fxfft::executeComplexToReal(plan_backward, ifft_input, ifft_result);
 
 	// --- output is now in ifft_result array
 	needInverseFFT = false;
@@ -1532,7 +2274,7 @@ void PhaseVocoder::doOverlapAdd(double* outputData, int length)
 	for (int i = 0; i < frameLength; i++)
 	{
 		// --- accumulate
-		outputBuffer[outputWriteIndex++] += windowHopCorrection * ifft_result[i][0];
+		outputBuffer[outputWriteIndex++] += windowHopCorrection * ifft_result[i];
 
 		// --- wrap if index > bufferlength - 1
 		outputWriteIndex &= wrapMaskOut;
@@ -1542,5 +2284,222 @@ void PhaseVocoder::doOverlapAdd(double* outputData, int length)
 	needOverlapAdd = false;
 }
 
-#endif
+/**
+\brief destroys the FFTW arrays and releases the plans.
+*/
+void PartitionedConvolver::destroyFFTW()
+{
+	// --- the plans belong to the FFTWPlanRegistry
+	planForward = nullptr;
+	planBackward = nullptr;
+
+	if (fftBuffer)
+		fxfft::release(fftBuffer);
+	if (spectrum)
+		fxfft::release(spectrum);
+	if (accumulator)
+		fxfft::release(accumulator);
+	if (fdl)
+		fxfft::release(fdl);
+	if (irSpectra)
+		fxfft::release(irSpectra);
+	fftBuffer = nullptr;
+	spectrum = nullptr;
+	accumulator = nullptr;
+	fdl = nullptr;
+	irSpectra = nullptr;
+}
+
+/**
+\brief creates the buffers and the r2c/c2r plans for a partition length; the IR is cleared
+
+\param _partitionLength - samples per partition B (power of 2); the FFT length is 2B
+\param _zeroLatency - run the first partition as a direct form FIR for zero latency
+*/
+void PartitionedConvolver::initialize(unsigned int _partitionLength, bool _zeroLatency)
+{
+	destroyFFTW();
+
+	partitionLength = _partitionLength;
+	zeroLatency = _zeroLatency;
+	numBins = partitionLength + 1;
+	numPartitions = 0;
+
+	inputBlock.reset(new double[2 * partitionLength]);
+	tailOutput.reset(new double[partitionLength]);
+	headReversed.reset(new double[partitionLength]);
+	memset(&headReversed[0], 0, partitionLength * sizeof(double));
+
+	fftBuffer = (double*)fxfft::allocate(sizeof(double) * 2 * partitionLength);
+	spectrum = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
+	accumulator = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins);
 
+	planForward = FFTWPlanRegistry::getInstance().getPlan(2 * partitionLength, fftwPlanType::kRealToComplex);
+	planBackward = FFTWPlanRegistry::getInstance().getPlan(2 * partitionLength, fftwPlanType::kComplexToReal);
+
+	reset();
+}
+
+/**
+\brief splits the IR into the direct form head (zero latency mode) and the FFT partitions, and transforms them
+in place; the input history and the FDL are kept so the IR may change while running, unless the partition count
+changes, in which case the FDL is reallocated and the convolver is flushed
+
+\param irArray - the impulse response
+\param irLength - the length of the impulse response; any length
+*/
+void PartitionedConvolver::setImpulseResponse(const double* irArray, unsigned int irLength)
+{
+	if (partitionLength == 0)
+		return;
+
+	// --- the head: first partition, time reversed
+	unsigned int firstPartition = 0;
+	if (zeroLatency)
+	{
+		memset(&headReversed[0], 0, partitionLength * sizeof(double));
+		for (unsigned int i = 0; i < partitionLength && i < irLength; i++)
+			headReversed[partitionLength - 1 - i] = irArray[i];
+		firstPartition = 1;
+	}
+
+	// --- the FFT partitions
+	unsigned int totalPartitions = (irLength + partitionLength - 1) / partitionLength;
+	unsigned int newNumPartitions = totalPartitions > firstPartition ? totalPartitions - firstPartition : 0;
+	bool reallocated = newNumPartitions != numPartitions;
+	if (reallocated)
+	{
+		if (fdl)
+			fxfft::release(fdl);
+		if (irSpectra)
+			fxfft::release(irSpectra);
+		fdl = nullptr;
+		irSpectra = nullptr;
+
+		numPartitions = newNumPartitions;
+		if (numPartitions > 0)
+		{
+			fdl = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins * numPartitions);
+			irSpectra = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * numBins * numPartitions);
+		}
+	}
+
+	// --- zero padded partition spectra, with the 1/2B of the inverse FFT folded in
+	double scale = 1.0 / (2.0 * partitionLength);
+	for (unsigned int p = 0; p < numPartitions; p++)
+	{
+		unsigned int offset = (p + firstPartition) * partitionLength;
+		memset(fftBuffer, 0, 2 * partitionLength * sizeof(double));
+		for (unsigned int i = 0; i < partitionLength && offset + i < irLength; i++)
+			fftBuffer[i] = irArray[offset + i] * scale;
+
+		fxfft::executeRealToComplex(planForward, fftBuffer, spectrum);
+		memcpy(&irSpectra[p*numBins], spectrum, numBins * sizeof(fxfft::complex));
+	}
+
+	// --- a new FDL holds no history yet
+	if (reallocated)
+		reset();
+}
+
+/**
+\brief flushes the input history, the FDL and the pending output; the IR is kept
+*/
+void PartitionedConvolver::reset()
+{
+	if (partitionLength == 0)
+		return;
+
+	memset(&inputBlock[0], 0, 2 * partitionLength * sizeof(double));
+	memset(&tailOutput[0], 0, partitionLength * sizeof(double));
+	if (fdl)
+		memset(fdl, 0, numPartitions * numBins * sizeof(fxfft::complex));
+	fdlIndex = 0;
+	inputCount = 0;
+}
+
+/**
+\brief called when the input block is full: overlap-save FFT of the last two blocks into the FDL, spectral
+multiply-add over all partitions and inverse FFT into the output for the next block
+
+- NOTES:<br>
+In zero latency mode FDL partition p holds IR partition p + 1, so the newest input spectrum is convolved
+with the IR delayed by B: its output belongs to the next block, which is exactly where it is played.<br>
+In latency mode FDL partition p is IR partition p, and the output of the block is played one block late.
+*/
+void PartitionedConvolver::processPartition()
+{
+	if (numPartitions > 0)
+	{
+		// --- newest spectrum into the FDL; the older spectra follow it
+		memcpy(fftBuffer, &inputBlock[0], 2 * partitionLength * sizeof(double));
+		fxfft::executeRealToComplex(planForward, fftBuffer, spectrum);
+
+		fdlIndex = fdlIndex == 0 ? numPartitions - 1 : fdlIndex - 1;
+		memcpy(&fdl[fdlIndex*numBins], spectrum, numBins * sizeof(fxfft::complex));
+
+		// --- Y = sum of X(m-p)H(p)
+		memset(accumulator, 0, numBins * sizeof(fxfft::complex));
+		unsigned int slot = fdlIndex;
+		for (unsigned int p = 0; p < numPartitions; p++)
+		{
+			complexMultiplyAccumulate(accumulator, &fdl[slot*numBins], &irSpectra[p*numBins], numBins);
+			if (++slot == numPartitions)
+				slot = 0;
+		}
+
+		// --- the second half of the circular convolution is the linear convolution
+		fxfft::executeComplexToReal(planBackward, accumulator, fftBuffer);
+		memcpy(&tailOutput[0], &fftBuffer[partitionLength], partitionLength * sizeof(double));
+	}
+
+	// --- the current block becomes the previous block
+	memcpy(&inputBlock[0], &inputBlock[partitionLength], partitionLength * sizeof(double));
+	inputCount = 0;
+}
+
+/**
+\brief the process-wide polyphase filter cache; allocated once and intentionally never destroyed
+
+\return the cache
+*/
+PolyphaseFilterCache& PolyphaseFilterCache::getInstance()
+{
+	static PolyphaseFilterCache* cache = new PolyphaseFilterCache;
+	return *cache;
+}
+
+/**
+\brief finds or makes the polyphase decomposition of a built-in anti-aliasing filter
+
+- NOTES:<br>
+The returned array is never moved or freed (map nodes are stable), so objects may keep the pointer.
+
+\param FIRLength the anti-aliasing filter length
+\param ratio the conversion ratio (see rateConversionRatio)
+\param sampleRate the base sample rate
+\return count phases of FIRLength/count coefficients, phase i holding h(i), h(i + count), ...; nullptr if there is no
+        built-in filter for these settings
+*/
+const double* PolyphaseFilterCache::getPolyphaseFilters(unsigned int FIRLength, rateConversionRatio ratio, unsigned int sampleRate)
+{
+	double* filterTable = getFilterIRTable(FIRLength, ratio, sampleRate);
+	unsigned int count = countForRatio(ratio);
+	if (!filterTable || count == 0)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	std::vector<double>& phases = filters[std::make_tuple(FIRLength, count, sampleRate)];
+	if (phases.empty())
+	{
+		unsigned int subBandLength = FIRLength / count;
+		phases.resize(count * subBandLength);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			for (unsigned int k = 0; k < subBandLength; k++)
+				phases[i*subBandLength + k] = filterTable[k*count + i];
+		}
+	}
+	return &phases[0];
+}
@@ -19,10 +19,35 @@
 
 #include <memory>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <stdlib.h>
 #include "guiconstants.h"
 #include "filters.h"
 #include <time.h>       /* time */
 
+// --- SIMD support for the vectorized kernels; every kernel has a scalar fallback
+//     NOTE: MSVC defines __AVX__ with /arch:AVX or higher; SSE2 is always available on x64
+#if defined(__AVX__)
+	#define FXOBJECTS_AVX 1
+	#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define FXOBJECTS_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+// --- FFT objects and the partitioned convolver: define HAVE_FFTW and link libfftw3 to use FFTW,
+//     otherwise they run on the built-in RealFFT (see below)
+#ifdef HAVE_FFTW
+	#include "fftw3.h"
+#endif
+
 /** @file fxobjects.h
 \brief HELLO LOOK
 */
@@ -118,6 +143,104 @@ inline double doLinearInterpolation(double y1, double y2, double fractional_X)
 	return fractional_X*y2 + (1.0 - fractional_X)*y1;
 }
 
+/**
+@doLinearInterpolation
+\ingroup FX-Functions
+
+@brief performs linear interpolation on arrays of point pairs, each with its own fractional distance;
+uses AVX/SSE2 when available. Same weighted sum as the single-point version; fractional_X must be < 1.0
+
+\param y1 - array of the y coordinates of the first points
+\param y2 - array of the y coordinates of the second points
+\param fractional_X - array of fractional distances between each y1 and y2
+\param output - array to receive the interpolated values
+\param length - number of points
+*/
+inline void doLinearInterpolation(const double* y1, const double* y2, const double* fractional_X, double* output, unsigned int length)
+{
+	unsigned int i = 0;
+
+#if defined FXOBJECTS_AVX
+	const __m256d one4 = _mm256_set1_pd(1.0);
+	for (; i + 4 <= length; i += 4)
+	{
+		__m256d fraction = _mm256_loadu_pd(&fractional_X[i]);
+		__m256d weighted2 = _mm256_mul_pd(fraction, _mm256_loadu_pd(&y2[i]));
+		__m256d weighted1 = _mm256_mul_pd(_mm256_sub_pd(one4, fraction), _mm256_loadu_pd(&y1[i]));
+		_mm256_storeu_pd(&output[i], _mm256_add_pd(weighted2, weighted1));
+	}
+#endif
+#if defined FXOBJECTS_SSE2
+	const __m128d one2 = _mm_set1_pd(1.0);
+	for (; i + 2 <= length; i += 2)
+	{
+		__m128d fraction = _mm_loadu_pd(&fractional_X[i]);
+		__m128d weighted2 = _mm_mul_pd(fraction, _mm_loadu_pd(&y2[i]));
+		__m128d weighted1 = _mm_mul_pd(_mm_sub_pd(one2, fraction), _mm_loadu_pd(&y1[i]));
+		_mm_storeu_pd(&output[i], _mm_add_pd(weighted2, weighted1));
+	}
+#endif
+	for (; i < length; i++)
+		output[i] = fractional_X[i] * y2[i] + (1.0 - fractional_X[i])*y1[i];
+}
+
+/**
+@doLinearInterpolation
+\ingroup FX-Functions
+
+@brief performs linear interpolation on arrays of point pairs that share one fractional distance
+(e.g. a fixed fractional delay read over a run of samples); uses AVX/SSE2 when available
+
+\param y1 - array of the y coordinates of the first points
+\param y2 - array of the y coordinates of the second points
+\param fractional_X - the fractional distance between each y1 and y2; must be < 1.0
+\param output - array to receive the interpolated values
+\param length - number of points
+*/
+inline void doLinearInterpolation(const double* y1, const double* y2, double fractional_X, double* output, unsigned int length)
+{
+	unsigned int i = 0;
+	double oneMinusFraction = 1.0 - fractional_X;
+
+#if defined FXOBJECTS_AVX
+	const __m256d fraction4 = _mm256_set1_pd(fractional_X);
+	const __m256d oneMinus4 = _mm256_set1_pd(oneMinusFraction);
+	for (; i + 4 <= length; i += 4)
+	{
+		__m256d weighted2 = _mm256_mul_pd(fraction4, _mm256_loadu_pd(&y2[i]));
+		__m256d weighted1 = _mm256_mul_pd(oneMinus4, _mm256_loadu_pd(&y1[i]));
+		_mm256_storeu_pd(&output[i], _mm256_add_pd(weighted2, weighted1));
+	}
+#endif
+#if defined FXOBJECTS_SSE2
+	const __m128d fraction2 = _mm_set1_pd(fractional_X);
+	const __m128d oneMinus2 = _mm_set1_pd(oneMinusFraction);
+	for (; i + 2 <= length; i += 2)
+	{
+		__m128d weighted2 = _mm_mul_pd(fraction2, _mm_loadu_pd(&y2[i]));
+		__m128d weighted1 = _mm_mul_pd(oneMinus2, _mm_loadu_pd(&y1[i]));
+		_mm_storeu_pd(&output[i], _mm_add_pd(weighted2, weighted1));
+	}
+#endif
+	for (; i < length; i++)
+		output[i] = fractional_X * y2[i] + oneMinusFraction*y1[i];
+}
+
+/** scalar versions of the array interpolators for other storage types (e.g. float); the math and output are double */
+template <typename T>
+inline void doLinearInterpolation(const T* y1, const T* y2, const double* fractional_X, double* output, unsigned int length)
+{
+	for (unsigned int i = 0; i < length; i++)
+		output[i] = fractional_X[i] * y2[i] + (1.0 - fractional_X[i])*y1[i];
+}
+
+template <typename T>
+inline void doLinearInterpolation(const T* y1, const T* y2, double fractional_X, double* output, unsigned int length)
+{
+	for (unsigned int i = 0; i < length; i++)
+		output[i] = fractional_X * y2[i] + (1.0 - fractional_X)*y1[i];
+}
+
 /**
 @doLagrangeInterpolation
 \ingroup FX-Functions
@@ -148,6 +271,317 @@ inline double doLagrangeInterpolation(double* x, double* y, int n, double xbar)
 	return (fx);
 }
 
+/**
+\enum delayInterpolation
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to select the fractional delay interpolator of the CircularBuffer and ExactCircularBuffer.
+The FIR interpolators also read samples newer than the integer delay, so they need a minimum delay
+(see getInterpolatorNewerTaps( )).
+
+- kNone: truncate to the integer delay
+- kLinear: 2-point linear; the default
+- kHermite: 4-point, 3rd-order Hermite (Catmull-Rom); much flatter than linear for about twice the cost
+- kLagrange3: 4-point, 3rd-order Lagrange
+- kThiran: 1st-order Thiran allpass; flat magnitude, but recursive, so best for fixed or slowly moving delays
+- kSinc: 8-point Blackman-windowed sinc, interpolated from a kSincInterpolatorPhases table
+
+- enum class delayInterpolation { kNone, kLinear, kHermite, kLagrange3, kThiran, kSinc };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class delayInterpolation { kNone, kLinear, kHermite, kLagrange3, kThiran, kSinc };
+
+const unsigned int kMaxInterpolatorTaps = 8;		///< longest interpolator (kSinc)
+const unsigned int kSincInterpolatorPhases = 256;	///< kSinc table resolution
+const unsigned int kMaxThiranTaps = 8;				///< kThiran allpass states per buffer; further taps fall back to kLinear
+
+/**
+@getInterpolatorTaps
+\ingroup FX-Functions
+
+@brief the number of samples an interpolator reads for one output
+
+\param type - the interpolator
+\return the number of samples
+*/
+inline unsigned int getInterpolatorTaps(delayInterpolation type)
+{
+	if (type == delayInterpolation::kNone)
+		return 1;
+	else if (type == delayInterpolation::kHermite || type == delayInterpolation::kLagrange3)
+		return 4;
+	else if (type == delayInterpolation::kSinc)
+		return kMaxInterpolatorTaps;
+	return 2;
+}
+
+/**
+@getInterpolatorNewerTaps
+\ingroup FX-Functions
+
+@brief the number of those samples that are newer than the integer delay; this is also the shortest
+delay in samples that the interpolator can read correctly
+
+\param type - the interpolator
+\return the number of newer samples
+*/
+inline unsigned int getInterpolatorNewerTaps(delayInterpolation type)
+{
+	if (type == delayInterpolation::kHermite || type == delayInterpolation::kLagrange3 || type == delayInterpolation::kThiran)
+		return 1;
+	else if (type == delayInterpolation::kSinc)
+		return kMaxInterpolatorTaps / 2 - 1;
+	return 0;
+}
+
+/**
+@getShortestBlockDelay
+\ingroup FX-Functions
+
+@brief the shortest delay that a block read of numFrames frames can serve without reaching a sample written inside
+the block: (numFrames - 1) plus getInterpolatorNewerTaps( ). kThiran borrows its newer sample only when the fraction
+is below 0.5 and the integer delay is not zero, so it needs (numFrames - 0.5), and one frame may read any delay.
+
+\param type - the interpolator
+\param numFrames - the block length
+\return the shortest delay in samples
+*/
+inline double getShortestBlockDelay(delayInterpolation type, unsigned int numFrames)
+{
+	if (type == delayInterpolation::kThiran)
+		return numFrames > 1 ? (double)numFrames - 0.5 : 0.0;
+	return (double)numFrames - 1.0 + getInterpolatorNewerTaps(type);
+}
+
+/**
+\class SincInterpolationTable
+\ingroup FX-Objects
+\brief
+The SincInterpolationTable object holds the kSinc interpolator coefficients, shared by every delay line: one row of
+kMaxInterpolatorTaps Blackman-windowed sinc coefficients per phase, normalized to unity DC gain, plus a guard row so
+that the rows can be interpolated without wrapping.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class SincInterpolationTable
+{
+public:
+	/** the shared table; built on first use */
+	static const SincInterpolationTable& getInstance()
+	{
+		static SincInterpolationTable sincTable;
+		return sincTable;
+	}
+
+	/** the coefficients for a fractional position, newest sample first */
+	/**
+	\param fraction distance from the sample at the integer delay toward the next older sample, [0, 1)
+	\param coeffs array to receive kMaxInterpolatorTaps coefficients
+	*/
+	void getCoefficients(double fraction, double* coeffs) const
+	{
+		double phase = fraction * kSincInterpolatorPhases;
+		unsigned int row = (unsigned int)phase;
+		row = row < kSincInterpolatorPhases ? row : kSincInterpolatorPhases - 1;
+		double rowFraction = phase - row;
+
+		const double* row1 = &table[row][0];
+		const double* row2 = &table[row + 1][0];
+		unsigned int i = 0;
+
+#if defined FXOBJECTS_AVX
+		const __m256d fraction4 = _mm256_set1_pd(rowFraction);
+		for (; i + 4 <= kMaxInterpolatorTaps; i += 4)
+		{
+			__m256d y1 = _mm256_loadu_pd(&row1[i]);
+			__m256d difference = _mm256_sub_pd(_mm256_loadu_pd(&row2[i]), y1);
+			_mm256_storeu_pd(&coeffs[i], _mm256_add_pd(y1, _mm256_mul_pd(fraction4, difference)));
+		}
+#endif
+#if defined FXOBJECTS_SSE2
+		const __m128d fraction2 = _mm_set1_pd(rowFraction);
+		for (; i + 2 <= kMaxInterpolatorTaps; i += 2)
+		{
+			__m128d y1 = _mm_loadu_pd(&row1[i]);
+			__m128d difference = _mm_sub_pd(_mm_loadu_pd(&row2[i]), y1);
+			_mm_storeu_pd(&coeffs[i], _mm_add_pd(y1, _mm_mul_pd(fraction2, difference)));
+		}
+#endif
+		for (; i < kMaxInterpolatorTaps; i++)
+			coeffs[i] = row1[i] + rowFraction * (row2[i] - row1[i]);
+	}
+
+private:
+	SincInterpolationTable()
+	{
+		const int newerTaps = (int)getInterpolatorNewerTaps(delayInterpolation::kSinc);
+		const double halfWidth = kMaxInterpolatorTaps / 2;
+
+		for (unsigned int row = 0; row <= kSincInterpolatorPhases; row++)
+		{
+			double fraction = (double)row / kSincInterpolatorPhases;
+			double sum = 0.0;
+
+			for (unsigned int i = 0; i < kMaxInterpolatorTaps; i++)
+			{
+				// --- distance of the tap from the read position; newest tap first
+				double x = (double)((int)i - newerTaps) - fraction;
+				double sinc = fabs(x) < 1.0e-9 ? 1.0 : sin(kPi * x) / (kPi * x);
+				double window = fabs(x) >= halfWidth ? 0.0 : 0.42 + 0.5*cos(kPi * x / halfWidth) + 0.08*cos(2.0 * kPi * x / halfWidth);
+
+				table[row][i] = sinc * window;
+				sum += table[row][i];
+			}
+
+			for (unsigned int i = 0; i < kMaxInterpolatorTaps; i++)
+				table[row][i] /= sum;
+		}
+	}
+
+	double table[kSincInterpolatorPhases + 1][kMaxInterpolatorTaps];	///< coefficient rows, newest tap first
+};
+
+/**
+@calcInterpolatorCoefficients
+\ingroup FX-Functions
+
+@brief calculate the FIR coefficients of the kLinear, kHermite, kLagrange3 or kSinc interpolator (kNone is a
+single unity coefficient; kThiran is recursive, see doThiranInterpolation( ))
+
+\param type - the interpolator
+\param fraction - distance from the sample at the integer delay toward the next older sample, [0, 1)
+\param coeffs - array to receive getInterpolatorTaps(type) coefficients, newest sample first
+*/
+inline void calcInterpolatorCoefficients(delayInterpolation type, double fraction, double* coeffs)
+{
+	if (type == delayInterpolation::kHermite)
+	{
+		// --- Catmull-Rom spline through the newer sample, the integer delay and the two older samples
+		coeffs[0] = ((-0.5*fraction + 1.0)*fraction - 0.5)*fraction;
+		coeffs[1] = (1.5*fraction - 2.5)*fraction*fraction + 1.0;
+		coeffs[2] = ((-1.5*fraction + 2.0)*fraction + 0.5)*fraction;
+		coeffs[3] = (0.5*fraction - 0.5)*fraction*fraction;
+	}
+	else if (type == delayInterpolation::kLagrange3)
+	{
+		// --- Lagrange polynomial with nodes at -1, 0, 1, 2
+		double fPlusOne = fraction + 1.0;
+		double fMinusOne = fraction - 1.0;
+		double fMinusTwo = fraction - 2.0;
+		coeffs[0] = -fraction*fMinusOne*fMinusTwo / 6.0;
+		coeffs[1] = fPlusOne*fMinusOne*fMinusTwo / 2.0;
+		coeffs[2] = -fPlusOne*fraction*fMinusTwo / 2.0;
+		coeffs[3] = fPlusOne*fraction*fMinusOne / 6.0;
+	}
+	else if (type == delayInterpolation::kSinc)
+		SincInterpolationTable::getInstance().getCoefficients(fraction, coeffs);
+	else if (type == delayInterpolation::kNone)
+		coeffs[0] = 1.0;
+	else
+	{
+		coeffs[0] = 1.0 - fraction;
+		coeffs[1] = fraction;
+	}
+}
+
+/**
+@doFIRInterpolation
+\ingroup FX-Functions
+
+@brief apply interpolator coefficients to a run of samples stored oldest first (the delay line order)
+
+\param newest - the newest sample the interpolator reads; the others are newest[-1], newest[-2], ...
+\param coeffs - the coefficients from calcInterpolatorCoefficients( ), newest sample first
+\param numTaps - number of coefficients
+\return the interpolated value
+*/
+template <typename T>
+inline double doFIRInterpolation(const T* newest, const double* coeffs, unsigned int numTaps)
+{
+	double output = 0.0;
+	for (unsigned int i = 0; i < numTaps; i++)
+		output += coeffs[i] * *(newest - i);
+	return output;
+}
+
+// --- loaders for the vectorized interpolators: double or float storage, double arithmetic
+#if defined FXOBJECTS_AVX
+inline __m256d loadFourAsDouble(const double* source) { return _mm256_loadu_pd(source); }
+inline __m256d loadFourAsDouble(const float* source) { return _mm256_cvtps_pd(_mm_loadu_ps(source)); }
+#endif
+#if defined FXOBJECTS_SSE2
+inline __m128d loadTwoAsDouble(const double* source) { return _mm_loadu_pd(source); }
+inline __m128d loadTwoAsDouble(const float* source) { return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)source))); }
+#endif
+
+/**
+@doFIRInterpolation
+\ingroup FX-Functions
+
+@brief apply one set of interpolator coefficients to a run of consecutive read positions (e.g. a fixed fractional
+delay read over a block); output[i] uses newest[i], newest[i - 1], ... Uses AVX/SSE2 when available; the storage
+may be double or float
+
+\param newest - the newest sample read for output[0]
+\param coeffs - the coefficients from calcInterpolatorCoefficients( ), newest sample first
+\param numTaps - number of coefficients
+\param output - array to receive the interpolated values
+\param length - number of outputs
+*/
+template <typename T>
+inline void doFIRInterpolation(const T* newest, const double* coeffs, unsigned int numTaps, double* output, unsigned int length)
+{
+	unsigned int i = 0;
+
+#if defined FXOBJECTS_AVX
+	for (; i + 4 <= length; i += 4)
+	{
+		__m256d sum = _mm256_setzero_pd();
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+			sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(coeffs[tap]), loadFourAsDouble(newest - tap + i)));
+		_mm256_storeu_pd(&output[i], sum);
+	}
+#endif
+#if defined FXOBJECTS_SSE2
+	for (; i + 2 <= length; i += 2)
+	{
+		__m128d sum = _mm_setzero_pd();
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+			sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(coeffs[tap]), loadTwoAsDouble(newest - tap + i)));
+		_mm_storeu_pd(&output[i], sum);
+	}
+#endif
+	for (; i < length; i++)
+		output[i] = doFIRInterpolation(newest + i, coeffs, numTaps);
+}
+
+/**
+@doThiranInterpolation
+\ingroup FX-Functions
+
+@brief one output of a 1st-order Thiran allpass fractional delay: H(z) = (eta + z^-1)/(1 + eta z^-1),
+eta = (1 - delay)/(1 + delay); accurate and stable for delays in [0.5, 1.5)
+
+\param x0 - the allpass input: the sample at the integer part of the delay
+\param x1 - the previous allpass input: the next older sample
+\param delay - the allpass delay
+\param state - the previous output; updated
+\return the interpolated value
+*/
+inline double doThiranInterpolation(double x0, double x1, double delay, double& state)
+{
+	double eta = (1.0 - delay) / (1.0 + delay);
+	state = eta*(x0 - state) + x1;
+	return state;
+}
+
 
 /**
 @boundValue
@@ -284,6 +718,118 @@ inline double dB2Raw(double dB)
 	return pow(10.0, (dB / 20.0));
 }
 
+/**
+@fastLog2
+\ingroup FX-Functions
+
+@brief fast base-2 log: exponent from the IEEE bits plus a 4-term atanh series on the mantissa, folded into
+[sqrt(0.5), sqrt(2)); max absolute error 4.3e-8 (2.6e-7 dB after scaling to dB)
+
+\param x - value to convert; must be positive and normal (not denormal)
+\return log2(x)
+*/
+inline double fastLog2(double x)
+{
+	uint64_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+
+	// --- split into exponent and mantissa in [1, 2)
+	int exponent = (int)((bits >> 52) & 0x7FF) - 1023;
+	bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+	double mantissa;
+	memcpy(&mantissa, &bits, sizeof(mantissa));
+
+	// --- fold to [sqrt(0.5), sqrt(2)) so the series converges quickly
+	if (mantissa > kSqrtTwo)
+	{
+		mantissa *= 0.5;
+		exponent++;
+	}
+
+	// --- ln(m) = 2*atanh(s), s = (m - 1)/(m + 1)
+	double s = (mantissa - 1.0) / (mantissa + 1.0);
+	double s2 = s*s;
+	double lnMantissa = 2.0*s*(1.0 + s2*(1.0 / 3.0 + s2*(1.0 / 5.0 + s2*(1.0 / 7.0))));
+
+	return exponent + lnMantissa*1.4426950408889634; // 1/ln(2)
+}
+
+/**
+@fastExp2
+\ingroup FX-Functions
+
+@brief fast base-2 exponential: integer part into the IEEE exponent, 6th order Taylor series for the
+fractional part in [-0.5, 0.5]; max relative error 1.7e-7 (1.4e-6 dB)
+
+\param x - exponent; clamped to [-1022, 1023]
+\return 2^x
+*/
+inline double fastExp2(double x)
+{
+	boundValue(x, -1022.0, 1023.0);
+
+	double whole = floor(x + 0.5);
+	double f = (x - whole)*0.69314718055994531; // ln(2)
+	double fractionalPart = 1.0 + f*(1.0 + f*(1.0 / 2.0 + f*(1.0 / 6.0 + f*(1.0 / 24.0 + f*(1.0 / 120.0 + f*(1.0 / 720.0))))));
+
+	uint64_t bits = (uint64_t)((int64_t)whole + 1023) << 52;
+	double wholePart;
+	memcpy(&wholePart, &bits, sizeof(wholePart));
+
+	return fractionalPart*wholePart;
+}
+
+/**
+@fastRaw2dB
+\ingroup FX-Functions
+
+@brief raw2dB( ) using fastLog2( ); error < 3e-7 dB
+
+\param raw - value to convert to dB; must be positive and normal
+\return the dB value
+*/
+inline double fastRaw2dB(double raw)
+{
+	return 6.0205999132796239 * fastLog2(raw); // 20*log10(2)
+}
+
+/**
+@fastdB2Raw
+\ingroup FX-Functions
+
+@brief dB2Raw( ) using fastExp2( ); error < 1.5e-6 dB
+
+\param dB - value to convert to raw
+\return the raw value
+*/
+inline double fastdB2Raw(double dB)
+{
+	return fastExp2(dB * 0.16609640474436813); // log2(10)/20
+}
+
+/**
+@fastTan
+\ingroup FX-Functions
+
+@brief fast tangent for bilinear prewarping, tan(pi*fc/fs): [7/6] Pade approximant on [0, pi/4] and
+tan(x) = 1/tan(pi/2 - x) above that, so there is one division either way; max relative error 7.8e-12
+
+\param x - angle in radians, [0, pi/2)
+\return tan(x)
+*/
+inline double fastTan(double x)
+{
+	bool reflect = x > kPi / 4.0;
+	if (reflect)
+		x = kPi / 2.0 - x;
+
+	double x2 = x*x;
+	double numerator = x*(135135.0 + x2*(-17325.0 + x2*(378.0 - x2)));
+	double denominator = 135135.0 + x2*(-62370.0 + x2*(3150.0 - 28.0*x2));
+
+	return reflect ? denominator / numerator : numerator / denominator;
+}
+
 /**
 @peakGainFor_Q
 \ingroup FX-Functions
@@ -342,22 +888,174 @@ inline double doWhiteNoise()
 	return noise;
 }
 
+const uint64_t kDefaultRandomSeed = 0x2545F4914F6CDD1Dull;	///< seed used by FastRandom until setSeed( ) is called
+
 /**
-@sgn
-\ingroup FX-Functions
+\class FastRandom
+\ingroup FX-Objects
+\brief
+The FastRandom object is a small per-object pseudo random generator (xoshiro128+) for noise, random sample & hold
+and dither. Unlike doWhiteNoise( ) it shares no global state, takes no locks and repeats exactly for a given seed,
+so offline renders are bit-reproducible.
 
-@brief calculates sgn( ) of input
-\param xn - the input value
-\return -1 if xn is negative or +1 if xn is 0 or greater
+Four independent streams run side by side, one per SIMD lane; single draws hand out the four lane outputs in order,
+so fillBipolar( ) and repeated nextBipolar( ) calls produce the same sequence, with or without SSE2.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
 */
-inline double sgn(double xn)
+class FastRandom
 {
-	return (xn > 0) - (xn < 0);
-}
+public:
+	FastRandom(uint64_t seed = kDefaultRandomSeed) { setSeed(seed); }	/* C-TOR */
+	~FastRandom() {}													/* D-TOR */
 
-/**
-@calcWSGain
-\ingroup FX-Functions
+	/** restart the sequence from a seed; the four lane states are expanded from it with splitmix64 */
+	void setSeed(uint64_t seed)
+	{
+		uint64_t x = seed;
+		for (unsigned int lane = 0; lane < 4; lane++)
+		{
+			for (unsigned int word = 0; word < 4; word += 2)
+			{
+				uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				z = z ^ (z >> 31);
+
+				state[word][lane] = (uint32_t)z;
+				state[word + 1][lane] = (uint32_t)(z >> 32);
+			}
+		}
+
+		nextOutput = 4;
+	}
+
+	/** next 32 random bits */
+	inline uint32_t nextUInt32()
+	{
+		if (nextOutput == 4)
+		{
+			step(laneOutput);
+			nextOutput = 0;
+		}
+		return laneOutput[nextOutput++];
+	}
+
+	/** next value on the range [-1.0, +1.0), 24 bit resolution */
+	inline double nextBipolar() { return toBipolar(nextUInt32()); }
+
+	/** fill a block with values on the range [-1.0, +1.0); same sequence as calling nextBipolar( ) length times */
+	/**
+	\param output array to fill
+	\param length number of values
+	*/
+	void fillBipolar(float* output, uint32_t length)
+	{
+		uint32_t i = 0;
+
+		// --- use up the lane outputs already drawn
+		while (nextOutput < 4 && i < length)
+			output[i++] = toBipolar(laneOutput[nextOutput++]);
+
+#if defined FXOBJECTS_SSE2
+		if (i + 4 <= length)
+		{
+			__m128i s0 = _mm_load_si128((const __m128i*)state[0]);
+			__m128i s1 = _mm_load_si128((const __m128i*)state[1]);
+			__m128i s2 = _mm_load_si128((const __m128i*)state[2]);
+			__m128i s3 = _mm_load_si128((const __m128i*)state[3]);
+			const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+			const __m128 one = _mm_set1_ps(1.0f);
+
+			for (; i + 4 <= length; i += 4)
+			{
+				__m128i result = _mm_add_epi32(s0, s3);
+				__m128i t = _mm_slli_epi32(s1, 9);
+
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, t);
+				s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+				__m128 value = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+				_mm_storeu_ps(&output[i], _mm_sub_ps(_mm_mul_ps(value, scale), one));
+			}
+
+			_mm_store_si128((__m128i*)state[0], s0);
+			_mm_store_si128((__m128i*)state[1], s1);
+			_mm_store_si128((__m128i*)state[2], s2);
+			_mm_store_si128((__m128i*)state[3], s3);
+		}
+#endif
+		for (; i + 4 <= length; i += 4)
+		{
+			uint32_t result[4];
+			step(result);
+			for (unsigned int lane = 0; lane < 4; lane++)
+				output[i + lane] = toBipolar(result[lane]);
+		}
+
+		for (; i < length; i++)
+			output[i] = toBipolar(nextUInt32());
+	}
+
+private:
+	/** advance all four lanes one step */
+	inline void step(uint32_t* result)
+	{
+		for (unsigned int lane = 0; lane < 4; lane++)
+		{
+			uint32_t s0 = state[0][lane];
+			uint32_t s1 = state[1][lane];
+			uint32_t s2 = state[2][lane];
+			uint32_t s3 = state[3][lane];
+
+			result[lane] = s0 + s3;
+			uint32_t t = s1 << 9;
+
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = (s3 << 11) | (s3 >> 21);
+
+			state[0][lane] = s0;
+			state[1][lane] = s1;
+			state[2][lane] = s2;
+			state[3][lane] = s3;
+		}
+	}
+
+	/** top 24 bits to [-1.0, +1.0); exact in float, so the SIMD and scalar paths agree bit for bit */
+	static inline float toBipolar(uint32_t x) { return (float)(x >> 8) * (1.0f / 8388608.0f) - 1.0f; }
+
+	alignas(16) uint32_t state[4][4];	///< xoshiro128+ state [word][lane]
+	uint32_t laneOutput[4] = { 0 };		///< lane outputs of the last step
+	unsigned int nextOutput = 4;		///< next unused entry of laneOutput[ ]
+};
+
+/**
+@sgn
+\ingroup FX-Functions
+
+@brief calculates sgn( ) of input
+\param xn - the input value
+\return -1 if xn is negative or +1 if xn is 0 or greater
+*/
+inline double sgn(double xn)
+{
+	return (xn > 0) - (xn < 0);
+}
+
+/**
+@calcWSGain
+\ingroup FX-Functions
 
 @brief calculates gain of a waveshaper
 \param xn - the input value
@@ -1200,6 +1898,19 @@ public:
 		// --- do nothing
 		return false; // NOT handled
 	}
+
+	/** for processing whole blocks of non-interleaved audio in one call
+	--- optional processing function
+		inputs[channel][frame] and outputs[channel][frame] carry numChannels of numFrames samples each;
+		objects that do not implement this return false so the caller can fall back to frame processing */
+	virtual bool processAudioBlock(const float* const* /*inputs*/,
+								   float* const* /*outputs*/,
+								   uint32_t /*numFrames*/,
+								   uint32_t /*numChannels*/)
+	{
+		// --- do nothing
+		return false; // NOT handled
+	}
 };
 
 /**
@@ -1252,6 +1963,45 @@ public:
 	virtual const SignalGenData renderAudioOutput() = 0;
 };
 
+/**
+\enum modulatorOutput
+\ingroup Constants-Enums
+\brief
+Index of each output of a modulation source. Consumers subscribe to outputs with a mask of (1 << modulatorOutput) bits,
+see modulatorOutputMask( ), so that sources do not render outputs that no one reads.
+
+- enum modulatorOutput { kModNormal, kModInverted, kModQuadPhasePos, kModQuadPhaseNeg, kNumModulatorOutputs };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum modulatorOutput { kModNormal, kModInverted, kModQuadPhasePos, kModQuadPhaseNeg, kNumModulatorOutputs };
+
+/** mask bit for subscribing to one modulatorOutput */
+inline uint32_t modulatorOutputMask(modulatorOutput output) { return 1u << output; }
+
+/**
+\class IModulationSource
+\ingroup Interfaces
+\brief
+Use this interface for modulation sources (LFOs, envelope detectors) that can be evaluated at control rate
+by the ControlRateModulator.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class IModulationSource
+{
+public:
+	/** render the outputs selected by outputMask at the current position into values[kNumModulatorOutputs], then
+	    move the source hopSize samples ahead; outputs not in the mask need not be rendered */
+	virtual void renderControlPoint(uint32_t hopSize, uint32_t outputMask, double* values) = 0;
+};
+
 
 
 // ------------------------------------------------------------------ //
@@ -1353,6 +2103,111 @@ struct BiquadParameters
 	biquadAlgorithm biquadCalcType = biquadAlgorithm::kDirect; ///< biquad structure to use
 };
 
+/**
+@processBiquadBlock
+\ingroup FX-Functions
+
+@brief run a block of samples through one biquad structure that is fixed at compile time
+
+- NOTES:\n
+the per-sample arithmetic is identical to Biquad::processAudioSample( ) but the structure test is hoisted out of the
+loop and the z^-1 registers live in locals for the whole block; the underflow check is done once, on the states left
+at the end of the block, rather than on every output\n
+with the wetDry flag set the output is x(n)*dry + y(n)*wet, the AudioFilter combination; input may alias output\n
+
+\param coeffArray - the biquad coefficients (a0, a1, a2, b1, b2, ...)
+\param stateArray - the z^-1 registers; read at the start and written back at the end of the block
+\param storageComponent - receives the Harma storage value S of the last sample
+\param input - numSamples input samples
+\param output - numSamples output samples
+\param numSamples - block length
+\param wet - gain on y(n), only used with wetDry
+\param dry - gain on x(n), only used with wetDry
+*/
+template <biquadAlgorithm algorithm, bool wetDry, typename InputType, typename OutputType>
+inline void processBiquadBlock(const double* coeffArray, double* stateArray, double& storageComponent,
+							   const InputType* input, OutputType* output, uint32_t numSamples,
+							   double wet = 1.0, double dry = 0.0)
+{
+	const double A0 = coeffArray[a0];
+	const double A1 = coeffArray[a1];
+	const double A2 = coeffArray[a2];
+	const double B1 = coeffArray[b1];
+	const double B2 = coeffArray[b2];
+
+	double xz1 = stateArray[x_z1];
+	double xz2 = stateArray[x_z2];
+	double yz1 = stateArray[y_z1];
+	double yz2 = stateArray[y_z2];
+	double storage = storageComponent;
+
+	for (uint32_t i = 0; i < numSamples; i++)
+	{
+		const double xn = input[i];
+		double yn = 0.0;
+
+		// --- the template argument is a constant: the compiler keeps exactly one of these branches
+		if (algorithm == biquadAlgorithm::kDirect)
+		{
+			storage = A1 * xz1 + A2 * xz2 - B1 * yz1 - B2 * yz2;
+			yn = A0 * xn + storage;
+
+			xz2 = xz1;
+			xz1 = xn;
+			yz2 = yz1;
+			yz1 = yn;
+		}
+		else if (algorithm == biquadAlgorithm::kCanonical)
+		{
+			const double wn = xn - B1 * xz1 - B2 * xz2;
+			yn = A0 * wn + A1 * xz1 + A2 * xz2;
+
+			xz2 = xz1;
+			xz1 = wn;
+		}
+		else if (algorithm == biquadAlgorithm::kTransposeDirect)
+		{
+			const double wn = xn + yz1;
+			yn = A0 * wn + xz1;
+
+			yz1 = yz2 - B1 * wn;
+			yz2 = -B2 * wn;
+			xz1 = xz2 + A1 * wn;
+			xz2 = A2 * wn;
+		}
+		else // --- kTransposeCanonical
+		{
+			storage = xz1;
+			yn = A0 * xn + storage;
+
+			xz1 = A1 * xn - B1 * yn + xz2;
+			xz2 = A2 * xn - B2 * yn;
+		}
+
+		if (wetDry)
+			output[i] = (OutputType)(dry * xn + wet * yn);
+		else
+			output[i] = (OutputType)yn;
+	}
+
+	// --- underflow check, once per block: a decayed tail is flushed to zero before the next block starts
+	checkFloatUnderflow(xz1);
+	checkFloatUnderflow(xz2);
+	checkFloatUnderflow(yz1);
+	checkFloatUnderflow(yz2);
+
+	stateArray[x_z1] = xz1;
+	stateArray[x_z2] = xz2;
+	stateArray[y_z1] = yz1;
+	stateArray[y_z2] = yz2;
+
+	// --- only the direct and transposed canonical forms have an S value
+	if (algorithm == biquadAlgorithm::kDirect || algorithm == biquadAlgorithm::kTransposeCanonical)
+		storageComponent = storage;
+	else
+		storageComponent = 0.0;
+}
+
 /**
 \class Biquad
 \ingroup FX-Objects
@@ -1395,6 +2250,45 @@ public:
 	*/
 	virtual double processAudioSample(double xn);
 
+	/** process a block of samples; the structure is resolved once per block, see processBiquadBlock( ) */
+	/**
+	\param input numSamples input samples (may be the same buffer as output)
+	\param output numSamples output samples
+	\param numSamples block length
+	*/
+	template <typename InputType, typename OutputType>
+	void processAudioSamples(const InputType* input, OutputType* output, uint32_t numSamples)
+	{
+		processBlock<false>(input, output, numSamples, 1.0, 0.0);
+	}
+
+	/** process a block of samples and mix the result as x(n)*dry + y(n)*wet; used by AudioFilter for its c0 and d0 coefficients */
+	/**
+	\param input numSamples input samples (may be the same buffer as output)
+	\param output numSamples output samples
+	\param numSamples block length
+	\param wet gain on the biquad output y(n)
+	\param dry gain on the input x(n)
+	*/
+	template <typename InputType, typename OutputType>
+	void processAudioSamples(const InputType* input, OutputType* output, uint32_t numSamples, double wet, double dry)
+	{
+		processBlock<true>(input, output, numSamples, wet, dry);
+	}
+
+	/** process a mono block; returns false for more than one channel since there is only one set of states */
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		if (numChannels != 1)
+			return false; // NOT handled
+
+		processAudioSamples(inputs[0], outputs[0], numFrames);
+		return true;
+	}
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
 	\return BiquadParameters custom data structure
@@ -1446,6 +2340,27 @@ protected:
 
 	/** for Harma loop resolution */
 	double storageComponent = 0.0;
+
+	/** dispatch a block to the processBiquadBlock( ) kernel for the current structure */
+	template <bool wetDry, typename InputType, typename OutputType>
+	void processBlock(const InputType* input, OutputType* output, uint32_t numSamples, double wet, double dry)
+	{
+		switch (parameters.biquadCalcType)
+		{
+			case biquadAlgorithm::kDirect:
+				processBiquadBlock<biquadAlgorithm::kDirect, wetDry>(coeffArray, stateArray, storageComponent, input, output, numSamples, wet, dry);
+				break;
+			case biquadAlgorithm::kCanonical:
+				processBiquadBlock<biquadAlgorithm::kCanonical, wetDry>(coeffArray, stateArray, storageComponent, input, output, numSamples, wet, dry);
+				break;
+			case biquadAlgorithm::kTransposeDirect:
+				processBiquadBlock<biquadAlgorithm::kTransposeDirect, wetDry>(coeffArray, stateArray, storageComponent, input, output, numSamples, wet, dry);
+				break;
+			case biquadAlgorithm::kTransposeCanonical:
+				processBiquadBlock<biquadAlgorithm::kTransposeCanonical, wetDry>(coeffArray, stateArray, storageComponent, input, output, numSamples, wet, dry);
+				break;
+		}
+	}
 };
 
 
@@ -1548,6 +2463,33 @@ public:
 	*/
 	virtual double processAudioSample(double xn);
 
+	/** process a block of samples through the filter; same result as processAudioSample( ) on each sample except
+	    that the underflow check is done once per block */
+	/**
+	\param input numSamples input samples (may be the same buffer as output)
+	\param output numSamples output samples
+	\param numSamples block length
+	*/
+	template <typename InputType, typename OutputType>
+	void processAudioSamples(const InputType* input, OutputType* output, uint32_t numSamples)
+	{
+		// --- return (dry) + (processed): x(n)*d0 + y(n)*c0
+		biquad.processAudioSamples(input, output, numSamples, coeffArray[c0], coeffArray[d0]);
+	}
+
+	/** process a mono block; returns false for more than one channel since there is only one filter */
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		if (numChannels != 1)
+			return false; // NOT handled
+
+		processAudioSamples(inputs[0], outputs[0], numFrames);
+		return true;
+	}
+
 	/** --- sample rate change necessarily requires recalculation */
 	virtual void setSampleRate(double _sampleRate)
 	{
@@ -1586,6 +2528,12 @@ public:
 	/** --- helper for Harma filters (phaser) */
 	double getS_value() { return biquad.getS_value(); }
 
+	/** --- change only fc; for audio-rate modulation, see fxobjects.cpp */
+	void setFcFast(double fc);
+
+	/** --- the cooked coefficients (a0, a1, a2, b1, b2, c0, d0), e.g. to load a BiquadBank lane */
+	const double* getCoefficients() { return &coeffArray[0]; }
+
 protected:
 	// --- our calculator
 	Biquad biquad; ///< the biquad object
@@ -1599,799 +2547,2777 @@ protected:
 
 	/** --- function to recalculate coefficients due to a change in filter parameters */
 	bool calculateFilterCoeffs();
-};
-
-
-/**
-\struct FilterBankOutput
-\ingroup FX-Objects
-\brief
-Custom output structure for filter bank objects that split the inptu into multiple frequency channels (bands)
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-// --- output for filter bank requires multiple channels (bands)
-struct FilterBankOutput
-{
-	FilterBankOutput() {}
-
-	// --- band-split filter output
-	double LFOut = 0.0; ///< low frequency output sample
-	double HFOut = 0.0;	///< high frequency output sample
-
-	// --- add more filter channels here; or use an array[]
-};
-
 
-/**
-\struct LRFilterBankParameters
-\ingroup FX-Objects
-\brief
-Custom parameter structure for the LRFilterBank object which splits the input signal into multiple bands.
-The stock obejct splits into low and high frequency bands so this structure only requires one split point - add more
-split frequencies to support more bands.
+	/** --- coefficients of the designs that depend on fc only through K = tan(pi*fc/fs) */
+	bool calculatePrewarpedCoeffs(double K);
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct LRFilterBankParameters
-{
-	LRFilterBankParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	LRFilterBankParameters& operator=(const LRFilterBankParameters& params)	// need this override for collections to work
+	/** --- true if the current algorithm is one of the calculatePrewarpedCoeffs( ) designs */
+	bool hasPrewarpedCoeffs()
 	{
-		if (this == &params)
-			return *this;
-		splitFrequency = params.splitFrequency;
-		return *this;
+		filterAlgorithm algorithm = audioFilterParameters.algorithm;
+		return algorithm == filterAlgorithm::kBPF2 || algorithm == filterAlgorithm::kBSF2 ||
+			algorithm == filterAlgorithm::kButterLPF2 || algorithm == filterAlgorithm::kButterHPF2 ||
+			algorithm == filterAlgorithm::kLowShelf || algorithm == filterAlgorithm::kHiShelf ||
+			algorithm == filterAlgorithm::kCQParaEQ || algorithm == filterAlgorithm::kLWRLPF2 ||
+			algorithm == filterAlgorithm::kLWRHPF2 || algorithm == filterAlgorithm::kAPF1;
 	}
 
-	// --- individual parameters
-	double splitFrequency = 1000.0; ///< LF/HF split frequency
+	double boostCutGain = 1.0; ///< pow(10, boostCut_dB/20) of the last full calculation, reused by setFcFast( )
 };
 
 
+// --- number of lanes in a BiquadBank: 8 channels of a surround bus or 8 stages of a cascade
+const unsigned int kMaxBiquadBankLanes = 8;
+
 /**
-\class LRFilterBank
+\class BiquadBank
 \ingroup FX-Objects
 \brief
-The LRFilterBank object implements 2 Linkwitz-Riley Filters in a parallel filter bank to split the signal into two frequency bands.
-Note that one channel is inverted (see the FX book below for explanation). You can add more bands here as well.
+The BiquadBank object runs up to kMaxBiquadBankLanes AudioFilter biquads side by side, with the coefficients and
+states stored structure-of-arrays (one row per coefficient or state, one column per lane) so that the lanes are
+processed together in AVX or SSE2 registers. Each lane computes exactly what AudioFilter::processAudioSample( )
+computes: the direct form biquad with the per-sample underflow check, followed by the c0/d0 wet/dry mix.
+
+The lanes can be used in two ways:
+- parallel: every lane has its own input, e.g. the channels of a bus or the bands of a filter bank
+- cascade: lane 0 feeds lane 1 and so on; the block version interleaves the stages so that stage k works on sample
+  n - k while stage 0 works on sample n, which keeps all of the stages busy without changing the result
 
 Audio I/O:
-- Processes mono input into a custom FilterBankOutput structure.
-NOTE: processAudioSample( ) is inoperable and only returns the input back.
+- Processes numLanes channels in parallel, or mono input to mono output through the cascade.
 
 Control I/F:
-- Use LRFilterBankParameters structure to get/set object params.
+- Use setNumLanes( ) and setCoefficients( ); the coefficients are the cooked AudioFilter arrays, see AudioFilter::getCoefficients( )
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class LRFilterBank : public IAudioSignalProcessor
+class BiquadBank
 {
 public:
-	LRFilterBank()		/* C-TOR */
-	{
-		// --- set filters as Linkwitz-Riley 2nd order
-		AudioFilterParameters params = lpFilter.getParameters();
-		params.algorithm = filterAlgorithm::kLWRLPF2;
-		lpFilter.setParameters(params);
+	BiquadBank() {}		/* C-TOR */
+	~BiquadBank() {}	/* D-TOR */
 
-		params = hpFilter.getParameters();
-		params.algorithm = filterAlgorithm::kLWRHPF2;
-		hpFilter.setParameters(params);
+	/** flush the z^-1 registers of all lanes */
+	void reset()
+	{
+		memset(&stateArray[0][0], 0, sizeof(stateArray));
+		memset(&storageComponent[0], 0, sizeof(storageComponent));
 	}
 
-	~LRFilterBank() {}	/* D-TOR */
-
-	/** reset member objects */
-	virtual bool reset(double _sampleRate)
+	/** set the number of lanes in use, 1 to kMaxBiquadBankLanes */
+	void setNumLanes(unsigned int _numLanes)
 	{
-		lpFilter.reset(_sampleRate);
-		hpFilter.reset(_sampleRate);
-		return true;
+		numLanes = _numLanes < 1 ? 1 : (_numLanes > kMaxBiquadBankLanes ? kMaxBiquadBankLanes : _numLanes);
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+	/** get the number of lanes in use */
+	unsigned int getNumLanes() { return numLanes; }
 
-	/** this does nothing for this object, see processFilterBank( ) below */
+	/** load the coefficients (a0, a1, a2, b1, b2, c0, d0) of one lane */
 	/**
-	\param xn input
-	\return the processed sample
+	\param lane the lane to load
+	\param coeffs numCoeffs cooked coefficients, e.g. from AudioFilter::getCoefficients( )
 	*/
-	virtual double processAudioSample(double xn)
+	void setCoefficients(unsigned int lane, const double* coeffs)
 	{
-		return xn;
+		for (unsigned int i = 0; i < numCoeffs; i++)
+			coeffArray[i][lane] = coeffs[i];
 	}
 
-	/** process the filter bank */
-	FilterBankOutput processFilterBank(double xn)
+	/** load the same coefficients into every lane in use, for N channels of the same filter */
+	void setCoefficients(const double* coeffs)
 	{
-		FilterBankOutput output;
+		for (unsigned int lane = 0; lane < numLanes; lane++)
+			setCoefficients(lane, coeffs);
+	}
 
-		// --- process the LPF
-		output.LFOut = lpFilter.processAudioSample(xn);
+	/** get the structure G (gain) value of a lane for Harma filters; see AudioFilter::getG_value( ) */
+	double getG_value(unsigned int lane) { return coeffArray[a0][lane]; }
 
-		// --- invert the HP filter output so that recombination will
-		//     result in the correct phase and magnitude responses
-		output.HFOut = -hpFilter.processAudioSample(xn);
+	/** get the structure S (storage) value of a lane for Harma filters; see AudioFilter::getS_value( ) */
+	double getS_value(unsigned int lane) { return storageComponent[lane]; }
 
-		return output;
+	/** process one sample through one lane */
+	/**
+	\param lane the lane
+	\param xn the lane input
+	\return the lane output
+	*/
+	double processLane(unsigned int lane, double xn)
+	{
+		double storage = coeffArray[a1][lane] * stateArray[x_z1][lane] +
+						 coeffArray[a2][lane] * stateArray[x_z2][lane] -
+						 coeffArray[b1][lane] * stateArray[y_z1][lane] -
+						 coeffArray[b2][lane] * stateArray[y_z2][lane];
+
+		double yn = coeffArray[a0][lane] * xn + storage;
+		checkFloatUnderflow(yn);
+
+		stateArray[x_z2][lane] = stateArray[x_z1][lane];
+		stateArray[x_z1][lane] = xn;
+		stateArray[y_z2][lane] = stateArray[y_z1][lane];
+		stateArray[y_z1][lane] = yn;
+		storageComponent[lane] = storage;
+
+		return coeffArray[d0][lane] * xn + coeffArray[c0][lane] * yn;
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
+	/** process one sample through every lane in parallel */
 	/**
-	\return LRFilterBankParameters custom data structure
+	\param input numLanes inputs, one per lane
+	\param output numLanes outputs, one per lane (may be the same array as input)
 	*/
-	LRFilterBankParameters getParameters()
+	void processLanes(const double* input, double* output)
 	{
-		return parameters;
+		unsigned int lane = 0;
+#if defined FXOBJECTS_AVX
+		for (; lane + 4 <= numLanes; lane += 4)
+			_mm256_storeu_pd(output + lane, processLanesAVX(lane, _mm256_loadu_pd(input + lane)));
+#endif
+#if defined FXOBJECTS_SSE2
+		for (; lane + 2 <= numLanes; lane += 2)
+			_mm_storeu_pd(output + lane, processLanesSSE2(lane, _mm_loadu_pd(input + lane)));
+#endif
+		for (; lane < numLanes; lane++)
+			output[lane] = processLane(lane, input[lane]);
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** process one sample through the lanes in series, lane 0 first */
 	/**
-	\param LRFilterBankParameters custom data structure
+	\param xn the cascade input
+	\return the output of the last lane
 	*/
-	void setParameters(const LRFilterBankParameters& _parameters)
+	double processCascade(double xn)
 	{
-		// --- update structure
-		parameters = _parameters;
+		for (unsigned int lane = 0; lane < numLanes; lane++)
+			xn = processLane(lane, xn);
+		return xn;
+	}
 
-		// --- update member objects
-		AudioFilterParameters params = lpFilter.getParameters();
-		params.fc = parameters.splitFrequency;
-		lpFilter.setParameters(params);
+	/** process a block through the lanes in series with the stages interleaved: lane k works on sample n - k while
+	    lane 0 works on sample n, so that once the pipeline is full every step runs all of the lanes at once with the
+	    states and the pipeline held in registers. Same result as processCascade( ) on each sample. */
+	/**
+	\param input numSamples input samples
+	\param output numSamples output samples (may be the same buffer as input)
+	\param numSamples block length
+	*/
+	template <typename InputType, typename OutputType>
+	void processCascadeBlock(const InputType* input, OutputType* output, uint32_t numSamples)
+	{
+		const unsigned int last = numLanes - 1;
 
-		params = hpFilter.getParameters();
-		params.fc = parameters.splitFrequency;
-		hpFilter.setParameters(params);
+		// --- pipe[k] is the next input for lane k
+		double pipe[kMaxBiquadBankLanes] = { 0.0 };
+
+		// --- short blocks never fill the pipeline
+		if (numSamples <= last)
+		{
+			for (uint32_t step = 0; step < numSamples + last; step++)
+				cascadeStep(step, input, output, numSamples, pipe);
+			return;
+		}
+
+		// --- fill
+		for (uint32_t step = 0; step < last; step++)
+			cascadeStep(step, input, output, numSamples, pipe);
+
+		// --- steady state, all lanes busy: the last lane finishes sample n - last in step n
+		//     NOTE: input[n] is always read before output[n - last] is written, so input may alias output
+#if defined FXOBJECTS_AVX
+		if (numLanes > 4)
+			cascadeSteadyAVX<2>(input, output, numSamples, pipe);
+		else
+			cascadeSteadyAVX<1>(input, output, numSamples, pipe);
+#elif defined FXOBJECTS_SSE2
+		if (numLanes > 6)
+			cascadeSteadySSE2<4>(input, output, numSamples, pipe);
+		else if (numLanes > 4)
+			cascadeSteadySSE2<3>(input, output, numSamples, pipe);
+		else if (numLanes > 2)
+			cascadeSteadySSE2<2>(input, output, numSamples, pipe);
+		else
+			cascadeSteadySSE2<1>(input, output, numSamples, pipe);
+#else
+		double outputs[kMaxBiquadBankLanes];
+		for (uint32_t n = last; n < numSamples; n++)
+		{
+			pipe[0] = input[n];
+			processLanes(pipe, outputs);
+			output[n - last] = (OutputType)outputs[last];
+			for (unsigned int lane = 0; lane < last; lane++)
+				pipe[lane + 1] = outputs[lane];
+		}
+#endif
+
+		// --- drain
+		for (uint32_t step = numSamples; step < numSamples + last; step++)
+			cascadeStep(step, input, output, numSamples, pipe);
 	}
 
-protected:
-	AudioFilter lpFilter; ///< low-band filter
-	AudioFilter hpFilter; ///< high-band filter
+	/** process a block of numChannels channels, one lane per channel; each group of lanes keeps its states in registers
+	    for the whole block */
+	/**
+	\param inputs inputs[channel][frame]
+	\param outputs outputs[channel][frame] (may be the same buffers as inputs)
+	\param numFrames block length
+	\param numChannels channel count, at most numLanes
+	\return false if there are more channels than lanes
+	*/
+	template <typename InputType, typename OutputType>
+	bool processChannels(const InputType* const* inputs, OutputType* const* outputs, uint32_t numFrames, uint32_t numChannels)
+	{
+		if (numChannels > numLanes)
+			return false;
 
-	// --- object parameters
-	LRFilterBankParameters parameters; ///< parameters for the object
-};
+		unsigned int lane = 0;
+#if defined FXOBJECTS_AVX
+		for (; lane + 4 <= numChannels; lane += 4)
+		{
+			__m256d coeffs[numCoeffs];
+			__m256d states[numStates];
+			__m256d storage = _mm256_loadu_pd(&storageComponent[lane]);
+			loadLanesAVX(lane, coeffs, states);
 
-// --- constants
-const unsigned int TLD_AUDIO_DETECT_MODE_PEAK = 0;
-const unsigned int TLD_AUDIO_DETECT_MODE_MS = 1;
-const unsigned int TLD_AUDIO_DETECT_MODE_RMS = 2;
-const double TLD_AUDIO_ENVELOPE_ANALOG_TC = -0.99967234081320612357829304641019; // ln(36.7%)
+			for (uint32_t i = 0; i < numFrames; i++)
+			{
+				double laneOut[4];
+				__m256d xn = _mm256_set_pd(inputs[lane + 3][i], inputs[lane + 2][i], inputs[lane + 1][i], inputs[lane][i]);
+				_mm256_storeu_pd(laneOut, biquadLanesAVX(coeffs, states, storage, xn));
+				for (unsigned int j = 0; j < 4; j++)
+					outputs[lane + j][i] = (OutputType)laneOut[j];
+			}
 
-/**
-\struct AudioDetectorParameters
-\ingroup FX-Objects
-\brief
-Custom parameter structure for the AudioDetector object. NOTE: this object uses constant defintions:
+			storeLanesAVX(lane, states, storage);
+		}
+#endif
+#if defined FXOBJECTS_SSE2
+		for (; lane + 2 <= numChannels; lane += 2)
+		{
+			__m128d coeffs[numCoeffs];
+			__m128d states[numStates];
+			__m128d storage = _mm_loadu_pd(&storageComponent[lane]);
+			loadLanesSSE2(lane, coeffs, states);
 
-- const unsigned int TLD_AUDIO_DETECT_MODE_PEAK = 0;
-- const unsigned int TLD_AUDIO_DETECT_MODE_MS = 1;
-- const unsigned int TLD_AUDIO_DETECT_MODE_RMS = 2;
-- const double TLD_AUDIO_ENVELOPE_ANALOG_TC = -0.99967234081320612357829304641019; // ln(36.7%)
+			for (uint32_t i = 0; i < numFrames; i++)
+			{
+				double laneOut[2];
+				__m128d xn = _mm_set_pd(inputs[lane + 1][i], inputs[lane][i]);
+				_mm_storeu_pd(laneOut, biquadLanesSSE2(coeffs, states, storage, xn));
+				outputs[lane][i] = (OutputType)laneOut[0];
+				outputs[lane + 1][i] = (OutputType)laneOut[1];
+			}
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-struct AudioDetectorParameters
-{
-	AudioDetectorParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	AudioDetectorParameters& operator=(const AudioDetectorParameters& params)	// need this override for collections to work
-	{
-		if (this == &params)
-			return *this;
-		attackTime_mSec = params.attackTime_mSec;
-		releaseTime_mSec = params.releaseTime_mSec;
-		detectMode = params.detectMode;
-		detect_dB = params.detect_dB;
-		clampToUnityMax = params.clampToUnityMax;
-		return *this;
+			storeLanesSSE2(lane, states, storage);
+		}
+#endif
+		for (; lane < numChannels; lane++)
+		{
+			for (uint32_t i = 0; i < numFrames; i++)
+				outputs[lane][i] = (OutputType)processLane(lane, inputs[lane][i]);
+		}
+		return true;
 	}
 
-	// --- individual parameters
-	double attackTime_mSec = 0.0; ///< attack time in milliseconds
-	double releaseTime_mSec = 0.0;///< release time in milliseconds
-	unsigned int  detectMode = 0;///< detect mode, see TLD_ constants above
-	bool detect_dB = false;	///< detect in dB  DEFAULT  = false (linear NOT log)
-	bool clampToUnityMax = true;///< clamp output to 1.0 (set false for true log detectors)
-};
-
-/**
-\class AudioDetector
-\ingroup FX-Objects
-\brief
-The AudioDetector object implements the audio detector defined in the book source below.
-NOTE: this detector can receive signals and transmit detection values that are both > 0dBFS
+protected:
+	double coeffArray[numCoeffs][kMaxBiquadBankLanes] = { { 0.0 } };	///< coefficients, coeffArray[coefficient][lane]
+	double stateArray[numStates][kMaxBiquadBankLanes] = { { 0.0 } };	///< z^-1 registers, stateArray[state][lane]
+	double storageComponent[kMaxBiquadBankLanes] = { 0.0 };			///< Harma S value of each lane
+	unsigned int numLanes = 1;											///< lanes in use
 
-Audio I/O:
-- Processes mono input to a detected signal output.
+	/** one step of processCascadeBlock( ) while the pipeline fills or drains: only lanes [first, end] have a sample */
+	template <typename InputType, typename OutputType>
+	void cascadeStep(uint32_t step, const InputType* input, OutputType* output, uint32_t numSamples, double* pipe)
+	{
+		const unsigned int last = numLanes - 1;
+		const unsigned int first = step < numSamples ? 0 : step - numSamples + 1;
+		const unsigned int end = step < last ? step : last;
 
-Control I/F:
-- Use AudioDetectorParameters structure to get/set object params.
+		if (step < numSamples)
+			pipe[0] = input[step];
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-class AudioDetector : public IAudioSignalProcessor
-{
-public:
-	AudioDetector() {}	/* C-TOR */
-	~AudioDetector() {}	/* D-TOR */
+		// --- run the lanes from the back so that each lane's output moves into a pipe slot that has been consumed
+		for (int lane = (int)end; lane >= (int)first; lane--)
+		{
+			double yn = processLane(lane, pipe[lane]);
+			if (lane == (int)last)
+				output[step - last] = (OutputType)yn;
+			else
+				pipe[lane + 1] = yn;
+		}
+	}
 
-public:
-	/** set sample rate dependent time constants and clear last envelope output value */
-	virtual bool reset(double _sampleRate)
+#if defined FXOBJECTS_AVX
+	/** load the coefficients and states of lanes [lane, lane + 4) into registers */
+	inline void loadLanesAVX(unsigned int lane, __m256d* coeffs, __m256d* states)
 	{
-		setSampleRate(_sampleRate);
-		lastEnvelope = 0.0;
-		return true;
+		for (unsigned int i = 0; i < numCoeffs; i++)
+			coeffs[i] = _mm256_loadu_pd(&coeffArray[i][lane]);
+		for (unsigned int i = 0; i < numStates; i++)
+			states[i] = _mm256_loadu_pd(&stateArray[i][lane]);
 	}
 
-	/** return false: this object only processes samples */
-	virtual bool canProcessAudioFrame() { return false; }
+	/** write back the states of lanes [lane, lane + 4) */
+	inline void storeLanesAVX(unsigned int lane, const __m256d* states, __m256d storage)
+	{
+		for (unsigned int i = 0; i < numStates; i++)
+			_mm256_storeu_pd(&stateArray[i][lane], states[i]);
+		_mm256_storeu_pd(&storageComponent[lane], storage);
+	}
 
-	// --- process audio: detect the log envelope and return it in dB
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+	/** processLane( ) on four lanes held in registers */
+	static inline __m256d biquadLanesAVX(const __m256d* coeffs, __m256d* states, __m256d& storage, __m256d xn)
 	{
-		// --- all modes do Full Wave Rectification
-		double input = fabs(xn);
+		storage = _mm256_sub_pd(_mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(coeffs[a1], states[x_z1]),
+															_mm256_mul_pd(coeffs[a2], states[x_z2])),
+											  _mm256_mul_pd(coeffs[b1], states[y_z1])),
+								_mm256_mul_pd(coeffs[b2], states[y_z2]));
+		__m256d yn = _mm256_add_pd(_mm256_mul_pd(coeffs[a0], xn), storage);
 
-		// --- square it for MS and RMS
-		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_MS ||
-			audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
-			input *= input;
+		// --- underflow check: zero the non-zero values with magnitude below kSmallestPositiveFloatValue
+		const __m256d absYn = _mm256_andnot_pd(_mm256_set1_pd(-0.0), yn);
+		const __m256d underflow = _mm256_and_pd(_mm256_cmp_pd(absYn, _mm256_set1_pd(kSmallestPositiveFloatValue), _CMP_LT_OQ),
+												_mm256_cmp_pd(yn, _mm256_setzero_pd(), _CMP_NEQ_OQ));
+		yn = _mm256_andnot_pd(underflow, yn);
 
-		// --- to store current
-		double currEnvelope = 0.0;
+		states[x_z2] = states[x_z1];
+		states[x_z1] = xn;
+		states[y_z2] = states[y_z1];
+		states[y_z1] = yn;
 
-		// --- do the detection with attack or release applied
-		if (input > lastEnvelope)
-			currEnvelope = attackTime * (lastEnvelope - input) + input;
-		else
-			currEnvelope = releaseTime * (lastEnvelope - input) + input;
+		return _mm256_add_pd(_mm256_mul_pd(coeffs[d0], xn), _mm256_mul_pd(coeffs[c0], yn));
+	}
 
-		// --- we are recursive so need to check underflow
-		checkFloatUnderflow(currEnvelope);
+	/** processLane( ) for lanes [lane, lane + 4) */
+	inline __m256d processLanesAVX(unsigned int lane, __m256d xn)
+	{
+		__m256d coeffs[numCoeffs];
+		__m256d states[numStates];
+		__m256d storage;
+		loadLanesAVX(lane, coeffs, states);
+		__m256d output = biquadLanesAVX(coeffs, states, storage, xn);
+		storeLanesAVX(lane, states, storage);
+		return output;
+	}
 
-		// --- bound them; can happen when using pre-detector gains of more than 1.0
-		if (audioDetectorParameters.clampToUnityMax)
-			currEnvelope = fmin(currEnvelope, 1.0);
+	/** the steady state of processCascadeBlock( ): the cascade in numVectors registers of 4 lanes; lanes above the last
+	    one in use are computed but never written back */
+	template <unsigned int numVectors, typename InputType, typename OutputType>
+	void cascadeSteadyAVX(const InputType* input, OutputType* output, uint32_t numSamples, double* pipe)
+	{
+		const unsigned int last = numLanes - 1;
+		__m256d coeffs[numVectors][numCoeffs];
+		__m256d states[numVectors][numStates];
+		__m256d storage[numVectors];
+		__m256d yn[numVectors];
+		__m256d shifted[numVectors];
 
-		// --- can not be (-)
-		currEnvelope = fmax(currEnvelope, 0.0);
+		// --- yn holds the lane outputs of the previous step, i.e. lane k + 1's next input in element k
+		double laneBuffer[kMaxBiquadBankLanes] = { 0.0 };
+		for (unsigned int lane = 0; lane < last; lane++)
+			laneBuffer[lane] = pipe[lane + 1];
 
-		// --- store envelope prior to sqrt for RMS version
-		lastEnvelope = currEnvelope;
+		for (unsigned int v = 0; v < numVectors; v++)
+		{
+			loadLanesAVX(4 * v, coeffs[v], states[v]);
+			storage[v] = _mm256_loadu_pd(&storageComponent[4 * v]);
+			yn[v] = _mm256_loadu_pd(&laneBuffer[4 * v]);
+		}
 
-		// --- if RMS, do the SQRT
-		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
-			currEnvelope = pow(currEnvelope, 0.5);
+		for (uint32_t n = last; n < numSamples; n++)
+		{
+			__m256d carry = _mm256_set1_pd((double)input[n]);
+			for (unsigned int v = 0; v < numVectors; v++)
+			{
+				// --- lane k of the new input is lane k - 1 of the previous output; the carry is the vector below
+				shifted[v] = _mm256_shuffle_pd(_mm256_permute2f128_pd(yn[v], carry, 0x03), yn[v], 0x5);
+				carry = yn[v];
+			}
 
-		// --- if not dB, we are done
-		if (!audioDetectorParameters.detect_dB)
-			return currEnvelope;
+			for (unsigned int v = 0; v < numVectors; v++)
+				yn[v] = biquadLanesAVX(coeffs[v], states[v], storage[v], shifted[v]);
 
-		// --- setup for log( )
-		if (currEnvelope <= 0)
+			double laneOut[4];
+			_mm256_storeu_pd(laneOut, yn[last / 4]);
+			output[n - last] = (OutputType)laneOut[last % 4];
+		}
+
+		// --- write back the lanes in use
+		for (unsigned int i = 0; i < numStates; i++)
 		{
-			return -96.0;
+			for (unsigned int v = 0; v < numVectors; v++)
+				_mm256_storeu_pd(&laneBuffer[4 * v], states[v][i]);
+			memcpy(&stateArray[i][0], laneBuffer, sizeof(double) * numLanes);
 		}
 
-		// --- true log output in dB, can go above 0dBFS!
-		return 20.0*log10(currEnvelope);
+		for (unsigned int v = 0; v < numVectors; v++)
+			_mm256_storeu_pd(&laneBuffer[4 * v], storage[v]);
+		memcpy(&storageComponent[0], laneBuffer, sizeof(double) * numLanes);
+
+		for (unsigned int v = 0; v < numVectors; v++)
+			_mm256_storeu_pd(&laneBuffer[4 * v], yn[v]);
+		for (unsigned int lane = 0; lane < last; lane++)
+			pipe[lane + 1] = laneBuffer[lane];
 	}
+#endif
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return AudioDetectorParameters custom data structure
-	*/
-	AudioDetectorParameters getParameters()
+#if defined FXOBJECTS_SSE2
+	/** load the coefficients and states of lanes [lane, lane + 2) into registers */
+	inline void loadLanesSSE2(unsigned int lane, __m128d* coeffs, __m128d* states)
 	{
-		return audioDetectorParameters;
+		for (unsigned int i = 0; i < numCoeffs; i++)
+			coeffs[i] = _mm_loadu_pd(&coeffArray[i][lane]);
+		for (unsigned int i = 0; i < numStates; i++)
+			states[i] = _mm_loadu_pd(&stateArray[i][lane]);
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param AudioDetectorParameters custom data structure
-	*/
-	void setParameters(const AudioDetectorParameters& parameters)
+	/** write back the states of lanes [lane, lane + 2) */
+	inline void storeLanesSSE2(unsigned int lane, const __m128d* states, __m128d storage)
 	{
-		audioDetectorParameters = parameters;
+		for (unsigned int i = 0; i < numStates; i++)
+			_mm_storeu_pd(&stateArray[i][lane], states[i]);
+		_mm_storeu_pd(&storageComponent[lane], storage);
+	}
 
-		// --- update structure
-		setAttackTime(audioDetectorParameters.attackTime_mSec, true);
-		setReleaseTime(audioDetectorParameters.releaseTime_mSec, true);
+	/** processLane( ) on two lanes held in registers */
+	static inline __m128d biquadLanesSSE2(const __m128d* coeffs, __m128d* states, __m128d& storage, __m128d xn)
+	{
+		storage = _mm_sub_pd(_mm_sub_pd(_mm_add_pd(_mm_mul_pd(coeffs[a1], states[x_z1]),
+												   _mm_mul_pd(coeffs[a2], states[x_z2])),
+										_mm_mul_pd(coeffs[b1], states[y_z1])),
+							 _mm_mul_pd(coeffs[b2], states[y_z2]));
+		__m128d yn = _mm_add_pd(_mm_mul_pd(coeffs[a0], xn), storage);
 
+		// --- underflow check: zero the non-zero values with magnitude below kSmallestPositiveFloatValue
+		const __m128d absYn = _mm_andnot_pd(_mm_set1_pd(-0.0), yn);
+		const __m128d underflow = _mm_and_pd(_mm_cmplt_pd(absYn, _mm_set1_pd(kSmallestPositiveFloatValue)),
+											 _mm_cmpneq_pd(yn, _mm_setzero_pd()));
+		yn = _mm_andnot_pd(underflow, yn);
+
+		states[x_z2] = states[x_z1];
+		states[x_z1] = xn;
+		states[y_z2] = states[y_z1];
+		states[y_z1] = yn;
+
+		return _mm_add_pd(_mm_mul_pd(coeffs[d0], xn), _mm_mul_pd(coeffs[c0], yn));
 	}
 
-	/** set sample rate - our time constants depend on it */
-	virtual void setSampleRate(double _sampleRate)
+	/** processLane( ) for lanes [lane, lane + 2) */
+	inline __m128d processLanesSSE2(unsigned int lane, __m128d xn)
 	{
-		if (sampleRate == _sampleRate)
-			return;
+		__m128d coeffs[numCoeffs];
+		__m128d states[numStates];
+		__m128d storage;
+		loadLanesSSE2(lane, coeffs, states);
+		__m128d output = biquadLanesSSE2(coeffs, states, storage, xn);
+		storeLanesSSE2(lane, states, storage);
+		return output;
+	}
 
-		sampleRate = _sampleRate;
+	/** the steady state of processCascadeBlock( ): the cascade in numVectors registers of 2 lanes; lanes above the last
+	    one in use are computed but never written back */
+	template <unsigned int numVectors, typename InputType, typename OutputType>
+	void cascadeSteadySSE2(const InputType* input, OutputType* output, uint32_t numSamples, double* pipe)
+	{
+		const unsigned int last = numLanes - 1;
+		__m128d coeffs[numVectors][numCoeffs];
+		__m128d states[numVectors][numStates];
+		__m128d storage[numVectors];
+		__m128d yn[numVectors];
+		__m128d shifted[numVectors];
 
-		// --- recalculate RC time-constants
-		setAttackTime(audioDetectorParameters.attackTime_mSec, true);
-		setReleaseTime(audioDetectorParameters.releaseTime_mSec, true);
-	}
+		// --- yn holds the lane outputs of the previous step, i.e. lane k + 1's next input in element k
+		double laneBuffer[kMaxBiquadBankLanes] = { 0.0 };
+		for (unsigned int lane = 0; lane < last; lane++)
+			laneBuffer[lane] = pipe[lane + 1];
 
-protected:
-	AudioDetectorParameters audioDetectorParameters; ///< parameters for object
-	double attackTime = 0.0;	///< attack time coefficient
-	double releaseTime = 0.0;	///< release time coefficient
-	double sampleRate = 44100;	///< stored sample rate
-	double lastEnvelope = 0.0;	///< output register
+		for (unsigned int v = 0; v < numVectors; v++)
+		{
+			loadLanesSSE2(2 * v, coeffs[v], states[v]);
+			storage[v] = _mm_loadu_pd(&storageComponent[2 * v]);
+			yn[v] = _mm_loadu_pd(&laneBuffer[2 * v]);
+		}
 
-	/** set our internal atack time coefficients based on times and sample rate */
-	void setAttackTime(double attack_in_ms, bool forceCalc = false);
+		for (uint32_t n = last; n < numSamples; n++)
+		{
+			__m128d carry = _mm_set1_pd((double)input[n]);
+			for (unsigned int v = 0; v < numVectors; v++)
+			{
+				// --- lane k of the new input is lane k - 1 of the previous output; the carry is the vector below
+				shifted[v] = _mm_shuffle_pd(carry, yn[v], 0x1);
+				carry = yn[v];
+			}
 
-	/** set our internal release time coefficients based on times and sample rate */
-	void setReleaseTime(double release_in_ms, bool forceCalc = false);
-};
+			for (unsigned int v = 0; v < numVectors; v++)
+				yn[v] = biquadLanesSSE2(coeffs[v], states[v], storage[v], shifted[v]);
+
+			double laneOut[2];
+			_mm_storeu_pd(laneOut, yn[last / 2]);
+			output[n - last] = (OutputType)laneOut[last % 2];
+		}
+
+		// --- write back the lanes in use
+		for (unsigned int i = 0; i < numStates; i++)
+		{
+			for (unsigned int v = 0; v < numVectors; v++)
+				_mm_storeu_pd(&laneBuffer[2 * v], states[v][i]);
+			memcpy(&stateArray[i][0], laneBuffer, sizeof(double) * numLanes);
+		}
+
+		for (unsigned int v = 0; v < numVectors; v++)
+			_mm_storeu_pd(&laneBuffer[2 * v], storage[v]);
+		memcpy(&storageComponent[0], laneBuffer, sizeof(double) * numLanes);
 
+		for (unsigned int v = 0; v < numVectors; v++)
+			_mm_storeu_pd(&laneBuffer[2 * v], yn[v]);
+		for (unsigned int lane = 0; lane < last; lane++)
+			pipe[lane + 1] = laneBuffer[lane];
+	}
+#endif
+};
 
 /**
-\enum dynamicsProcessorType
-\ingroup Constants-Enums
+\struct FilterBankOutput
+\ingroup FX-Objects
 \brief
-Use this strongly typed enum to set the dynamics processor type.
-
-- enum class dynamicsProcessorType { kCompressor, kDownwardExpander };
-- limiting is the extreme version of kCompressor
-- gating is the extreme version of kDownwardExpander
+Custom output structure for filter bank objects that split the inptu into multiple frequency channels (bands)
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
+// --- output for filter bank requires multiple channels (bands)
+struct FilterBankOutput
+{
+	FilterBankOutput() {}
 
-// --- processorType
-enum class dynamicsProcessorType { kCompressor, kDownwardExpander };
+	// --- band-split filter output
+	double LFOut = 0.0; ///< low frequency output sample
+	double HFOut = 0.0;	///< high frequency output sample
+
+	// --- add more filter channels here; or use an array[]
+};
 
 
 /**
-\struct DynamicsProcessorParameters
+\struct LRFilterBankParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the DynamicsProcessor object. Ths struct includes all information needed from GUI controls.
+Custom parameter structure for the LRFilterBank object which splits the input signal into multiple bands.
+The stock obejct splits into low and high frequency bands so this structure only requires one split point - add more
+split frequencies to support more bands.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-struct DynamicsProcessorParameters
+struct LRFilterBankParameters
 {
-	DynamicsProcessorParameters() {}
+	LRFilterBankParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	DynamicsProcessorParameters& operator=(const DynamicsProcessorParameters& params)	// need this override for collections to work
+	LRFilterBankParameters& operator=(const LRFilterBankParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
-
-		ratio = params.ratio;
-		threshold_dB = params.threshold_dB;
-		kneeWidth_dB = params.kneeWidth_dB;
-		hardLimitGate = params.hardLimitGate;
-		softKnee = params.softKnee;
-		enableSidechain = params.enableSidechain;
-		calculation = params.calculation;
-		attackTime_mSec = params.attackTime_mSec;
-		releaseTime_mSec = params.releaseTime_mSec;
-		outputGain_dB = params.outputGain_dB;
-		// --- NOTE: do not set outbound variables??
-		gainReduction = params.gainReduction;
-		gainReduction_dB = params.gainReduction_dB;
+		splitFrequency = params.splitFrequency;
 		return *this;
 	}
 
 	// --- individual parameters
-	double ratio = 50.0;				///< processor I/O gain ratio
-	double threshold_dB = -10.0;		///< threshold in dB
-	double kneeWidth_dB = 10.0;			///< knee width in dB for soft-knee operation
-	bool hardLimitGate = false;			///< threshold in dB
-	bool softKnee = true;				///< soft knee flag
-	bool enableSidechain = false;		///< enable external sidechain input to object
-	dynamicsProcessorType calculation = dynamicsProcessorType::kCompressor; ///< processor calculation type
-	double attackTime_mSec = 0.0;		///< attack mSec
-	double releaseTime_mSec = 0.0;		///< release mSec
-	double outputGain_dB = 0.0;			///< make up gain
-
-	// --- outbound values, for owner to use gain-reduction metering
-	double gainReduction = 1.0;			///< output value for gain reduction that occurred
-	double gainReduction_dB = 0.0;		///< output value for gain reduction that occurred in dB
+	double splitFrequency = 1000.0; ///< LF/HF split frequency
 };
 
+
 /**
-\class DynamicsProcessor
+\class LRFilterBank
 \ingroup FX-Objects
 \brief
-The DynamicsProcessor object implements a dynamics processor suite: compressor, limiter, downward expander, gate.
+The LRFilterBank object implements 2 Linkwitz-Riley Filters in a parallel filter bank to split the signal into two frequency bands.
+Note that one channel is inverted (see the FX book below for explanation). You can add more bands here as well.
 
 Audio I/O:
-- Processes mono input to mono output.
+- Processes mono input into a custom FilterBankOutput structure.
+NOTE: processAudioSample( ) is inoperable and only returns the input back.
 
 Control I/F:
-- Use DynamicsProcessorParameters structure to get/set object params.
+- Use LRFilterBankParameters structure to get/set object params.
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class DynamicsProcessor : public IAudioSignalProcessor
+class LRFilterBank : public IAudioSignalProcessor
 {
 public:
-	DynamicsProcessor() {}	/* C-TOR */
-	~DynamicsProcessor() {}	/* D-TOR */
+	LRFilterBank()		/* C-TOR */
+	{
+		// --- set filters as Linkwitz-Riley 2nd order
+		AudioFilterParameters params = lpFilter.getParameters();
+		params.algorithm = filterAlgorithm::kLWRLPF2;
+		lpFilter.setParameters(params);
 
-public:
-	/** reset members to initialized state */
+		params = hpFilter.getParameters();
+		params.algorithm = filterAlgorithm::kLWRHPF2;
+		hpFilter.setParameters(params);
+
+		// --- both bands run side by side in the bank: lane 0 = LPF, lane 1 = HPF
+		filterBank.setNumLanes(2);
+		updateFilterBank();
+	}
+
+	~LRFilterBank() {}	/* D-TOR */
+
+	/** reset member objects */
 	virtual bool reset(double _sampleRate)
 	{
-		sidechainInputSample = 0.0;
-		detector.reset(_sampleRate);
-		AudioDetectorParameters detectorParams = detector.getParameters();
-		detectorParams.clampToUnityMax = false;
-		detectorParams.detect_dB = true;
-		detector.setParameters(detectorParams);
+		lpFilter.reset(_sampleRate);
+		hpFilter.reset(_sampleRate);
+		filterBank.reset();
 		return true;
 	}
 
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** enable sidechaib input */
-	virtual void enableAuxInput(bool enableAuxInput){ parameters.enableSidechain = enableAuxInput; }
+	/** this does nothing for this object, see processFilterBank( ) below */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		return xn;
+	}
 
-	/** process the sidechain by saving the value for the upcoming processAudioSample() call */
-	virtual double processAuxInputAudioSample(double xn)
+	/** process the filter bank */
+	FilterBankOutput processFilterBank(double xn)
 	{
-		sidechainInputSample = xn;
-		return sidechainInputSample;
+		FilterBankOutput output;
+
+		// --- process the LPF and HPF together
+		double bands[2] = { xn, xn };
+		filterBank.processLanes(bands, bands);
+		output.LFOut = bands[0];
+
+		// --- invert the HP filter output so that recombination will
+		//     result in the correct phase and magnitude responses
+		output.HFOut = -bands[1];
+
+		return output;
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\return DynamicsProcessorParameters custom data structure
-	*/
-	DynamicsProcessorParameters getParameters(){ return parameters; }
-
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param DynamicsProcessorParameters custom data structure
+	\return LRFilterBankParameters custom data structure
 	*/
-	void setParameters(const DynamicsProcessorParameters& _parameters)
+	LRFilterBankParameters getParameters()
 	{
-		parameters = _parameters;
-
-		AudioDetectorParameters detectorParams = detector.getParameters();
-		detectorParams.attackTime_mSec = parameters.attackTime_mSec;
-		detectorParams.releaseTime_mSec = parameters.releaseTime_mSec;
-		detector.setParameters(detectorParams);
+		return parameters;
 	}
 
-	/** process audio using feed-forward dynamics processor flowchart */
-	/*
-		1. detect input signal
-		2. calculate gain
-		3. apply to input sample
-	*/
+	/** set parameters: note use of custom structure for passing param data */
 	/**
-	\param xn input
-	\return the processed sample
+	\param LRFilterBankParameters custom data structure
 	*/
-	virtual double processAudioSample(double xn)
+	void setParameters(const LRFilterBankParameters& _parameters)
 	{
-		// --- detect input
-		double detect_dB = 0.0;
-
-		// --- if using the sidechain, process the aux input
-		if(parameters.enableSidechain)
-			detect_dB = detector.processAudioSample(sidechainInputSample);
-		else
-			detect_dB = detector.processAudioSample(xn);
+		// --- update structure
+		parameters = _parameters;
 
-		// --- compute gain
-		double gr = computeGain(detect_dB);
+		// --- update member objects
+		AudioFilterParameters params = lpFilter.getParameters();
+		params.fc = parameters.splitFrequency;
+		lpFilter.setParameters(params);
 
-		// --- makeup gain
-		double makeupGain = pow(10.0, parameters.outputGain_dB / 20.0);
+		params = hpFilter.getParameters();
+		params.fc = parameters.splitFrequency;
+		hpFilter.setParameters(params);
 
-		// --- do DCA + makeup gain
-		return xn * gr * makeupGain;
+		updateFilterBank();
 	}
 
 protected:
-	DynamicsProcessorParameters parameters; ///< object parameters
-	AudioDetector detector; ///< the sidechain audio detector
-
-	// --- storage for sidechain audio input (mono only)
-	double sidechainInputSample = 0.0; ///< storage for sidechain sample
+	AudioFilter lpFilter; ///< low-band filter coefficient calculator
+	AudioFilter hpFilter; ///< high-band filter coefficient calculator
+	BiquadBank filterBank; ///< runs both bands
 
-	/** compute (and save) the current gain value based on detected input (dB) */
-	inline double computeGain(double detect_dB)
+	/** load the filter coefficients into the bank */
+	void updateFilterBank()
 	{
-		double output_dB = 0.0;
-
-		if (parameters.calculation == dynamicsProcessorType::kCompressor)
-		{
-			// --- hard knee
-			if (!parameters.softKnee)
-			{
-				// --- below threshold, unity
-				if (detect_dB <= parameters.threshold_dB)
-					output_dB = detect_dB;
-				else// --- above threshold, compress
-				{
-					if (parameters.hardLimitGate) // is limiter?
-						output_dB = parameters.threshold_dB;
-					else
-						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) / parameters.ratio;
-				}
-			}
-			else // --- calc gain with knee
-			{
-				// --- left side of knee, outside of width, unity gain zone
-				if (2.0*(detect_dB - parameters.threshold_dB) < -parameters.kneeWidth_dB)
-					output_dB = detect_dB;
-				// --- else inside the knee,
-				else if (2.0*(fabs(detect_dB - parameters.threshold_dB)) <= parameters.kneeWidth_dB)
-				{
-					if (parameters.hardLimitGate)	// --- is limiter?
-						output_dB = detect_dB - pow((detect_dB - parameters.threshold_dB + (parameters.kneeWidth_dB / 2.0)), 2.0) / (2.0*parameters.kneeWidth_dB);
-					else // --- 2nd order poly
-						output_dB = detect_dB + (((1.0 / parameters.ratio) - 1.0) * pow((detect_dB - parameters.threshold_dB + (parameters.kneeWidth_dB / 2.0)), 2.0)) / (2.0*parameters.kneeWidth_dB);
-				}
-				// --- right of knee, compression zone
-				else if (2.0*(detect_dB - parameters.threshold_dB) > parameters.kneeWidth_dB)
-				{
-					if (parameters.hardLimitGate) // --- is limiter?
-						output_dB = parameters.threshold_dB;
-					else
-						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) / parameters.ratio;
-				}
-			}
-		}
-		else if (parameters.calculation == dynamicsProcessorType::kDownwardExpander)
-		{
-			// --- hard knee
-			// --- NOTE: soft knee is not technically possible with a gate because there
-			//           is no "left side" of the knee
-			if (!parameters.softKnee || parameters.hardLimitGate)
-			{
-				// --- above threshold, unity gain
-				if (detect_dB >= parameters.threshold_dB)
-					output_dB = detect_dB;
-				else
-				{
-					if (parameters.hardLimitGate) // --- gate: -inf(dB)
-						output_dB = -1.0e34;
-					else
-						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) * parameters.ratio;
-				}
-			}
-			else // --- calc gain with knee
-			{
-				// --- right side of knee, unity gain zone
-				if (2.0*(detect_dB - parameters.threshold_dB) > parameters.kneeWidth_dB)
-					output_dB = detect_dB;
-				// --- in the knee
-				else if (2.0*(fabs(detect_dB - parameters.threshold_dB)) > -parameters.kneeWidth_dB)
-					output_dB = ((parameters.ratio - 1.0) * pow((detect_dB - parameters.threshold_dB - (parameters.kneeWidth_dB / 2.0)), 2.0)) / (2.0*parameters.kneeWidth_dB);
-				// --- left side of knee, downward expander zone
-				else if (2.0*(detect_dB - parameters.threshold_dB) <= -parameters.kneeWidth_dB)
-					output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) * parameters.ratio;
-			}
-		}
-
-		// --- convert gain; store values for user meters
-		parameters.gainReduction_dB = output_dB - detect_dB;
-		parameters.gainReduction = pow(10.0, (parameters.gainReduction_dB) / 20.0);
-
-		// --- the current gain coefficient value
-		return parameters.gainReduction;
+		filterBank.setCoefficients(0, lpFilter.getCoefficients());
+		filterBank.setCoefficients(1, hpFilter.getCoefficients());
 	}
+
+	// --- object parameters
+	LRFilterBankParameters parameters; ///< parameters for the object
 };
 
+// --- constants
+const unsigned int TLD_AUDIO_DETECT_MODE_PEAK = 0;
+const unsigned int TLD_AUDIO_DETECT_MODE_MS = 1;
+const unsigned int TLD_AUDIO_DETECT_MODE_RMS = 2;
+const double TLD_AUDIO_ENVELOPE_ANALOG_TC = -0.99967234081320612357829304641019; // ln(36.7%)
+
 /**
-\class LinearBuffer
+\struct AudioDetectorParameters
 \ingroup FX-Objects
 \brief
-The LinearBuffer object implements a linear buffer of type T. It allows easy wrapping of a smart pointer object.
+Custom parameter structure for the AudioDetector object. NOTE: this object uses constant defintions:
+
+- const unsigned int TLD_AUDIO_DETECT_MODE_PEAK = 0;
+- const unsigned int TLD_AUDIO_DETECT_MODE_MS = 1;
+- const unsigned int TLD_AUDIO_DETECT_MODE_RMS = 2;
+- const double TLD_AUDIO_ENVELOPE_ANALOG_TC = -0.99967234081320612357829304641019; // ln(36.7%)
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-template <typename T>
+struct AudioDetectorParameters
+{
+	AudioDetectorParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	AudioDetectorParameters& operator=(const AudioDetectorParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+		attackTime_mSec = params.attackTime_mSec;
+		releaseTime_mSec = params.releaseTime_mSec;
+		detectMode = params.detectMode;
+		detect_dB = params.detect_dB;
+		clampToUnityMax = params.clampToUnityMax;
+		fastLog = params.fastLog;
+		return *this;
+	}
+
+	// --- individual parameters
+	double attackTime_mSec = 0.0; ///< attack time in milliseconds
+	double releaseTime_mSec = 0.0;///< release time in milliseconds
+	unsigned int  detectMode = 0;///< detect mode, see TLD_ constants above
+	bool detect_dB = false;	///< detect in dB  DEFAULT  = false (linear NOT log)
+	bool clampToUnityMax = true;///< clamp output to 1.0 (set false for true log detectors)
+	bool fastLog = false;		///< dB detection with fastLog2( ) instead of log10( ); error < 3e-7 dB
+};
+
+/**
+\class AudioDetector
+\ingroup FX-Objects
+\brief
+The AudioDetector object implements the audio detector defined in the book source below.
+NOTE: this detector can receive signals and transmit detection values that are both > 0dBFS
+
+Audio I/O:
+- Processes mono input to a detected signal output.
+
+Control I/F:
+- Use AudioDetectorParameters structure to get/set object params.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class AudioDetector : public IAudioSignalProcessor, public IModulationSource
+{
+public:
+	AudioDetector() {}	/* C-TOR */
+	~AudioDetector() {}	/* D-TOR */
+
+public:
+	/** set sample rate dependent time constants and clear last envelope output value */
+	virtual bool reset(double _sampleRate)
+	{
+		setSampleRate(_sampleRate);
+		lastEnvelope = 0.0;
+		return true;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	// --- process audio: detect the log envelope and return it in dB
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- all modes do Full Wave Rectification
+		double input = fabs(xn);
+
+		// --- square it for MS and RMS
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_MS ||
+			audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			input *= input;
+
+		return formatEnvelope(detectEnvelope(input));
+	}
+
+	/** stereo-linked detection: one envelope follows the louder channel, so both channels get the same gain */
+	/**
+	\param xnL left input
+	\param xnR right input
+	\return the detected value, in the same format as processAudioSample( )
+	*/
+	double processStereoLinkedSample(double xnL, double xnR)
+	{
+		detectStereoLinkedSample(xnL, xnR);
+		return getDetectedValue();
+	}
+
+	/** stereo-linked detection without the output conversion; for control-rate users that only need
+	    getDetectedValue( ) now and then */
+	/**
+	\param xnL left input
+	\param xnR right input
+	*/
+	void detectStereoLinkedSample(double xnL, double xnR)
+	{
+		double input = fmax(fabs(xnL), fabs(xnR));
+
+		// --- square it for MS and RMS
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_MS ||
+			audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			input *= input;
+
+		detectEnvelope(input);
+	}
+
+	/** block version of detectStereoLinkedSample( ) */
+	/**
+	\param inputL left input samples
+	\param inputR right input samples; nullptr for a silent right channel
+	\param numSamples number of samples
+	*/
+	void detectStereoLinkedBlock(const float* inputL, const float* inputR, uint32_t numSamples)
+	{
+		if (inputR)
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				detectStereoLinkedSample(inputL[i], inputR[i]);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				detectStereoLinkedSample(inputL[i], 0.0);
+		}
+	}
+
+	/** the current envelope in the output format of processAudioSample( ) */
+	double getDetectedValue() { return formatEnvelope(lastEnvelope); }
+
+	/** IModulationSource: the current envelope as a control point; the detector is still fed every sample by
+	    its owner, so hopSize is not used. Quad phase outputs have no meaning here and carry the envelope too. */
+	virtual void renderControlPoint(uint32_t /*hopSize*/, uint32_t /*outputMask*/, double* values)
+	{
+		double envelope = getDetectedValue();
+
+		values[kModNormal] = envelope;
+		values[kModInverted] = -envelope;
+		values[kModQuadPhasePos] = envelope;
+		values[kModQuadPhaseNeg] = -envelope;
+	}
+
+	/** detect a block; same results as processAudioSample( ) per sample, with the mode decode hoisted */
+	/**
+	\param input input samples
+	\param output detected values
+	\param numSamples number of samples
+	*/
+	void processDetectorBlock(const float* input, double* output, uint32_t numSamples)
+	{
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_PEAK)
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				output[i] = formatEnvelope(detectEnvelope(fabs(input[i])));
+		}
+		else
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				output[i] = formatEnvelope(detectEnvelope((double)input[i] * input[i]));
+		}
+	}
+
+	/** stereo-linked detection of a block; see processStereoLinkedSample( ) */
+	/**
+	\param inputL left input samples
+	\param inputR right input samples
+	\param output detected values
+	\param numSamples number of samples
+	*/
+	void processDetectorBlock(const float* inputL, const float* inputR, double* output, uint32_t numSamples)
+	{
+		for (uint32_t i = 0; i < numSamples; i++)
+			output[i] = processStereoLinkedSample(inputL[i], inputR[i]);
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return AudioDetectorParameters custom data structure
+	*/
+	AudioDetectorParameters getParameters()
+	{
+		return audioDetectorParameters;
+	}
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param AudioDetectorParameters custom data structure
+	*/
+	void setParameters(const AudioDetectorParameters& parameters)
+	{
+		audioDetectorParameters = parameters;
+
+		// --- update structure
+		setAttackTime(audioDetectorParameters.attackTime_mSec, true);
+		setReleaseTime(audioDetectorParameters.releaseTime_mSec, true);
+
+	}
+
+	/** set sample rate - our time constants depend on it */
+	virtual void setSampleRate(double _sampleRate)
+	{
+		if (sampleRate == _sampleRate)
+			return;
+
+		sampleRate = _sampleRate;
+
+		// --- recalculate RC time-constants
+		setAttackTime(audioDetectorParameters.attackTime_mSec, true);
+		setReleaseTime(audioDetectorParameters.releaseTime_mSec, true);
+	}
+
+protected:
+	AudioDetectorParameters audioDetectorParameters; ///< parameters for object
+	double attackTime = 0.0;	///< attack time coefficient
+	double releaseTime = 0.0;	///< release time coefficient
+	double sampleRate = 44100;	///< stored sample rate
+	double lastEnvelope = 0.0;	///< output register
+
+	/** set our internal atack time coefficients based on times and sample rate */
+	void setAttackTime(double attack_in_ms, bool forceCalc = false);
+
+	/** set our internal release time coefficients based on times and sample rate */
+	void setReleaseTime(double release_in_ms, bool forceCalc = false);
+
+	/** run the attack/release envelope on a rectified (and squared for MS/RMS) input */
+	inline double detectEnvelope(double input)
+	{
+		// --- to store current
+		double currEnvelope = 0.0;
+
+		// --- do the detection with attack or release applied
+		if (input > lastEnvelope)
+			currEnvelope = attackTime * (lastEnvelope - input) + input;
+		else
+			currEnvelope = releaseTime * (lastEnvelope - input) + input;
+
+		// --- we are recursive so need to check underflow
+		checkFloatUnderflow(currEnvelope);
+
+		// --- bound them; can happen when using pre-detector gains of more than 1.0
+		if (audioDetectorParameters.clampToUnityMax)
+			currEnvelope = fmin(currEnvelope, 1.0);
+
+		// --- can not be (-)
+		currEnvelope = fmax(currEnvelope, 0.0);
+
+		// --- store envelope prior to sqrt for RMS version
+		lastEnvelope = currEnvelope;
+
+		return currEnvelope;
+	}
+
+	/** convert the envelope to the output format: RMS, linear or dB */
+	inline double formatEnvelope(double currEnvelope)
+	{
+		// --- fast log: the RMS sqrt becomes a factor of 1/2 in the log domain
+		if (audioDetectorParameters.detect_dB && audioDetectorParameters.fastLog)
+		{
+			if (currEnvelope <= 0)
+				return -96.0;
+
+			double envelope_dB = fastRaw2dB(currEnvelope);
+			return audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS ? 0.5*envelope_dB : envelope_dB;
+		}
+
+		// --- if RMS, do the SQRT
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			currEnvelope = pow(currEnvelope, 0.5);
+
+		// --- if not dB, we are done
+		if (!audioDetectorParameters.detect_dB)
+			return currEnvelope;
+
+		// --- setup for log( )
+		if (currEnvelope <= 0)
+		{
+			return -96.0;
+		}
+
+		// --- true log output in dB, can go above 0dBFS!
+		return 20.0*log10(currEnvelope);
+	}
+};
+
+
+/**
+\enum dynamicsProcessorType
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to set the dynamics processor type.
+
+- enum class dynamicsProcessorType { kCompressor, kDownwardExpander };
+- limiting is the extreme version of kCompressor
+- gating is the extreme version of kDownwardExpander
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+
+// --- processorType
+enum class dynamicsProcessorType { kCompressor, kDownwardExpander };
+
+
+/**
+\struct DynamicsProcessorParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the DynamicsProcessor object. Ths struct includes all information needed from GUI controls.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct DynamicsProcessorParameters
+{
+	DynamicsProcessorParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	DynamicsProcessorParameters& operator=(const DynamicsProcessorParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		ratio = params.ratio;
+		threshold_dB = params.threshold_dB;
+		kneeWidth_dB = params.kneeWidth_dB;
+		hardLimitGate = params.hardLimitGate;
+		softKnee = params.softKnee;
+		enableSidechain = params.enableSidechain;
+		calculation = params.calculation;
+		attackTime_mSec = params.attackTime_mSec;
+		releaseTime_mSec = params.releaseTime_mSec;
+		outputGain_dB = params.outputGain_dB;
+		// --- NOTE: do not set outbound variables??
+		gainReduction = params.gainReduction;
+		gainReduction_dB = params.gainReduction_dB;
+		return *this;
+	}
+
+	// --- individual parameters
+	double ratio = 50.0;				///< processor I/O gain ratio
+	double threshold_dB = -10.0;		///< threshold in dB
+	double kneeWidth_dB = 10.0;			///< knee width in dB for soft-knee operation
+	bool hardLimitGate = false;			///< threshold in dB
+	bool softKnee = true;				///< soft knee flag
+	bool enableSidechain = false;		///< enable external sidechain input to object
+	dynamicsProcessorType calculation = dynamicsProcessorType::kCompressor; ///< processor calculation type
+	double attackTime_mSec = 0.0;		///< attack mSec
+	double releaseTime_mSec = 0.0;		///< release mSec
+	double outputGain_dB = 0.0;			///< make up gain
+
+	// --- outbound values, for owner to use gain-reduction metering
+	double gainReduction = 1.0;			///< output value for gain reduction that occurred
+	double gainReduction_dB = 0.0;		///< output value for gain reduction that occurred in dB
+};
+
+/**
+\class DynamicsProcessor
+\ingroup FX-Objects
+\brief
+The DynamicsProcessor object implements a dynamics processor suite: compressor, limiter, downward expander, gate.
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- Use DynamicsProcessorParameters structure to get/set object params.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class DynamicsProcessor : public IAudioSignalProcessor
+{
+public:
+	DynamicsProcessor() {}	/* C-TOR */
+	~DynamicsProcessor() {}	/* D-TOR */
+
+public:
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		sidechainInputSample = 0.0;
+		detector.reset(_sampleRate);
+		AudioDetectorParameters detectorParams = detector.getParameters();
+		detectorParams.clampToUnityMax = false;
+		detectorParams.detect_dB = true;
+		detector.setParameters(detectorParams);
+		return true;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** enable sidechaib input */
+	virtual void enableAuxInput(bool enableAuxInput){ parameters.enableSidechain = enableAuxInput; }
+
+	/** process the sidechain by saving the value for the upcoming processAudioSample() call */
+	virtual double processAuxInputAudioSample(double xn)
+	{
+		sidechainInputSample = xn;
+		return sidechainInputSample;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return DynamicsProcessorParameters custom data structure
+	*/
+	DynamicsProcessorParameters getParameters(){ return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param DynamicsProcessorParameters custom data structure
+	*/
+	void setParameters(const DynamicsProcessorParameters& _parameters)
+	{
+		parameters = _parameters;
+
+		AudioDetectorParameters detectorParams = detector.getParameters();
+		detectorParams.attackTime_mSec = parameters.attackTime_mSec;
+		detectorParams.releaseTime_mSec = parameters.releaseTime_mSec;
+		detector.setParameters(detectorParams);
+	}
+
+	/** process audio using feed-forward dynamics processor flowchart */
+	/*
+		1. detect input signal
+		2. calculate gain
+		3. apply to input sample
+	*/
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- detect input
+		double detect_dB = 0.0;
+
+		// --- if using the sidechain, process the aux input
+		if(parameters.enableSidechain)
+			detect_dB = detector.processAudioSample(sidechainInputSample);
+		else
+			detect_dB = detector.processAudioSample(xn);
+
+		// --- compute gain
+		double gr = computeGain(detect_dB);
+
+		// --- makeup gain
+		double makeupGain = pow(10.0, parameters.outputGain_dB / 20.0);
+
+		// --- do DCA + makeup gain
+		return xn * gr * makeupGain;
+	}
+
+protected:
+	DynamicsProcessorParameters parameters; ///< object parameters
+	AudioDetector detector; ///< the sidechain audio detector
+
+	// --- storage for sidechain audio input (mono only)
+	double sidechainInputSample = 0.0; ///< storage for sidechain sample
+
+	/** compute (and save) the current gain value based on detected input (dB) */
+	inline double computeGain(double detect_dB)
+	{
+		double output_dB = 0.0;
+
+		if (parameters.calculation == dynamicsProcessorType::kCompressor)
+		{
+			// --- hard knee
+			if (!parameters.softKnee)
+			{
+				// --- below threshold, unity
+				if (detect_dB <= parameters.threshold_dB)
+					output_dB = detect_dB;
+				else// --- above threshold, compress
+				{
+					if (parameters.hardLimitGate) // is limiter?
+						output_dB = parameters.threshold_dB;
+					else
+						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) / parameters.ratio;
+				}
+			}
+			else // --- calc gain with knee
+			{
+				// --- left side of knee, outside of width, unity gain zone
+				if (2.0*(detect_dB - parameters.threshold_dB) < -parameters.kneeWidth_dB)
+					output_dB = detect_dB;
+				// --- else inside the knee,
+				else if (2.0*(fabs(detect_dB - parameters.threshold_dB)) <= parameters.kneeWidth_dB)
+				{
+					if (parameters.hardLimitGate)	// --- is limiter?
+						output_dB = detect_dB - pow((detect_dB - parameters.threshold_dB + (parameters.kneeWidth_dB / 2.0)), 2.0) / (2.0*parameters.kneeWidth_dB);
+					else // --- 2nd order poly
+						output_dB = detect_dB + (((1.0 / parameters.ratio) - 1.0) * pow((detect_dB - parameters.threshold_dB + (parameters.kneeWidth_dB / 2.0)), 2.0)) / (2.0*parameters.kneeWidth_dB);
+				}
+				// --- right of knee, compression zone
+				else if (2.0*(detect_dB - parameters.threshold_dB) > parameters.kneeWidth_dB)
+				{
+					if (parameters.hardLimitGate) // --- is limiter?
+						output_dB = parameters.threshold_dB;
+					else
+						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) / parameters.ratio;
+				}
+			}
+		}
+		else if (parameters.calculation == dynamicsProcessorType::kDownwardExpander)
+		{
+			// --- hard knee
+			// --- NOTE: soft knee is not technically possible with a gate because there
+			//           is no "left side" of the knee
+			if (!parameters.softKnee || parameters.hardLimitGate)
+			{
+				// --- above threshold, unity gain
+				if (detect_dB >= parameters.threshold_dB)
+					output_dB = detect_dB;
+				else
+				{
+					if (parameters.hardLimitGate) // --- gate: -inf(dB)
+						output_dB = -1.0e34;
+					else
+						output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) * parameters.ratio;
+				}
+			}
+			else // --- calc gain with knee
+			{
+				// --- right side of knee, unity gain zone
+				if (2.0*(detect_dB - parameters.threshold_dB) > parameters.kneeWidth_dB)
+					output_dB = detect_dB;
+				// --- in the knee
+				else if (2.0*(fabs(detect_dB - parameters.threshold_dB)) > -parameters.kneeWidth_dB)
+					output_dB = ((parameters.ratio - 1.0) * pow((detect_dB - parameters.threshold_dB - (parameters.kneeWidth_dB / 2.0)), 2.0)) / (2.0*parameters.kneeWidth_dB);
+				// --- left side of knee, downward expander zone
+				else if (2.0*(detect_dB - parameters.threshold_dB) <= -parameters.kneeWidth_dB)
+					output_dB = parameters.threshold_dB + (detect_dB - parameters.threshold_dB) * parameters.ratio;
+			}
+		}
+
+		// --- convert gain; store values for user meters
+		parameters.gainReduction_dB = output_dB - detect_dB;
+		parameters.gainReduction = pow(10.0, (parameters.gainReduction_dB) / 20.0);
+
+		// --- the current gain coefficient value
+		return parameters.gainReduction;
+	}
+};
+
+/**
+\class LinearBuffer
+\ingroup FX-Objects
+\brief
+The LinearBuffer object implements a linear buffer of type T. It allows easy wrapping of a smart pointer object.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+template <typename T>
 class LinearBuffer
 {
 public:
-	LinearBuffer() {}	/* C-TOR */
-	~LinearBuffer() {}	/* D-TOR */
+	LinearBuffer() {}	/* C-TOR */
+	~LinearBuffer() {}	/* D-TOR */
+
+	/** flush buffer by resetting all values to 0.0 */
+	void flushBuffer() { memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+
+	/** Create a buffer based on a target maximum in SAMPLES
+	//	   do NOT call from realtime audio thread; do this prior to any processing */
+	void createLinearBuffer(unsigned int _bufferLength)
+	{
+		// --- find nearest power of 2 for buffer, save it as bufferLength
+		bufferLength = _bufferLength;
+
+		// --- create new buffer
+		buffer.reset(new T[bufferLength]);
+
+		// --- flush buffer
+		flushBuffer();
+	}
+
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(unsigned int index, T input)
+	{
+		if (index >= bufferLength) return;
+
+		// --- write and increment index counter
+		buffer[index] = input;
+	}
+
+	/**  read an arbitrary location that is delayInSamples old */
+	T readBuffer(unsigned int index)//, bool readBeforeWrite = true)
+	{
+		if (index >= bufferLength) return 0.0;
+
+		// --- read it
+		return buffer[index];
+	}
+
+private:
+	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
+	unsigned int bufferLength = 1024; ///< buffer length
+};
+
+
+/**
+\class DelayMemoryArena
+\ingroup FX-Objects
+\brief
+The DelayMemoryArena object is the process-wide pool that the CircularBuffer and ExactCircularBuffer objects draw their
+storage from. Memory comes from the OS in large chunks (huge pages where available), pre-faulted by the thread that
+reserves it, and is recycled between buffers instead of being returned; after a reserve( ) that covers the worst case,
+creating a delay buffer does not touch the OS heap or take page faults.
+
+- call reserve( ) from a non-realtime thread (e.g. PluginCore::initialize) with the worst-case need of the instance
+- call unreserve( ) with the same amount when the instance goes away
+- allocate( ) and release( ) are thread-safe but lock; do not call them from the audio thread
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class DelayMemoryArena
+{
+public:
+	/** the one arena; never destroyed so that buffers in static objects may be released at any time */
+	static DelayMemoryArena& getInstance();
+
+	/** add to the promised worst case; grows the pool from the OS if the promises exceed it */
+	void reserve(size_t bytes);
+
+	/** remove a promise made with reserve( ); the memory stays in the pool */
+	void unreserve(size_t bytes);
+
+	/** get a block of at least bytes, aligned to kAlignment; grows the pool if nothing fits, throws std::bad_alloc on failure */
+	void* allocate(size_t bytes);
+
+	/** return a block from allocate( ) to the pool; nullptr is ignored */
+	void release(void* memory);
+
+	/** the pool size of an allocation of bytes; use it to compute the argument for reserve( ) */
+	static size_t getBlockSize(size_t bytes) { return (bytes + kAlignment - 1) & ~(kAlignment - 1); }
+
+	/** total bytes obtained from the OS */
+	size_t getPoolSize() { std::lock_guard<std::mutex> lock(arenaMutex); return poolSize; }
+
+	static const size_t kAlignment = 64;					///< cache line
+	static const size_t kChunkGranularity = 2 * 1024 * 1024;	///< huge page size, also the minimum growth
+
+private:
+	DelayMemoryArena() {}
+	DelayMemoryArena(const DelayMemoryArena&) = delete;
+	DelayMemoryArena& operator=(const DelayMemoryArena&) = delete;
+
+	/** get a chunk from the OS and add it to the free list; caller holds the lock */
+	bool addChunk(size_t bytes);
+
+	/** add a block to the free list and coalesce; caller holds the lock */
+	void addFreeBlock(char* block, size_t bytes);
+
+	std::mutex arenaMutex;					///< guards everything below
+	std::map<char*, size_t> freeBlocks;		///< free blocks by address, for first-fit and coalescing
+	std::map<char*, size_t> usedBlocks;		///< allocated blocks and their sizes
+	size_t poolSize = 0;					///< bytes obtained from the OS
+	size_t reservedBytes = 0;				///< sum of the outstanding reserve( ) calls
+};
+
+/** deleter for buffers that live in the DelayMemoryArena */
+struct DelayMemoryDeleter
+{
+	void operator()(void* memory) const { DelayMemoryArena::getInstance().release(memory); }
+};
+
+/**
+\enum fftwPlanType
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to select the transform of a plan from the FFTWPlanRegistry. The FFT objects
+only transform real audio, so only the real-to-complex and complex-to-real (half spectrum) plans are needed.
+
+- enum class fftwPlanType { kRealToComplex, kComplexToReal };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class fftwPlanType { kRealToComplex, kComplexToReal };
+
+// --- fxfft: the FFT backend of the FFT objects and the FFTWPlanRegistry, FFTW with HAVE_FFTW and otherwise the
+//     built-in RealFFT; the objects only use these names, so they are the same code either way and the library
+//     never defines any of FFTW's own names
+namespace fxfft {
+
+#ifndef HAVE_FFTW
+/**
+\class RealFFT
+\ingroup FFTW-Objects
+\brief
+The RealFFT object is the built-in FFT used when HAVE_FFTW is not defined: a real FFT of a power of 2 length N,
+made from an N/2 point complex Stockham FFT (radix-4 passes, plus one radix-2 pass for odd powers of 2) and the
+usual split into even and odd samples. The passes use AVX/SSE2 when available.
+
+- forward: N real points to N/2 + 1 complex points; inverse: N/2 + 1 complex points to N real points,
+  unnormalized (scaled by N), exactly the FFTW r2c/c2r conventions
+- no scratch memory: the passes ping-pong between the input and output arrays, so a RealFFT is const while
+  executing and may be shared between objects and threads; the cost is that BOTH transforms overwrite their input
+- the objects use it through the fxfft functions below, so the FFT objects are the same code either way
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class RealFFT
+{
+public:
+	/** build the twiddle tables for one direction of a length point transform (power of 2, at least 2) */
+	RealFFT(unsigned int _length, bool _inverse);
+	~RealFFT() {}
+
+	/** real to complex: length points of input (overwritten) to length/2 + 1 interleaved complex points of output */
+	void executeForward(double* input, double* output) const;
+
+	/** complex to real: length/2 + 1 interleaved complex points of input (overwritten) to length points of output */
+	void executeInverse(double* input, double* output) const;
+
+	/** the transform length */
+	unsigned int getLength() const { return length; }
+
+	/** true for the complex to real transform */
+	bool isInverse() const { return inverse; }
+
+protected:
+	/** the N/2 point complex FFT; x holds the input and both arrays are overwritten. Returns the one with the result. */
+	double* complexFFT(double* x, double* y) const;
+
+	unsigned int length = 0;		///< N
+	unsigned int halfLength = 0;	///< N/2: the complex FFT length
+	bool inverse = false;			///< direction
+	std::vector<unsigned int> stageOffsets;	///< start of each radix-4 pass in stageTwiddles
+	std::vector<double> stageTwiddles;		///< per radix-4 pass and butterfly: w, w^2, w^3 as (re, im) pairs
+	std::vector<double> realTwiddles;		///< exp(-2 pi i k/N) for k in [0, N/4], as (re, im) pairs
+};
+#endif
+
+#ifdef HAVE_FFTW
+typedef fftw_complex complex;		///< one complex point: [0] = real part, [1] = imaginary part
+typedef fftw_plan plan;				///< a transform of one length and direction
+
+const unsigned int kPlanMeasure = FFTW_MEASURE;		///< planner flags: time the candidate algorithms
+const unsigned int kPlanEstimate = FFTW_ESTIMATE;	///< planner flags: pick an algorithm without timing
+#else
+typedef double complex[2];			///< one complex point: [0] = real part, [1] = imaginary part
+typedef const RealFFT* plan;		///< a transform of one length and direction
+
+const unsigned int kPlanMeasure = 0;	///< planner flags; ignored by RealFFT
+const unsigned int kPlanEstimate = 1;	///< planner flags; ignored by RealFFT
+#endif
+
+/** SIMD aligned allocation for the arrays passed to the execute functions */
+inline void* allocate(size_t bytes)
+{
+#if defined HAVE_FFTW
+	return fftw_malloc(bytes);
+#elif defined _WIN32
+	return _aligned_malloc(bytes, 64);
+#else
+	void* memory = nullptr;
+	if (posix_memalign(&memory, 64, bytes) != 0)
+		return nullptr;
+	return memory;
+#endif
+}
+
+/** free memory from allocate( ) */
+inline void release(void* memory)
+{
+#if defined HAVE_FFTW
+	fftw_free(memory);
+#elif defined _WIN32
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+/** make a plan for a transform of length points; may run the planner, so it is only called by the FFTWPlanRegistry */
+plan makePlan(unsigned int length, fftwPlanType type, unsigned int flags);
+
+/** real to complex: length points of input to length/2 + 1 points of output; the input may be overwritten */
+inline void executeRealToComplex(plan transform, double* input, complex* output)
+{
+#ifdef HAVE_FFTW
+	fftw_execute_dft_r2c(transform, input, output);
+#else
+	transform->executeForward(input, &output[0][0]);
+#endif
+}
+
+/** complex to real, unnormalized: length/2 + 1 points of input to length points of output; the input is overwritten */
+inline void executeComplexToReal(plan transform, complex* input, double* output)
+{
+#ifdef HAVE_FFTW
+	fftw_execute_dft_c2r(transform, input, output);
+#else
+	transform->executeInverse(&input[0][0], output);
+#endif
+}
+
+/** import planner wisdom from a file; false if there is none (always, without FFTW) */
+bool importWisdom(const std::string& path);
+
+/** export the planner wisdom to a file; false if it could not be written (always, without FFTW) */
+bool exportWisdom(const std::string& path);
+
+} // namespace fxfft
+
+/**
+\class FFTWPlanRegistry
+\ingroup FFTW-Objects
+\brief
+The FFTWPlanRegistry object is the process-wide store of FFT plans. A plan is made once per length, transform
+and planner flags and shared by every FFT object, which runs it on its own arrays with the execute functions
+fxfft::executeRealToComplex( ) and fxfft::executeComplexToReal( ).
+
+- FFTW wisdom is imported from the wisdom file on first use and exported each time a new plan is made, so a
+  measured plan (fxfft::kPlanMeasure) is measured once per machine instead of once per object
+- the default wisdom file is in the user's cache folder; there is no wisdom file if that cannot be found
+- plans are made on scratch arrays, so measuring does not overwrite the caller's data
+- the arrays passed to the execute functions must come from fxfft::allocate( ) (the alignment the plans assume) and
+  be distinct (the plans are out-of-place)
+- getPlan( ) locks and may run the planner: call it from initialize or reset functions, not the audio thread
+- plans are owned by the registry and never destroyed
+- without HAVE_FFTW the plans are built-in RealFFT objects; the flags are ignored and there is no wisdom
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class FFTWPlanRegistry
+{
+public:
+	/** the one registry; never destroyed so that objects in static storage may use it at any time */
+	static FFTWPlanRegistry& getInstance();
+
+	/** get the shared plan for a transform of length points; made (and the wisdom saved) on the first request */
+	fxfft::plan getPlan(unsigned int length, fftwPlanType type, unsigned int flags = kDefaultPlannerFlags);
+
+	/** set the wisdom file (empty for none); call before the first getPlan( ), e.g. from PluginCore::initialize( ), to replace the default */
+	void setWisdomFile(const std::string& path);
+
+	/** get the wisdom file path */
+	std::string getWisdomFile() { std::lock_guard<std::mutex> lock(registryMutex); return wisdomFile; }
+
+	/** write the accumulated wisdom to the wisdom file; returns false if it could not be written */
+	bool saveWisdom();
+
+	static const unsigned int kDefaultPlannerFlags = fxfft::kPlanMeasure;	///< plan quality used by the FFT objects
+
+private:
+	FFTWPlanRegistry();
+	FFTWPlanRegistry(const FFTWPlanRegistry&) = delete;
+	FFTWPlanRegistry& operator=(const FFTWPlanRegistry&) = delete;
+
+	/** import the wisdom file once; caller holds the lock */
+	void loadWisdom();
+
+	/** export to the wisdom file; caller holds the lock */
+	bool exportWisdom();
+
+	std::mutex registryMutex;		///< guards everything below, and the FFTW planner, which is not thread-safe
+	std::map<std::tuple<unsigned int, fftwPlanType, unsigned int>, fxfft::plan> plans;	///< plans by (length, type, flags)
+	std::string wisdomFile;			///< wisdom file path
+	bool wisdomLoaded = false;		///< true once the wisdom file has been read (or found missing)
+};
+
+/**
+\class CircularBuffer
+\ingroup FX-Objects
+\brief
+The CircularBuffer object implements a simple circular buffer. It uses a wrap mask to wrap the read or write index quickly.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+/** A simple cyclic buffer: NOTE - this is NOT an IAudioSignalProcessor or IAudioSignalGenerator
+	S must be a power of 2.
+	T is the storage type; fractional (interpolated) reads are always calculated and returned as double
+	so that float storage can be used with double arithmetic
+*/
+template <typename T>
+class CircularBuffer
+{
+public:
+	CircularBuffer() {}		/* C-TOR */
+	~CircularBuffer() {}	/* D-TOR */
+
+							/** flush buffer by resetting all values to 0.0 */
+	void flushBuffer()
+	{
+		memset(&buffer[0], 0, bufferLength * sizeof(T));
+		memset(&thiranState[0], 0, sizeof(thiranState));
+	}
+
+	/** smallest power of 2 >= length; integer only */
+	static unsigned int getPowerOfTwo(unsigned int length)
+	{
+		unsigned int powerOfTwo = 1;
+		while (powerOfTwo < length)
+			powerOfTwo <<= 1;
+		return powerOfTwo;
+	}
+
+	/** the DelayMemoryArena bytes used by a buffer of _bufferLength samples */
+	static size_t getAllocationBytes(unsigned int _bufferLength)
+	{
+		return DelayMemoryArena::getBlockSize(getPowerOfTwo(_bufferLength) * sizeof(T));
+	}
+
+	/** allocate storage for buffers up to _maxBufferLength samples; later createCircularBuffer( ) calls that fit
+	    (e.g. after a sample rate change) re-use it without allocating
+	//	   do NOT call from realtime audio thread */
+	void reserveCircularBuffer(unsigned int _maxBufferLength)
+	{
+		unsigned int length = getPowerOfTwo(_maxBufferLength);
+		if (length <= capacity)
+			return;
+
+		// --- give back the old one first so it can be reused
+		buffer.reset();
+		buffer.reset((T*)DelayMemoryArena::getInstance().allocate(length * sizeof(T)));
+		capacity = length;
+
+		// --- the new storage holds nothing yet
+		bufferLength = length < bufferLength ? length : bufferLength;
+		wrapMask = bufferLength - 1;
+		writeIndex = 0;
+		flushBuffer();
+	}
+
+	/** Create a buffer based on a target maximum in SAMPLES
+	//	   do NOT call from realtime audio thread; do this prior to any processing */
+	void createCircularBuffer(unsigned int _bufferLength)
+	{
+		// --- find nearest power of 2 for buffer, and create
+		createCircularBufferPowerOfTwo(getPowerOfTwo(_bufferLength));
+	}
+
+	/** Create a buffer based on a target maximum in SAMPLESwhere the size is
+	    pre-calculated as a power of two */
+	void createCircularBufferPowerOfTwo(unsigned int _bufferLengthPowerOfTwo)
+	{
+		// --- reset to top
+		writeIndex = 0;
+
+		// --- find nearest power of 2 for buffer, save it as bufferLength
+		bufferLength = _bufferLengthPowerOfTwo;
+
+		// --- save (bufferLength - 1) for use as wrapping mask
+		wrapMask = bufferLength - 1;
+
+		// --- create new buffer in the arena only if it does not fit in what we have;
+		//     give back the old one first so it can be reused
+		if (bufferLength > capacity)
+		{
+			buffer.reset();
+			buffer.reset((T*)DelayMemoryArena::getInstance().allocate(bufferLength * sizeof(T)));
+			capacity = bufferLength;
+		}
+
+		// --- flush the part in use
+		flushBuffer();
+	}
+
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(T input)
+	{
+		// --- write and increment index counter
+		buffer[writeIndex++] = input;
+
+		// --- wrap if index > bufferlength - 1
+		writeIndex &= wrapMask;
+	}
+
+	/** read an arbitrary location that is delayInSamples old */
+	T readBuffer(int delayInSamples)//, bool readBeforeWrite = true)
+	{
+		// --- subtract to make read index
+		//     note: -1 here is because we read-before-write,
+		//           so the *last* write location is what we use for the calculation
+		int readIndex = (writeIndex - 1) - delayInSamples;
+
+		// --- autowrap index
+		readIndex &= wrapMask;
+
+		// --- read it
+		return buffer[readIndex];
+	}
+
+	/** read an arbitrary location that includes a fractional sample, with the interpolator set by setInterpolation( ) */
+	double readBuffer(double delayInFractionalSamples)
+	{
+		return readTap(delayInFractionalSamples, 0);
+	}
+
+	/** read an arbitrary location that includes a fractional sample, with the interpolator fixed at compile time */
+	/**
+	\param delayInFractionalSamples the delay; at least getInterpolatorNewerTaps(type) samples
+	\param tap the kThiran allpass state to use; each tap read once per sample needs its own
+	\return the interpolated value
+	*/
+	template <delayInterpolation type>
+	double readBufferInterpolated(double delayInFractionalSamples, unsigned int tap = 0)
+	{
+		// --- truncate delayInFractionalSamples and read the int part
+		int delayInSamples = (int)delayInFractionalSamples;
+		double fraction = delayInFractionalSamples - delayInSamples;
+
+		if (type == delayInterpolation::kNone)
+			return readBuffer(delayInSamples);
+
+		if (type == delayInterpolation::kThiran && tap < kMaxThiranTaps)
+		{
+			// --- keep the allpass delay in [0.5, 1.5)
+			if (fraction < 0.5 && delayInSamples > 0)
+			{
+				delayInSamples--;
+				fraction += 1.0;
+			}
+			return doThiranInterpolation(readBuffer(delayInSamples), readBuffer(delayInSamples + 1), fraction, thiranState[tap]);
+		}
+
+		if (type == delayInterpolation::kLinear || type == delayInterpolation::kThiran)
+		{
+			// --- read the sample at n+1 (one sample OLDER)
+			return doLinearInterpolation(readBuffer(delayInSamples), readBuffer(delayInSamples + 1), fraction);
+		}
+
+		// --- FIR: gather the points oldest first, as they are stored
+		const unsigned int numTaps = getInterpolatorTaps(type);
+		const int newestDelay = delayInSamples - (int)getInterpolatorNewerTaps(type);
+		T points[kMaxInterpolatorTaps];
+		for (unsigned int i = 0; i < numTaps; i++)
+			points[numTaps - 1 - i] = readBuffer(newestDelay + (int)i);
+
+		double coeffs[kMaxInterpolatorTaps];
+		calcInterpolatorCoefficients(type, fraction, &coeffs[0]);
+		return doFIRInterpolation(&points[numTaps - 1], &coeffs[0], numTaps);
+	}
+
+	/** read several fractional delay taps for the current sample period; same result as calling readBuffer(double)
+	    once per tap, but with the interpolation vectorized across the taps */
+	/**
+	\param delayInFractionalSamples array of numTaps delay times
+	\param output array to receive numTaps tap values
+	\param numTaps number of taps
+	*/
+	void readBuffer(const double* delayInFractionalSamples, double* output, unsigned int numTaps)
+	{
+		if (interpolation != delayInterpolation::kLinear && interpolation != delayInterpolation::kNone)
+		{
+			for (unsigned int tap = 0; tap < numTaps; tap++)
+				output[tap] = readTap(delayInFractionalSamples[tap], tap);
+			return;
+		}
+
+		const unsigned int maxGather = 8;
+		T y1[maxGather];
+		T y2[maxGather];
+		double fraction[maxGather];
+
+		for (unsigned int tap = 0; tap < numTaps; tap += maxGather)
+		{
+			unsigned int count = numTaps - tap < maxGather ? numTaps - tap : maxGather;
+
+			// --- gather: these are the only scattered reads
+			for (unsigned int i = 0; i < count; i++)
+			{
+				int delayInSamples = (int)delayInFractionalSamples[tap + i];
+				y1[i] = readBuffer(delayInSamples);
+				y2[i] = readBuffer(delayInSamples + 1);
+				fraction[i] = delayInFractionalSamples[tap + i] - delayInSamples;
+			}
+
+			if (interpolation == delayInterpolation::kNone)
+			{
+				for (unsigned int i = 0; i < count; i++)
+					output[tap + i] = y1[i];
+			}
+			else
+				doLinearInterpolation(&y1[0], &y2[0], &fraction[0], &output[tap], count);
+		}
+	}
+
+	/** read the next numFrames outputs of several fractional delay taps ahead of the numFrames writes that will follow;
+	    identical to interleaving readBuffer(double) and writeBuffer( ) calls, but only valid when no tap reaches a
+	    sample written inside the block, i.e. each delay is at least getShortestBlockDelay( ) */
+	/**
+	\param delayInFractionalSamples array of numTaps delay times, constant over the block
+	\param outputs numTaps arrays of numFrames values to receive the tap outputs
+	\param numTaps number of taps
+	\param numFrames number of frames to read ahead
+	\return false if a tap is too short for the block; nothing is read in that case
+	*/
+	bool readBuffer(const double* delayInFractionalSamples, double* const* outputs, unsigned int numTaps, unsigned int numFrames)
+	{
+		const double shortestDelay = getShortestBlockDelay(interpolation, numFrames);
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+		{
+			// --- written so that NaN also fails
+			if (!(delayInFractionalSamples[tap] >= shortestDelay))
+				return false;
+		}
+
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+		{
+			int delayInSamples = (int)delayInFractionalSamples[tap];
+			double fraction = delayInFractionalSamples[tap] - delayInSamples;
+			double* output = outputs[tap];
+
+			// --- recursive: one frame at a time
+			if (interpolation == delayInterpolation::kThiran && tap < kMaxThiranTaps)
+			{
+				if (fraction < 0.5 && delayInSamples > 0)
+				{
+					delayInSamples--;
+					fraction += 1.0;
+				}
+
+				unsigned int readIndex = (writeIndex - 1 - delayInSamples) & wrapMask;
+				for (unsigned int i = 0; i < numFrames; i++)
+					output[i] = doThiranInterpolation(buffer[(readIndex + i) & wrapMask], buffer[(readIndex + i - 1) & wrapMask], fraction, thiranState[tap]);
+				continue;
+			}
+
+			if (interpolation != delayInterpolation::kLinear && interpolation != delayInterpolation::kNone && interpolation != delayInterpolation::kThiran)
+			{
+				const unsigned int numTaps = getInterpolatorTaps(interpolation);
+				const unsigned int newerTaps = getInterpolatorNewerTaps(interpolation);
+				double coeffs[kMaxInterpolatorTaps];
+				calcInterpolatorCoefficients(interpolation, fraction, &coeffs[0]);
+
+				// --- location of the newest point for the first frame; advances by one per frame
+				unsigned int newestIndex = (writeIndex - 1 - delayInSamples + newerTaps) & wrapMask;
+
+				// --- contiguous fast path: no point wraps within the block
+				if (newestIndex >= numTaps - 1 && newestIndex + numFrames - 1 <= wrapMask)
+				{
+					doFIRInterpolation(&buffer[newestIndex], &coeffs[0], numTaps, &output[0], numFrames);
+					continue;
+				}
+
+				// --- wrapping run
+				T points[kMaxInterpolatorTaps];
+				for (unsigned int i = 0; i < numFrames; i++)
+				{
+					for (unsigned int j = 0; j < numTaps; j++)
+						points[numTaps - 1 - j] = buffer[(newestIndex + i - j) & wrapMask];
+					output[i] = doFIRInterpolation(&points[numTaps - 1], &coeffs[0], numTaps);
+				}
+				continue;
+			}
+
+			// --- location of readBuffer(delayInSamples) for the first frame; advances by one per frame
+			unsigned int readIndex = (writeIndex - 1 - delayInSamples) & wrapMask;
+
+			// --- contiguous fast path: neither this read nor the one-older read wraps within the block
+			if (readIndex >= 1 && readIndex + numFrames - 1 <= wrapMask)
+			{
+				if (interpolation == delayInterpolation::kNone)
+				{
+					for (unsigned int i = 0; i < numFrames; i++)
+						output[i] = buffer[readIndex + i];
+				}
+				else
+					doLinearInterpolation(&buffer[readIndex], &buffer[readIndex - 1], fraction, &output[0], numFrames);
+				continue;
+			}
+
+			// --- wrapping run
+			for (unsigned int i = 0; i < numFrames; i++)
+			{
+				T y1 = buffer[(readIndex + i) & wrapMask];
+				T y2 = buffer[(readIndex + i - 1) & wrapMask];
+				output[i] = interpolation == delayInterpolation::kNone ? y1 : fraction*y2 + (1.0 - fraction)*y1;
+			}
+		}
+
+		return true;
+	}
+
+	/** write a block of samples; same as numSamples writeBuffer( ) calls, done as at most two copies */
+	/**
+	\param input array of numSamples values, oldest first
+	\param numSamples number of samples
+	*/
+	void writeBlock(const T* input, unsigned int numSamples)
+	{
+		// --- only the newest bufferLength samples survive
+		if (numSamples > bufferLength)
+		{
+			writeIndex = (writeIndex + numSamples - bufferLength) & wrapMask;
+			input += numSamples - bufferLength;
+			numSamples = bufferLength;
+		}
+
+		// --- up to the end of the buffer, then from the top
+		unsigned int first = bufferLength - writeIndex < numSamples ? bufferLength - writeIndex : numSamples;
+		memcpy(&buffer[writeIndex], input, first * sizeof(T));
+		memcpy(&buffer[0], input + first, (numSamples - first) * sizeof(T));
+
+		writeIndex = (writeIndex + numSamples) & wrapMask;
+	}
+
+	/** read the next numSamples outputs of an integer delay ahead of the numSamples writes that will follow; identical
+	    to interleaving readBuffer(int) and writeBuffer( ) calls, done as at most two copies; only valid when the delay
+	    is at least (numSamples - 1) */
+	/**
+	\param output array to receive numSamples values
+	\param delayInSamples the delay
+	\param numSamples number of samples; at most the buffer length
+	\return false if the delay is too short or the block too long; nothing is read in that case
+	*/
+	bool readBlock(T* output, int delayInSamples, unsigned int numSamples)
+	{
+		if (delayInSamples < (int)numSamples - 1 || numSamples > bufferLength)
+			return false;
+
+		unsigned int readIndex = (writeIndex - 1 - delayInSamples) & wrapMask;
+		unsigned int first = bufferLength - readIndex < numSamples ? bufferLength - readIndex : numSamples;
+		memcpy(output, &buffer[readIndex], first * sizeof(T));
+		memcpy(output + first, &buffer[0], (numSamples - first) * sizeof(T));
+
+		return true;
+	}
+
+	/** read the next numSamples outputs of a moving fractional delay ahead of the numSamples writes that will follow;
+	    identical to interleaving readBuffer(double) and writeBuffer( ) calls, but only valid when no read reaches a
+	    sample written inside the block, i.e. delayInFractionalSamples[i] is at least i plus the interpolator's
+	    getInterpolatorNewerTaps( ) */
+	/**
+	\param output array to receive numSamples values
+	\param delayInFractionalSamples array of numSamples delay times, the trajectory over the block
+	\param numSamples number of samples
+	\return false if a delay is too short; nothing is read in that case
+	*/
+	bool readBlockFractional(double* output, const double* delayInFractionalSamples, unsigned int numSamples)
+	{
+		const double newerTaps = getInterpolatorNewerTaps(interpolation);
+		for (unsigned int i = 0; i < numSamples; i++)
+		{
+			// --- written so that NaN also fails
+			if (!(delayInFractionalSamples[i] >= i + newerTaps))
+				return false;
+		}
+
+		switch (interpolation)
+		{
+		case delayInterpolation::kNone: readBlockFractional<delayInterpolation::kNone>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kHermite: readBlockFractional<delayInterpolation::kHermite>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kLagrange3: readBlockFractional<delayInterpolation::kLagrange3>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kThiran: readBlockFractional<delayInterpolation::kThiran>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kSinc: readBlockFractional<delayInterpolation::kSinc>(output, delayInFractionalSamples, numSamples); break;
+		default: readBlockFractional<delayInterpolation::kLinear>(output, delayInFractionalSamples, numSamples); break;
+		}
+
+		return true;
+	}
+
+	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
+	void setInterpolate(bool b) { setInterpolation(b ? delayInterpolation::kLinear : delayInterpolation::kNone); }
+
+	/** select the fractional delay interpolator; the kThiran states restart */
+	void setInterpolation(delayInterpolation type)
+	{
+		if (type != interpolation)
+			memset(&thiranState[0], 0, sizeof(thiranState));
+		interpolation = type;
+	}
+
+	/** the fractional delay interpolator */
+	delayInterpolation getInterpolation() { return interpolation; }
+
+private:
+	/** readBlockFractional( ) with the interpolator fixed; sample i is i samples newer, so its delay from the
+	    current write position is i samples shorter (exact in double, so the reads match readBuffer(double)) */
+	template <delayInterpolation type>
+	void readBlockFractional(double* output, const double* delayInFractionalSamples, unsigned int numSamples)
+	{
+		for (unsigned int i = 0; i < numSamples; i++)
+			output[i] = readBufferInterpolated<type>(delayInFractionalSamples[i] - i);
+	}
+
+	/** one tap read with the run-time interpolator */
+	double readTap(double delayInFractionalSamples, unsigned int tap)
+	{
+		switch (interpolation)
+		{
+		case delayInterpolation::kLinear: return readBufferInterpolated<delayInterpolation::kLinear>(delayInFractionalSamples, tap);
+		case delayInterpolation::kNone: return readBufferInterpolated<delayInterpolation::kNone>(delayInFractionalSamples, tap);
+		case delayInterpolation::kHermite: return readBufferInterpolated<delayInterpolation::kHermite>(delayInFractionalSamples, tap);
+		case delayInterpolation::kLagrange3: return readBufferInterpolated<delayInterpolation::kLagrange3>(delayInFractionalSamples, tap);
+		case delayInterpolation::kThiran: return readBufferInterpolated<delayInterpolation::kThiran>(delayInFractionalSamples, tap);
+		case delayInterpolation::kSinc: return readBufferInterpolated<delayInterpolation::kSinc>(delayInFractionalSamples, tap);
+		default: return readBufferInterpolated<delayInterpolation::kLinear>(delayInFractionalSamples, tap);
+		}
+	}
+
+	std::unique_ptr<T[], DelayMemoryDeleter> buffer = nullptr;	///< smart pointer will return the memory to the arena
+	unsigned int capacity = 0;			///< allocated samples; bufferLength <= capacity
+	unsigned int writeIndex = 0;		///> write index
+	unsigned int bufferLength = 1024;	///< must be nearest power of 2
+	unsigned int wrapMask = 1023;		///< must be (bufferLength - 1)
+	delayInterpolation interpolation = delayInterpolation::kLinear;	///< fractional delay interpolator (default is linear)
+	double thiranState[kMaxThiranTaps] = { 0.0 };	///< kThiran allpass outputs, one per tap
+};
+
+/**
+\class ExactCircularBuffer
+\ingroup FX-Objects
+\brief
+The ExactCircularBuffer object is a drop-in alternative to CircularBuffer that allocates exactly the requested length
+instead of rounding up to a power of two (a 2 second buffer at 96kHz is 192001 samples instead of 262144). The wrap is
+branch-free, and the first guardLength samples are mirrored past the end so that interpolated and block reads are
+always contiguous.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+/** Layout: [0, bufferLength) is the ring, [bufferLength, bufferLength + guardLength) mirrors [0, guardLength)
+*/
+template <typename T>
+class ExactCircularBuffer
+{
+public:
+	ExactCircularBuffer() {}		/* C-TOR */
+	~ExactCircularBuffer() {}	/* D-TOR */
 
 	/** flush buffer by resetting all values to 0.0 */
-	void flushBuffer() { memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+	void flushBuffer()
+	{
+		memset(&buffer[0], 0, (bufferLength + guardLength) * sizeof(T));
+		memset(&thiranState[0], 0, sizeof(thiranState));
+	}
 
-	/** Create a buffer based on a target maximum in SAMPLES
+	/** the ring length for a maximum delay: the older points of the longest interpolator stay in the ring */
+	static unsigned int getRingLength(unsigned int _bufferLength) { return _bufferLength + kMaxInterpolatorTaps / 2; }
+
+	/** the mirrored samples for a block length: the block plus the extra points of the longest interpolator,
+	    at most the ring length */
+	static unsigned int getGuardLength(unsigned int _guardLength, unsigned int _ringLength)
+	{
+		unsigned int guard = (_guardLength < 1 ? 1 : _guardLength) + kMaxInterpolatorTaps - 2;
+		return guard < _ringLength ? guard : _ringLength;
+	}
+
+	/** the DelayMemoryArena bytes used by a buffer of _bufferLength samples */
+	static size_t getAllocationBytes(unsigned int _bufferLength, unsigned int _guardLength = 64)
+	{
+		unsigned int length = getRingLength(_bufferLength);
+		return DelayMemoryArena::getBlockSize((length + getGuardLength(_guardLength, length)) * sizeof(T));
+	}
+
+	/** Create a buffer based on a target maximum in SAMPLES; a few extra samples are kept so that the interpolated read
+	    of any delay shorter than _bufferLength stays in the ring
 	//	   do NOT call from realtime audio thread; do this prior to any processing */
-	void createLinearBuffer(unsigned int _bufferLength)
+	/**
+	\param _bufferLength the maximum delay in samples
+	\param _guardLength the longest block that readBuffer( ) may read ahead; this many samples, plus the extra points of
+	       the longest interpolator, are mirrored
+	*/
+	void createCircularBuffer(unsigned int _bufferLength, unsigned int _guardLength = 64)
 	{
-		// --- find nearest power of 2 for buffer, save it as bufferLength
-		bufferLength = _bufferLength;
+		// --- reset to top
+		writeIndex = 0;
+
+		// --- the fractional read needs at least one mirrored sample
+		bufferLength = getRingLength(_bufferLength);
+		guardLength = getGuardLength(_guardLength, bufferLength);
+
+		// --- create new buffer in the arena only if it does not fit in what we have;
+		//     give back the old one first so it can be reused
+		if (bufferLength + guardLength > capacity)
+		{
+			buffer.reset();
+			buffer.reset((T*)DelayMemoryArena::getInstance().allocate((bufferLength + guardLength) * sizeof(T)));
+			capacity = bufferLength + guardLength;
+		}
+
+		// --- flush the part in use
+		flushBuffer();
+	}
+
+	/** allocate storage for buffers up to _maxBufferLength samples; later createCircularBuffer( ) calls that fit
+	    (e.g. after a sample rate change) re-use it without allocating
+	//	   do NOT call from realtime audio thread */
+	void reserveCircularBuffer(unsigned int _maxBufferLength, unsigned int _guardLength = 64)
+	{
+		unsigned int length = getRingLength(_maxBufferLength);
+		unsigned int samples = length + getGuardLength(_guardLength, length);
+		if (samples <= capacity)
+			return;
+
+		// --- give back the old one first so it can be reused
+		buffer.reset();
+		buffer.reset((T*)DelayMemoryArena::getInstance().allocate(samples * sizeof(T)));
+		capacity = samples;
+
+		// --- the new storage holds nothing yet
+		writeIndex = 0;
+		if (bufferLength + guardLength <= capacity)
+			flushBuffer();
+	}
+
+	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
+	void writeBuffer(T input)
+	{
+		// --- write, and again into the guard region; for writes outside the mirrored span this writes the same slot twice
+		buffer[writeIndex] = input;
+		buffer[writeIndex + (bufferLength & -(int)(writeIndex < guardLength))] = input;
+
+		// --- increment and wrap
+		writeIndex++;
+		writeIndex -= bufferLength & -(int)(writeIndex >= bufferLength);
+	}
+
+	/** read an arbitrary location that is delayInSamples old */
+	T readBuffer(int delayInSamples)
+	{
+		// --- note: -1 here is because we read-before-write,
+		//           so the *last* write location is what we use for the calculation
+		return buffer[wrapIndex((int)writeIndex - 1 - delayInSamples)];
+	}
+
+	/** read an arbitrary location that includes a fractional sample, with the interpolator set by setInterpolation( ) */
+	double readBuffer(double delayInFractionalSamples)
+	{
+		return readTap(delayInFractionalSamples, 0);
+	}
+
+	/** read an arbitrary location that includes a fractional sample, with the interpolator fixed at compile time */
+	/**
+	\param delayInFractionalSamples the delay; at least getInterpolatorNewerTaps(type) samples
+	\param tap the kThiran allpass state to use; each tap read once per sample needs its own
+	\return the interpolated value
+	*/
+	template <delayInterpolation type>
+	double readBufferInterpolated(double delayInFractionalSamples, unsigned int tap = 0)
+	{
+		int delayInSamples = (int)delayInFractionalSamples;
+		double fraction = delayInFractionalSamples - delayInSamples;
+
+		if (type == delayInterpolation::kThiran && tap < kMaxThiranTaps)
+		{
+			// --- keep the allpass delay in [0.5, 1.5)
+			if (fraction < 0.5 && delayInSamples > 0)
+			{
+				delayInSamples--;
+				fraction += 1.0;
+			}
+		}
+
+		if (type == delayInterpolation::kNone || type == delayInterpolation::kLinear || type == delayInterpolation::kThiran)
+		{
+			// --- the sample one OLDER than the integer delay; its neighbour is always contiguous
+			unsigned int olderIndex = wrapIndex((int)writeIndex - 2 - delayInSamples);
+			T y1 = buffer[olderIndex + 1];
+
+			// --- if no interpolation, just return value
+			if (type == delayInterpolation::kNone) return y1;
+
+			if (type == delayInterpolation::kThiran && tap < kMaxThiranTaps)
+				return doThiranInterpolation(y1, buffer[olderIndex], fraction, thiranState[tap]);
+
+			// --- do the interpolation
+			return doLinearInterpolation(y1, buffer[olderIndex], fraction);
+		}
+
+		// --- FIR: the points run contiguously from the oldest one through the guard region
+		const unsigned int numTaps = getInterpolatorTaps(type);
+		double coeffs[kMaxInterpolatorTaps];
+		calcInterpolatorCoefficients(type, fraction, &coeffs[0]);
+
+		int oldestIndex = (int)wrapIndex((int)writeIndex - 1 - delayInSamples) - (int)(numTaps - 1 - getInterpolatorNewerTaps(type));
+		oldestIndex += oldestIndex < 0 ? (int)bufferLength : 0;
+
+		if (guardLength + 1 >= numTaps)
+			return doFIRInterpolation(&buffer[oldestIndex + numTaps - 1], &coeffs[0], numTaps);
+
+		// --- ring too short for the guard: gather the points oldest first, as they are stored
+		T points[kMaxInterpolatorTaps];
+		unsigned int index = (unsigned int)oldestIndex;
+		for (unsigned int i = 0; i < numTaps; i++)
+		{
+			points[i] = buffer[index];
+			index = index + 1 == bufferLength ? 0 : index + 1;
+		}
+
+		return doFIRInterpolation(&points[numTaps - 1], &coeffs[0], numTaps);
+	}
+
+	/** read several fractional delay taps for the current sample period; same result as calling readBuffer(double)
+	    once per tap, except that each tap keeps its own kThiran state */
+	/**
+	\param delayInFractionalSamples array of numTaps delay times
+	\param output array to receive numTaps tap values
+	\param numTaps number of taps
+	*/
+	void readBuffer(const double* delayInFractionalSamples, double* output, unsigned int numTaps)
+	{
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+			output[tap] = readTap(delayInFractionalSamples[tap], tap);
+	}
+
+	/** read the next numFrames outputs of several fractional delay taps ahead of the numFrames writes that will follow;
+	    see CircularBuffer; here every run is contiguous */
+	/**
+	\param delayInFractionalSamples array of numTaps delay times, constant over the block
+	\param outputs numTaps arrays of numFrames values to receive the tap outputs
+	\param numTaps number of taps
+	\param numFrames number of frames to read ahead; at most the guard length
+	\return false if a tap is too short for the block or the block is longer than the guard; nothing is read in that case
+	*/
+	bool readBuffer(const double* delayInFractionalSamples, double* const* outputs, unsigned int numTaps, unsigned int numFrames)
+	{
+		const unsigned int points = getInterpolatorTaps(interpolation);
+		if (numFrames + (points < 2 ? 2 : points) - 2 > guardLength)
+			return false;
+
+		const double shortestDelay = getShortestBlockDelay(interpolation, numFrames);
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+		{
+			// --- written so that NaN also fails
+			if (!(delayInFractionalSamples[tap] >= shortestDelay))
+				return false;
+		}
+
+		for (unsigned int tap = 0; tap < numTaps; tap++)
+		{
+			int delayInSamples = (int)delayInFractionalSamples[tap];
+			double fraction = delayInFractionalSamples[tap] - delayInSamples;
+			double* output = outputs[tap];
+
+			if (interpolation == delayInterpolation::kHermite || interpolation == delayInterpolation::kLagrange3 ||
+				interpolation == delayInterpolation::kSinc)
+			{
+				double coeffs[kMaxInterpolatorTaps];
+				calcInterpolatorCoefficients(interpolation, fraction, &coeffs[0]);
+
+				// --- oldest point of the first frame; the run to the newest point of the last frame is contiguous
+				int oldestIndex = (int)wrapIndex((int)writeIndex - 1 - delayInSamples) - (int)(points - 1 - getInterpolatorNewerTaps(interpolation));
+				oldestIndex += oldestIndex < 0 ? (int)bufferLength : 0;
+
+				doFIRInterpolation(&buffer[oldestIndex + points - 1], &coeffs[0], points, output, numFrames);
+				continue;
+			}
+
+			// --- recursive: one frame at a time
+			bool thiran = interpolation == delayInterpolation::kThiran && tap < kMaxThiranTaps;
+			if (thiran && fraction < 0.5 && delayInSamples > 0)
+			{
+				delayInSamples--;
+				fraction += 1.0;
+			}
+
+			const T* older = &buffer[wrapIndex((int)writeIndex - 2 - delayInSamples)];
+
+			if (interpolation == delayInterpolation::kNone)
+			{
+				for (unsigned int i = 0; i < numFrames; i++)
+					output[i] = older[i + 1];
+			}
+			else if (thiran)
+			{
+				for (unsigned int i = 0; i < numFrames; i++)
+					output[i] = doThiranInterpolation(older[i + 1], older[i], fraction, thiranState[tap]);
+			}
+			else
+				doLinearInterpolation(older + 1, older, fraction, output, numFrames);
+		}
+
+		return true;
+	}
+
+	/** write a block of samples; same as numSamples writeBuffer( ) calls, done as at most two copies plus the mirror */
+	/**
+	\param input array of numSamples values, oldest first
+	\param numSamples number of samples
+	*/
+	void writeBlock(const T* input, unsigned int numSamples)
+	{
+		// --- only the newest bufferLength samples survive
+		if (numSamples > bufferLength)
+		{
+			writeIndex = (writeIndex + numSamples - bufferLength) % bufferLength;
+			input += numSamples - bufferLength;
+			numSamples = bufferLength;
+		}
+
+		// --- up to the end of the ring, then from the top; each part also refreshes the mirrored span it covers
+		unsigned int first = bufferLength - writeIndex < numSamples ? bufferLength - writeIndex : numSamples;
+		memcpy(&buffer[writeIndex], input, first * sizeof(T));
+		if (writeIndex < guardLength)
+			memcpy(&buffer[bufferLength + writeIndex], input, (first < guardLength - writeIndex ? first : guardLength - writeIndex) * sizeof(T));
+
+		unsigned int second = numSamples - first;
+		memcpy(&buffer[0], input + first, second * sizeof(T));
+		memcpy(&buffer[bufferLength], input + first, (second < guardLength ? second : guardLength) * sizeof(T));
+
+		writeIndex += numSamples;
+		writeIndex -= bufferLength & -(int)(writeIndex >= bufferLength);
+	}
+
+	/** read the next numSamples outputs of an integer delay ahead of the numSamples writes that will follow; see
+	    CircularBuffer */
+	/**
+	\param output array to receive numSamples values
+	\param delayInSamples the delay; less than the ring length
+	\param numSamples number of samples; at most the ring length
+	\return false if the delay is too short or too long, or the block too long; nothing is read in that case
+	*/
+	bool readBlock(T* output, int delayInSamples, unsigned int numSamples)
+	{
+		if (delayInSamples < (int)numSamples - 1 || delayInSamples >= (int)bufferLength || numSamples > bufferLength)
+			return false;
+
+		unsigned int readIndex = wrapIndex((int)writeIndex - 1 - delayInSamples);
+		unsigned int first = bufferLength - readIndex < numSamples ? bufferLength - readIndex : numSamples;
+		memcpy(output, &buffer[readIndex], first * sizeof(T));
+		memcpy(output + first, &buffer[0], (numSamples - first) * sizeof(T));
+
+		return true;
+	}
+
+	/** read the next numSamples outputs of a moving fractional delay ahead of the numSamples writes that will follow;
+	    identical to interleaving readBuffer(double) and writeBuffer( ) calls, but only valid when no read reaches a
+	    sample written inside the block, i.e. delayInFractionalSamples[i] is at least i plus the interpolator's
+	    getInterpolatorNewerTaps( ) */
+	/**
+	\param output array to receive numSamples values
+	\param delayInFractionalSamples array of numSamples delay times, the trajectory over the block
+	\param numSamples number of samples
+	\return false if a delay is too short; nothing is read in that case
+	*/
+	bool readBlockFractional(double* output, const double* delayInFractionalSamples, unsigned int numSamples)
+	{
+		const double newerTaps = getInterpolatorNewerTaps(interpolation);
+		for (unsigned int i = 0; i < numSamples; i++)
+		{
+			// --- written so that NaN also fails
+			if (!(delayInFractionalSamples[i] >= i + newerTaps))
+				return false;
+		}
+
+		switch (interpolation)
+		{
+		case delayInterpolation::kNone: readBlockFractional<delayInterpolation::kNone>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kHermite: readBlockFractional<delayInterpolation::kHermite>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kLagrange3: readBlockFractional<delayInterpolation::kLagrange3>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kThiran: readBlockFractional<delayInterpolation::kThiran>(output, delayInFractionalSamples, numSamples); break;
+		case delayInterpolation::kSinc: readBlockFractional<delayInterpolation::kSinc>(output, delayInFractionalSamples, numSamples); break;
+		default: readBlockFractional<delayInterpolation::kLinear>(output, delayInFractionalSamples, numSamples); break;
+		}
+
+		return true;
+	}
+
+	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
+	void setInterpolate(bool b) { setInterpolation(b ? delayInterpolation::kLinear : delayInterpolation::kNone); }
+
+	/** select the fractional delay interpolator; the kThiran states restart */
+	void setInterpolation(delayInterpolation type)
+	{
+		if (type != interpolation)
+			memset(&thiranState[0], 0, sizeof(thiranState));
+		interpolation = type;
+	}
+
+	/** the fractional delay interpolator */
+	delayInterpolation getInterpolation() { return interpolation; }
+
+private:
+	/** readBlockFractional( ) with the interpolator fixed; sample i is i samples newer, so its delay from the
+	    current write position is i samples shorter (exact in double, so the reads match readBuffer(double)) */
+	template <delayInterpolation type>
+	void readBlockFractional(double* output, const double* delayInFractionalSamples, unsigned int numSamples)
+	{
+		for (unsigned int i = 0; i < numSamples; i++)
+			output[i] = readBufferInterpolated<type>(delayInFractionalSamples[i] - i);
+	}
+
+	/** one tap read with the run-time interpolator */
+	double readTap(double delayInFractionalSamples, unsigned int tap)
+	{
+		switch (interpolation)
+		{
+		case delayInterpolation::kLinear: return readBufferInterpolated<delayInterpolation::kLinear>(delayInFractionalSamples, tap);
+		case delayInterpolation::kNone: return readBufferInterpolated<delayInterpolation::kNone>(delayInFractionalSamples, tap);
+		case delayInterpolation::kHermite: return readBufferInterpolated<delayInterpolation::kHermite>(delayInFractionalSamples, tap);
+		case delayInterpolation::kLagrange3: return readBufferInterpolated<delayInterpolation::kLagrange3>(delayInFractionalSamples, tap);
+		case delayInterpolation::kThiran: return readBufferInterpolated<delayInterpolation::kThiran>(delayInFractionalSamples, tap);
+		case delayInterpolation::kSinc: return readBufferInterpolated<delayInterpolation::kSinc>(delayInFractionalSamples, tap);
+		default: return readBufferInterpolated<delayInterpolation::kLinear>(delayInFractionalSamples, tap);
+		}
+	}
+
+	/** branch-free wrap of an index in [-bufferLength, bufferLength) */
+	inline unsigned int wrapIndex(int index) const
+	{
+		return (unsigned int)(index + (int)(bufferLength & -(int)(index < 0)));
+	}
+
+	std::unique_ptr<T[], DelayMemoryDeleter> buffer = nullptr;	///< smart pointer will return the memory to the arena
+	unsigned int capacity = 0;			///< allocated samples; bufferLength + guardLength <= capacity
+	unsigned int writeIndex = 0;		///> write index
+	unsigned int bufferLength = 0;		///< ring length in samples
+	unsigned int guardLength = 0;		///< mirrored samples past the end of the ring
+	delayInterpolation interpolation = delayInterpolation::kLinear;	///< fractional delay interpolator (default is linear)
+	double thiranState[kMaxThiranTaps] = { 0.0 };	///< kThiran allpass outputs, one per tap
+};
+
+
+/**
+@dotProduct
+\ingroup FX-Functions
+
+@brief sum of x[i]*y[i] over two arrays; the inner loop of the direct form convolvers, uses AVX/SSE2 when available
+
+\param x - first array
+\param y - second array
+\param length - number of points
+\return the dot product
+*/
+inline double dotProduct(const double* x, const double* y, unsigned int length)
+{
+	unsigned int i = 0;
+	double sum = 0.0;
+
+#if defined FXOBJECTS_AVX
+	__m256d sum0 = _mm256_setzero_pd();
+	__m256d sum1 = _mm256_setzero_pd();
+	for (; i + 8 <= length; i += 8)
+	{
+		sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(&x[i]), _mm256_loadu_pd(&y[i])));
+		sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(&x[i + 4]), _mm256_loadu_pd(&y[i + 4])));
+	}
+	sum0 = _mm256_add_pd(sum0, sum1);
+	__m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+	sum = _mm_cvtsd_f64(_mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+#elif defined FXOBJECTS_SSE2
+	__m128d sum0 = _mm_setzero_pd();
+	__m128d sum1 = _mm_setzero_pd();
+	for (; i + 4 <= length; i += 4)
+	{
+		sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(&x[i]), _mm_loadu_pd(&y[i])));
+		sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(&x[i + 2]), _mm_loadu_pd(&y[i + 2])));
+	}
+	sum0 = _mm_add_pd(sum0, sum1);
+	sum = _mm_cvtsd_f64(_mm_add_sd(sum0, _mm_unpackhi_pd(sum0, sum0)));
+#endif
+	for (; i < length; i++)
+		sum += x[i] * y[i];
+	return sum;
+}
+
+/**
+@complexMultiply
+\ingroup FX-Functions
 
-		// --- create new buffer
-		buffer.reset(new T[bufferLength]);
+@brief output[k] = x[k]*h[k] over arrays of FFTW complex values (interleaved real, imag); uses AVX/SSE2 when
+available, with the same products and sums as complexMultiply( ) so that the result is identical. May be done in place.
 
-		// --- flush buffer
-		flushBuffer();
-	}
+\param output - the products
+\param x - first spectrum
+\param h - second spectrum
+\param length - number of complex points
+*/
+inline void complexMultiply(fxfft::complex* output, const fxfft::complex* x, const fxfft::complex* h, unsigned int length)
+{
+	unsigned int k = 0;
+	const double* xp = &x[0][0];
+	const double* hp = &h[0][0];
+	double* out = &output[0][0];
 
-	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
-	void writeBuffer(unsigned int index, T input)
+#if defined FXOBJECTS_AVX
+	for (; k + 2 <= length; k += 2)
 	{
-		if (index >= bufferLength) return;
-
-		// --- write and increment index counter
-		buffer[index] = input;
+		// --- two bins per vector: (xr*hr - xi*hi, xi*hr + xr*hi)
+		__m256d xv = _mm256_loadu_pd(&xp[2 * k]);
+		__m256d hv = _mm256_loadu_pd(&hp[2 * k]);
+		__m256d products = _mm256_mul_pd(xv, _mm256_movedup_pd(hv));
+		__m256d crossProducts = _mm256_mul_pd(_mm256_permute_pd(xv, 0x5), _mm256_permute_pd(hv, 0xF));
+		_mm256_storeu_pd(&out[2 * k], _mm256_addsub_pd(products, crossProducts));
 	}
-
-	/**  read an arbitrary location that is delayInSamples old */
-	T readBuffer(unsigned int index)//, bool readBeforeWrite = true)
+#endif
+#if defined FXOBJECTS_SSE2
+	// --- negate the real lane: SSE2 has no addsub
+	const __m128d negateReal = _mm_castsi128_pd(_mm_set_epi64x(0, (long long)0x8000000000000000ULL));
+	for (; k < length; k++)
 	{
-		if (index >= bufferLength) return 0.0;
-
-		// --- read it
-		return buffer[index];
+		__m128d xv = _mm_loadu_pd(&xp[2 * k]);
+		__m128d hv = _mm_loadu_pd(&hp[2 * k]);
+		__m128d products = _mm_mul_pd(xv, _mm_unpacklo_pd(hv, hv));
+		__m128d crossProducts = _mm_mul_pd(_mm_shuffle_pd(xv, xv, 1), _mm_unpackhi_pd(hv, hv));
+		_mm_storeu_pd(&out[2 * k], _mm_add_pd(products, _mm_xor_pd(crossProducts, negateReal)));
+	}
+#endif
+	for (; k < length; k++)
+	{
+		double real = xp[2 * k] * hp[2 * k] - xp[2 * k + 1] * hp[2 * k + 1];
+		double imag = xp[2 * k] * hp[2 * k + 1] + xp[2 * k + 1] * hp[2 * k];
+		out[2 * k] = real;
+		out[2 * k + 1] = imag;
 	}
+}
 
-private:
-	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
-	unsigned int bufferLength = 1024; ///< buffer length
-};
+/**
+@complexMultiplyAccumulate
+\ingroup FX-Functions
 
+@brief accumulator[k] += x[k]*h[k] over arrays of FFTW complex values (interleaved real, imag); the spectral
+product of the partitioned convolver. Uses AVX/SSE2 when available with the same arithmetic as the scalar loop.
+
+\param accumulator - the running sum
+\param x - first spectrum
+\param h - second spectrum
+\param length - number of complex points
+*/
+inline void complexMultiplyAccumulate(fxfft::complex* accumulator, const fxfft::complex* x, const fxfft::complex* h, unsigned int length)
+{
+	unsigned int k = 0;
+	const double* xp = &x[0][0];
+	const double* hp = &h[0][0];
+	double* acc = &accumulator[0][0];
+
+#if defined FXOBJECTS_AVX
+	for (; k + 2 <= length; k += 2)
+	{
+		__m256d xv = _mm256_loadu_pd(&xp[2 * k]);
+		__m256d hv = _mm256_loadu_pd(&hp[2 * k]);
+		__m256d products = _mm256_mul_pd(xv, _mm256_movedup_pd(hv));
+		__m256d crossProducts = _mm256_mul_pd(_mm256_permute_pd(xv, 0x5), _mm256_permute_pd(hv, 0xF));
+		__m256d sum = _mm256_add_pd(_mm256_loadu_pd(&acc[2 * k]), _mm256_addsub_pd(products, crossProducts));
+		_mm256_storeu_pd(&acc[2 * k], sum);
+	}
+#endif
+#if defined FXOBJECTS_SSE2
+	const __m128d negateReal = _mm_castsi128_pd(_mm_set_epi64x(0, (long long)0x8000000000000000ULL));
+	for (; k < length; k++)
+	{
+		__m128d xv = _mm_loadu_pd(&xp[2 * k]);
+		__m128d hv = _mm_loadu_pd(&hp[2 * k]);
+		__m128d products = _mm_mul_pd(xv, _mm_unpacklo_pd(hv, hv));
+		__m128d crossProducts = _mm_mul_pd(_mm_shuffle_pd(xv, xv, 1), _mm_unpackhi_pd(hv, hv));
+		__m128d product = _mm_add_pd(products, _mm_xor_pd(crossProducts, negateReal));
+		_mm_storeu_pd(&acc[2 * k], _mm_add_pd(_mm_loadu_pd(&acc[2 * k]), product));
+	}
+#endif
+	for (; k < length; k++)
+	{
+		acc[2 * k] += xp[2 * k] * hp[2 * k] - xp[2 * k + 1] * hp[2 * k + 1];
+		acc[2 * k + 1] += xp[2 * k] * hp[2 * k + 1] + xp[2 * k + 1] * hp[2 * k];
+	}
+}
 
 /**
-\class CircularBuffer
-\ingroup FX-Objects
+\class PartitionedConvolver
+\ingroup FFTW-Objects
 \brief
-The CircularBuffer object implements a simple circular buffer. It uses a wrap mask to wrap the read or write index quickly.
+The PartitionedConvolver object implements a uniformly partitioned overlap-save FFT convolver with a frequency-domain
+delay line (FDL), so that impulse responses many seconds long cost a few complex multiply-adds per sample instead of
+one multiply-add per tap.
+
+- the IR is split into partitions of B samples; each is stored as the spectrum of a 2B point real FFT
+- once per B input samples the newest input spectrum enters the FDL and the output block is the inverse FFT of
+  the sum of the FDL spectra times the partition spectra
+- zero latency mode: the first partition is run as a direct form FIR on the current input (the non-uniform head)
+  and the FFT partitions begin at the second, so that the FFT output is always one block ahead; otherwise the
+  latency is B samples and there is no per-sample FIR
+
+Audio I/O:
+- Processes mono input to mono output; sample or block (any length) processing.
+
+Control I/F:
+- initialize( ) with the partition length, then setImpulseResponse( ) with an IR of any length; both allocate
+  and so are not realtime safe
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-/** A simple cyclic buffer: NOTE - this is NOT an IAudioSignalProcessor or IAudioSignalGenerator
-	S must be a power of 2.
-*/
-template <typename T>
-class CircularBuffer
+class PartitionedConvolver
 {
 public:
-	CircularBuffer() {}		/* C-TOR */
-	~CircularBuffer() {}	/* D-TOR */
-
-							/** flush buffer by resetting all values to 0.0 */
-	void flushBuffer(){ memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+	PartitionedConvolver() {}		/* C-TOR */
+	~PartitionedConvolver() { destroyFFTW(); }	/* D-TOR */
 
-	/** Create a buffer based on a target maximum in SAMPLES
-	//	   do NOT call from realtime audio thread; do this prior to any processing */
-	void createCircularBuffer(unsigned int _bufferLength)
-	{
-		// --- find nearest power of 2 for buffer, and create
-		createCircularBufferPowerOfTwo((unsigned int)(pow(2, ceil(log(_bufferLength) / log(2)))));
-	}
+	/** set the partition length B (power of 2, the FFT length is 2B) and the latency mode; clears the IR */
+	void initialize(unsigned int _partitionLength, bool _zeroLatency = true);
 
-	/** Create a buffer based on a target maximum in SAMPLESwhere the size is
-	    pre-calculated as a power of two */
-	void createCircularBufferPowerOfTwo(unsigned int _bufferLengthPowerOfTwo)
-	{
-		// --- reset to top
-		writeIndex = 0;
+	/** load an impulse response of any length; the history is kept unless the partition count changes */
+	void setImpulseResponse(const double* irArray, unsigned int irLength);
 
-		// --- find nearest power of 2 for buffer, save it as bufferLength
-		bufferLength = _bufferLengthPowerOfTwo;
+	/** flush the input history, the FDL and the pending output; the IR is kept */
+	void reset();
 
-		// --- save (bufferLength - 1) for use as wrapping mask
-		wrapMask = bufferLength - 1;
+	/** process one input sample; the FFT work happens on every B-th call */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	double processAudioSample(double xn)
+	{
+		if (partitionLength == 0)
+			return 0.0;
 
-		// --- create new buffer
-		buffer.reset(new T[bufferLength]);
+		inputBlock[partitionLength + inputCount] = xn;
+		double yn = tailOutput[inputCount];
+		if (zeroLatency)
+			yn += dotProduct(&headReversed[0], &inputBlock[inputCount + 1], partitionLength);
 
-		// --- flush buffer
-		flushBuffer();
+		if (++inputCount == partitionLength)
+			processPartition();
+		return yn;
 	}
 
-	/** write a value into the buffer; this overwrites the previous oldest value in the buffer */
-	void writeBuffer(T input)
+	/** process a block of samples; runs are split at the partition boundaries. May be processed in place. */
+	/**
+	\param input - the input samples
+	\param output - the output samples
+	\param numSamples - number of samples
+	*/
+	template <typename InputType, typename OutputType>
+	void processAudioSamples(const InputType* input, OutputType* output, uint32_t numSamples)
 	{
-		// --- write and increment index counter
-		buffer[writeIndex++] = input;
-
-		// --- wrap if index > bufferlength - 1
-		writeIndex &= wrapMask;
-	}
+		if (partitionLength == 0)
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				output[i] = 0;
+			return;
+		}
 
-	/** read an arbitrary location that is delayInSamples old */
-	T readBuffer(int delayInSamples)//, bool readBeforeWrite = true)
-	{
-		// --- subtract to make read index
-		//     note: -1 here is because we read-before-write,
-		//           so the *last* write location is what we use for the calculation
-		int readIndex = (writeIndex - 1) - delayInSamples;
+		while (numSamples > 0)
+		{
+			uint32_t run = partitionLength - inputCount;
+			if (run > numSamples)
+				run = numSamples;
 
-		// --- autowrap index
-		readIndex &= wrapMask;
+			// --- copy the whole run first so that in-place processing works
+			double* blockInput = &inputBlock[partitionLength + inputCount];
+			for (uint32_t i = 0; i < run; i++)
+				blockInput[i] = input[i];
 
-		// --- read it
-		return buffer[readIndex];
-	}
+			for (uint32_t i = 0; i < run; i++)
+			{
+				double yn = tailOutput[inputCount + i];
+				if (zeroLatency)
+					yn += dotProduct(&headReversed[0], &inputBlock[inputCount + i + 1], partitionLength);
+				output[i] = (OutputType)yn;
+			}
 
-	/** read an arbitrary location that includes a fractional sample */
-	T readBuffer(double delayInFractionalSamples)
-	{
-		// --- truncate delayInFractionalSamples and read the int part
-		T y1 = readBuffer((int)delayInFractionalSamples);
+			inputCount += run;
+			input += run;
+			output += run;
+			numSamples -= run;
 
-		// --- if no interpolation, just return value
-		if (!interpolate) return y1;
+			if (inputCount == partitionLength)
+				processPartition();
+		}
+	}
 
-		// --- else do interpolation
-		//
-		// --- read the sample at n+1 (one sample OLDER)
-		T y2 = readBuffer((int)delayInFractionalSamples + 1);
+	/** latency in samples: 0 or the partition length */
+	unsigned int getLatency() { return zeroLatency ? 0 : partitionLength; }
 
-		// --- get fractional part
-		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+	/** the current partition length */
+	unsigned int getPartitionLength() { return partitionLength; }
 
-		// --- do the interpolation (you could try different types here)
-		return doLinearInterpolation(y1, y2, fraction);
+	/** a partition length for an IR: the power of 2 near sqrt(irLength) balances the direct form head against the FDL;
+	 *  clamped to [32, 4096] */
+	static unsigned int calculatePartitionLength(unsigned int irLength)
+	{
+		unsigned int length = 32;
+		while (length < 4096 && (uint64_t)length * length < irLength)
+			length *= 2;
+		return length;
 	}
 
-	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
-	void setInterpolate(bool b) { interpolate = b; }
+protected:
+	/** FFT the last two input blocks into the FDL and compute the next output block */
+	void processPartition();
 
-private:
-	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
-	unsigned int writeIndex = 0;		///> write index
-	unsigned int bufferLength = 1024;	///< must be nearest power of 2
-	unsigned int wrapMask = 1023;		///< must be (bufferLength - 1)
-	bool interpolate = true;			///< interpolation (default is ON)
-};
+	/** destroy the FFTW arrays and release the shared plans */
+	void destroyFFTW();
 
+	unsigned int partitionLength = 0;	///< B: samples per partition; the FFT length is 2B
+	unsigned int numBins = 0;			///< B + 1 bins of the real FFT
+	unsigned int numPartitions = 0;		///< partitions in the FDL (not counting the head in zero latency mode)
+	unsigned int fdlIndex = 0;			///< FDL slot of the newest input spectrum; older spectra follow it
+	unsigned int inputCount = 0;		///< samples written into the current input block
+	bool zeroLatency = true;			///< run the first partition as a direct form FIR
+
+	std::unique_ptr<double[]> inputBlock = nullptr;		///< 2B: the previous and the current input blocks
+	std::unique_ptr<double[]> tailOutput = nullptr;		///< B: FFT partition output for the current block
+	std::unique_ptr<double[]> headReversed = nullptr;	///< B: first partition of the IR, time reversed for the dot product
+
+	double* fftBuffer = nullptr;				///< 2B real FFT input/output
+	fxfft::complex* spectrum = nullptr;			///< B + 1 bins of FFT output
+	fxfft::complex* accumulator = nullptr;		///< B + 1 bins of spectral sum (destroyed by the inverse FFT)
+	fxfft::complex* fdl = nullptr;				///< numPartitions input spectra
+	fxfft::complex* irSpectra = nullptr;			///< numPartitions IR partition spectra, scaled by 1/2B
+	fxfft::plan planForward = nullptr;			///< r2c plan, shared from the FFTWPlanRegistry
+	fxfft::plan planBackward = nullptr;			///< c2r plan, shared from the FFTWPlanRegistry
+};
 
 /**
 \class ImpulseConvolver
 \ingroup FX-Objects
 \brief
-The ImpulseConvolver object implements a linear conovlver. NOTE: compile in Release mode or you may experice stuttering,
-glitching or other sample-drop activity.
+The ImpulseConvolver object implements a linear conovlver; it runs a zero latency PartitionedConvolver. NOTE: compile
+in Release mode or you may experice stuttering, glitching or other sample-drop activity.
+
+- construction does not allocate; the buffers and FFT plans are made by init( ) or the first setImpulseResponse( ),
+  once per IR length; until then the output is silent
 
 Audio I/O:
 - Processes mono input to mono output.
@@ -2407,82 +5333,66 @@ Control I/F:
 class ImpulseConvolver : public IAudioSignalProcessor
 {
 public:
-	ImpulseConvolver() {
-		init(512);
-	}		/* C-TOR */
+	ImpulseConvolver() {}		/* C-TOR */
 	~ImpulseConvolver() {}		/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
 		// --- flush signal buffer; IR buffer is static
-		signalBuffer.flushBuffer();
+		partitionedConvolver.reset();
 		return true;
 	}
 
-	/** process one input - note this is CPU intensive as it performs simple linear convolution */
+	/** process one input */
 	/**
 	\param xn input
 	\return the processed sample
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		double output = 0.0;
-
-		// --- write buffer; x(n) overwrites oldest value
-		//     this is the only time we do not read before write!
-		signalBuffer.writeBuffer(xn);
-
-		// --- do the convolution
-		for (unsigned int i = 0; i < length; i++)
-		{
-			// --- y(n) += x(n)h(n)
-			//     for signalBuffer.readBuffer(0) -> x(n)
-			//		   signalBuffer.readBuffer(n-D)-> x(n-D)
-			double signal = signalBuffer.readBuffer((int)i);
-			double irrrrr = irBuffer.readBuffer((int)i);
-			output += signal*irrrrr;
+		return partitionedConvolver.processAudioSample(xn);
+	}
 
-			//output += signalBuffer.readBuffer((int)i) * irBuffer.readBuffer((int)i);
-		}
+	/** process a block of mono samples */
+	virtual bool processAudioBlock(const float* const* inputs, float* const* outputs, uint32_t numFrames, uint32_t numChannels)
+	{
+		if (numChannels != 1)
+			return false;
 
-		return output;
+		partitionedConvolver.processAudioSamples(inputs[0], outputs[0], numFrames);
+		return true;
 	}
 
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** create the buffer based on the exact power of 2 */
+	/** create the buffers for an IR length, or just flush them if the length has not changed; need not be a power of 2 */
 	void init(unsigned int lengthPowerOfTwo)
 	{
+		if (lengthPowerOfTwo == length)
+		{
+			partitionedConvolver.reset();
+			return;
+		}
+
 		length = lengthPowerOfTwo;
 		// --- create (and clear out) the buffers
-		signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
-		irBuffer.createLinearBuffer(lengthPowerOfTwo);
+		partitionedConvolver.initialize(PartitionedConvolver::calculatePartitionLength(length), true);
 	}
 
 	/** set the impulse response */
 	void setImpulseResponse(double* irArray, unsigned int lengthPowerOfTwo)
 	{
 		if (lengthPowerOfTwo != length)
-		{
-			length = lengthPowerOfTwo;
-			// --- create (and clear out) the buffers
-			signalBuffer.createCircularBufferPowerOfTwo(lengthPowerOfTwo);
-			irBuffer.createLinearBuffer(lengthPowerOfTwo);
-		}
+			init(lengthPowerOfTwo);
 
 		// --- load up the IR buffer
-		for (unsigned int i = 0; i < length; i++)
-		{
-			irBuffer.writeBuffer(i, irArray[i]);
-		}
+		partitionedConvolver.setImpulseResponse(irArray, length);
 	}
 
 protected:
-	// --- delay buffer of doubles
-	CircularBuffer<double> signalBuffer; ///< circulat buffer for the signal
-	LinearBuffer<double> irBuffer;	///< linear buffer for the IR
+	PartitionedConvolver partitionedConvolver;	///< zero latency FFT convolver
 
 	unsigned int length = 0;	///< length of convolution (buffer)
 
@@ -2682,6 +5592,7 @@ struct AudioDelayParameters
 		leftDelay_mSec = params.leftDelay_mSec;
 		rightDelay_mSec = params.rightDelay_mSec;
 		delayRatio_Pct = params.delayRatio_Pct;
+		interpolation = params.interpolation;
 
 		return *this;
 	}
@@ -2696,13 +5607,14 @@ struct AudioDelayParameters
 	double leftDelay_mSec = 0.0;	///< left delay time
 	double rightDelay_mSec = 0.0;	///< right delay time
 	double delayRatio_Pct = 100.0;	///< dela ratio: right length = (delayRatio)*(left length)
+	delayInterpolation interpolation = delayInterpolation::kLinear;	///< fractional delay interpolator
 };
 
 /**
-\class AudioDelay
+\class AudioDelayT
 \ingroup FX-Objects
 \brief
-The AudioDelay object implements a stereo audio delay with multiple delay algorithms.
+The AudioDelayT object implements a stereo audio delay with multiple delay algorithms.
 
 Audio I/O:
 - Processes mono input to mono output OR stereo output.
@@ -2710,16 +5622,22 @@ Audio I/O:
 Control I/F:
 - Use AudioDelayParameters structure to get/set object params.
 
+Storage:
+- StorageType is the delay line sample type; all arithmetic is double. Use the AudioDelay (double)
+  or AudioDelayFloat (half the memory) typedefs.
+- DelayLine is CircularBuffer (power of two, the default) or ExactCircularBuffer (exact length).
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class AudioDelay : public IAudioSignalProcessor
+template <typename StorageType, template <typename> class DelayLine = CircularBuffer>
+class AudioDelayT : public IAudioSignalProcessor
 {
 public:
-	AudioDelay() {}		/* C-TOR */
-	~AudioDelay() {}	/* D-TOR */
+	AudioDelayT() {}		/* C-TOR */
+	~AudioDelayT() {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
@@ -2734,9 +5652,13 @@ public:
 			return true;
 		}
 
-		// --- create new buffer, will store sample rate and length(mSec)
+		// --- create new buffer, will store sample rate and length(mSec);
+		//     no allocation if reserveDelayBuffers( ) covered this rate
 		createDelayBuffers(_sampleRate, bufferLength_mSec);
 
+		// --- re-cook the delay times for the new rate
+		cookDelayTimes();
+
 		return true;
 	}
 
@@ -2747,11 +5669,14 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
+		// --- modulation ramps
+		advanceRamps();
+
 		// --- read delay
 		double yn = delayBuffer_L.readBuffer(delayInSamples_L);
 
 		// --- create input for delay buffer
-		double dn = xn + (parameters.feedback_Pct / 100.0) * yn;
+		double dn = xn + feedbackGain * yn;
 
 		// --- write to delay buffer
 		delayBuffer_L.writeBuffer(dn);
@@ -2798,6 +5723,9 @@ public:
 		// --- RIGHT channel (duplicate left input if mono-in)
 		double xnR = inputChannels > 1 ? inputFrame[1] : xnL;
 
+		// --- modulation ramps
+		advanceRamps();
+
 		// --- read delay LEFT
 		double ynL = delayBuffer_L.readBuffer(delayInSamples_L);
 
@@ -2805,10 +5733,10 @@ public:
 		double ynR = delayBuffer_R.readBuffer(delayInSamples_R);
 
 		// --- create input for delay buffer with LEFT channel info
-		double dnL = xnL + (parameters.feedback_Pct / 100.0) * ynL;
+		double dnL = xnL + feedbackGain * ynL;
 
 		// --- create input for delay buffer with RIGHT channel info
-		double dnR = xnR + (parameters.feedback_Pct / 100.0) * ynR;
+		double dnR = xnR + feedbackGain * ynR;
 
 		// --- decode
 		if (parameters.algorithm == delayAlgorithm::kNormal)
@@ -2843,6 +5771,103 @@ public:
 		return true;
 	}
 
+	/** process a block of non-interleaved audio; sample-identical to calling processAudioFrame( ) once per frame, but
+	    runs of frames are read ahead from the delay lines with readBlockFractional( ) and written with writeBlock( ) */
+	/**
+	\param inputs input buffers, inputs[channel][frame]
+	\param outputs output buffers, outputs[channel][frame]; may alias inputs
+	\param numFrames number of frames in each buffer
+	\param numChannels 1 = mono (left delay line only), 2 = stereo
+	\return true if processed
+	*/
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		if (numChannels == 0 || numChannels > 2)
+			return false;
+
+		// --- make sure we support this delay algorithm
+		if (parameters.algorithm != delayAlgorithm::kNormal &&
+			parameters.algorithm != delayAlgorithm::kPingPong)
+			return false;
+
+		bool pingPong = parameters.algorithm == delayAlgorithm::kPingPong;
+		uint32_t frame = 0;
+
+		while (frame < numFrames)
+		{
+			uint32_t runLength = getMaxRun();
+			runLength = numFrames - frame < runLength ? numFrames - frame : runLength;
+
+			// --- too short to be worth it: one frame at a time
+			if (runLength < 2)
+			{
+				float inputFrame[2] = { inputs[0][frame], numChannels > 1 ? inputs[1][frame] : 0.0f };
+				float outputFrame[2] = { 0.0, 0.0 };
+
+				// --- qualified call: statically bound, no per-frame virtual dispatch
+				AudioDelayT::processAudioFrame(inputFrame, outputFrame, numChannels, numChannels);
+
+				for (uint32_t j = 0; j < numChannels; j++)
+					outputs[j][frame] = outputFrame[j];
+				frame++;
+				continue;
+			}
+
+			// --- the ramps over the run, exactly as the frame processing steps them
+			for (uint32_t i = 0; i < runLength; i++)
+			{
+				advanceRamps();
+				runDelay[0][i] = delayInSamples_L;
+				runDelay[1][i] = delayInSamples_R;
+				runWetMix[i] = wetMix;
+				runDryMix[i] = dryMix;
+			}
+
+			// --- read ahead of the writes
+			delayBuffer_L.readBlockFractional(&runDelayed[0][0], &runDelay[0][0], runLength);
+			if (numChannels > 1)
+				delayBuffer_R.readBlockFractional(&runDelayed[1][0], &runDelay[1][0], runLength);
+
+			for (uint32_t i = 0; i < runLength; i++)
+			{
+				double xnL = inputs[0][frame + i];
+				double ynL = runDelayed[0][i];
+				double dnL = xnL + feedbackGain * ynL;
+
+				if (numChannels == 1)
+				{
+					runWrite[0][i] = (StorageType)dnL;
+					outputs[0][frame + i] = runDryMix[i] * xnL + runWetMix[i] * ynL;
+					continue;
+				}
+
+				double xnR = inputs[1][frame + i];
+				double ynR = runDelayed[1][i];
+				double dnR = xnR + feedbackGain * ynR;
+
+				// --- ping-pong crosses the delay line inputs
+				runWrite[0][i] = (StorageType)(pingPong ? dnR : dnL);
+				runWrite[1][i] = (StorageType)(pingPong ? dnL : dnR);
+
+				outputs[0][frame + i] = runDryMix[i] * xnL + runWetMix[i] * ynL;
+				outputs[1][frame + i] = runDryMix[i] * xnR + runWetMix[i] * ynR;
+			}
+
+			delayBuffer_L.writeBlock(&runWrite[0][0], runLength);
+			if (numChannels > 1)
+				delayBuffer_R.writeBlock(&runWrite[1][0], runLength);
+
+			frame += runLength;
+		}
+
+		return true;
+	}
+
+	static const uint32_t kAudioDelayBlockSize = 64;	///< longest run read ahead of the writes
+
 	/** get parameters: note use of custom structure for passing param data */
 	/**
 	\return AudioDelayParameters custom data structure
@@ -2855,14 +5880,117 @@ public:
 	*/
 	void setParameters(AudioDelayParameters _parameters)
 	{
-		// --- check mix in dB for calc
+		// --- check mix in dB for calc; a new level ends its ramp
 		if (_parameters.dryLevel_dB != parameters.dryLevel_dB)
-			dryMix = pow(10.0, _parameters.dryLevel_dB / 20.0);
+		{
+			dryMix = dryMixTarget = pow(10.0, _parameters.dryLevel_dB / 20.0);
+			dryMixInc = 0.0;
+		}
 		if (_parameters.wetLevel_dB != parameters.wetLevel_dB)
-			wetMix = pow(10.0, _parameters.wetLevel_dB / 20.0);
+		{
+			wetMix = wetMixTarget = pow(10.0, _parameters.wetLevel_dB / 20.0);
+			wetMixInc = 0.0;
+		}
+
+		// --- delay times are only re-cooked when they change, so that a delay set with setDelayInSamples( )
+		//     survives updates of the other parameters
+		bool newDelayTimes = _parameters.updateType != parameters.updateType ||
+							 _parameters.leftDelay_mSec != parameters.leftDelay_mSec ||
+							 _parameters.rightDelay_mSec != parameters.rightDelay_mSec ||
+							 _parameters.delayRatio_Pct != parameters.delayRatio_Pct;
 
 		// --- save; rest of updates are cheap on CPU
 		parameters = _parameters;
+		feedbackGain = parameters.feedback_Pct / 100.0;
+
+		delayBuffer_L.setInterpolation(parameters.interpolation);
+		delayBuffer_R.setInterpolation(parameters.interpolation);
+
+		if (newDelayTimes)
+			cookDelayTimes();
+	}
+
+	// --- low-level modulation interface: no parameter structures and no dB conversions; a later
+	//     setParameters( ) change of the same quantity takes over again
+
+	/** set the delay times directly */
+	/**
+	\param left left delay in (fractional) samples
+	\param right right delay in (fractional) samples
+	*/
+	void setDelayInSamples(double left, double right)
+	{
+		delayInSamples_L = delayTarget_L = left;
+		delayInSamples_R = delayTarget_R = right;
+		delayRampCount = 0;
+	}
+
+	/** glide the delay times linearly to new values; the last of the numSamples samples reads the new delay */
+	/**
+	\param left left delay in (fractional) samples
+	\param right right delay in (fractional) samples
+	\param numSamples ramp length; 0 jumps
+	*/
+	void rampDelayInSamples(double left, double right, uint32_t numSamples)
+	{
+		if (numSamples == 0)
+		{
+			setDelayInSamples(left, right);
+			return;
+		}
+
+		delayTarget_L = left;
+		delayTarget_R = right;
+		delayInc_L = (left - delayInSamples_L) / numSamples;
+		delayInc_R = (right - delayInSamples_R) / numSamples;
+		delayRampCount = numSamples;
+	}
+
+	/** set the wet and dry gains directly */
+	/**
+	\param wetGain linear wet gain
+	\param dryGain linear dry gain
+	*/
+	void setMixGains(double wetGain, double dryGain)
+	{
+		wetMix = wetMixTarget = wetGain;
+		dryMix = dryMixTarget = dryGain;
+		wetMixInc = dryMixInc = 0.0;
+		mixRampCount = 0;
+	}
+
+	/** ramp the wet and dry gains linearly to new values over numSamples samples */
+	/**
+	\param wetGain linear wet gain
+	\param dryGain linear dry gain
+	\param numSamples ramp length; 0 jumps
+	*/
+	void rampMixGains(double wetGain, double dryGain, uint32_t numSamples)
+	{
+		if (numSamples == 0)
+		{
+			setMixGains(wetGain, dryGain);
+			return;
+		}
+
+		wetMixTarget = wetGain;
+		dryMixTarget = dryGain;
+		wetMixInc = (wetGain - wetMix) / numSamples;
+		dryMixInc = (dryGain - dryMix) / numSamples;
+		mixRampCount = numSamples;
+	}
+
+	/** current left delay in (fractional) samples */
+	double getDelayInSamples_L() { return delayInSamples_L; }
+
+	/** current right delay in (fractional) samples */
+	double getDelayInSamples_R() { return delayInSamples_R; }
+
+private:
+	/** delay times from the parameters */
+	void cookDelayTimes()
+	{
+		delayRampCount = 0;
 
 		// --- check update type first:
 		if (parameters.updateType == delayUpdateType::kLeftAndRight)
@@ -2891,6 +6019,54 @@ public:
 		}
 	}
 
+	/** the longest run the delay lines can read ahead: every read, ramps included, must stay behind the run's writes */
+	uint32_t getMaxRun()
+	{
+		double shortestDelay = fmin(delayInSamples_L, delayInSamples_R);
+
+		// --- a ramp moves monotonically to its target; one sample of margin for the rounding of the increments
+		if (delayRampCount > 0)
+			shortestDelay = fmin(shortestDelay, fmin(delayTarget_L, delayTarget_R)) - 1.0;
+
+		shortestDelay -= getInterpolatorNewerTaps(parameters.interpolation);
+
+		uint32_t maxRun = kAudioDelayBlockSize;
+		if (!(shortestDelay + 1.0 >= (double)maxRun))
+			maxRun = shortestDelay >= 1.0 ? (uint32_t)shortestDelay + 1 : 1;
+
+		return maxRun;
+	}
+
+	/** advance the modulation ramps by one sample; each lands exactly on its target */
+	inline void advanceRamps()
+	{
+		if (delayRampCount > 0)
+		{
+			delayInSamples_L += delayInc_L;
+			delayInSamples_R += delayInc_R;
+
+			if (--delayRampCount == 0)
+			{
+				delayInSamples_L = delayTarget_L;
+				delayInSamples_R = delayTarget_R;
+			}
+		}
+
+		if (mixRampCount > 0)
+		{
+			wetMix += wetMixInc;
+			dryMix += dryMixInc;
+
+			if (--mixRampCount == 0)
+			{
+				wetMix = wetMixTarget;
+				dryMix = dryMixTarget;
+			}
+		}
+	}
+
+public:
+
 	/** creation function */
 	void createDelayBuffers(double _sampleRate, double _bufferLength_mSec)
 	{
@@ -2907,6 +6083,24 @@ public:
 		delayBuffer_R.createCircularBuffer(bufferLength);
 	}
 
+	/** allocate the buffers once for the highest sample rate; later resets at any rate up to it only flush
+	    the part in use; also sets the buffer length used by reset( ) */
+	void reserveDelayBuffers(double _maxSampleRate, double _bufferLength_mSec)
+	{
+		bufferLength_mSec = _bufferLength_mSec;
+		unsigned int maxLength = (unsigned int)(_bufferLength_mSec*(_maxSampleRate / 1000.0)) + 1;
+
+		delayBuffer_L.reserveCircularBuffer(maxLength);
+		delayBuffer_R.reserveCircularBuffer(maxLength);
+	}
+
+	/** DelayMemoryArena bytes used by createDelayBuffers( ) with these arguments; for DelayMemoryArena::reserve( ) */
+	static size_t getDelayMemoryBytes(double _sampleRate, double _bufferLength_mSec)
+	{
+		unsigned int length = (unsigned int)(_bufferLength_mSec*(_sampleRate / 1000.0)) + 1;
+		return 2 * DelayLine<StorageType>::getAllocationBytes(length);
+	}
+
 private:
 	AudioDelayParameters parameters; ///< object parameters
 
@@ -2918,12 +6112,35 @@ private:
 	unsigned int bufferLength = 0;	///< buffer length in samples
 	double wetMix = 0.707; ///< wet output default = -3dB
 	double dryMix = 0.707; ///< dry output default = -3dB
-
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer_L;	///< LEFT delay buffer of doubles
-	CircularBuffer<double> delayBuffer_R;	///< RIGHT delay buffer of doubles
+	double feedbackGain = 0.0;	///< feedback_Pct / 100
+
+	// --- modulation ramps
+	double delayTarget_L = 0.0;		///< left delay at the end of the ramp
+	double delayTarget_R = 0.0;		///< right delay at the end of the ramp
+	double delayInc_L = 0.0;		///< per-sample left delay increment
+	double delayInc_R = 0.0;		///< per-sample right delay increment
+	uint32_t delayRampCount = 0;	///< delay ramp samples remaining
+	double wetMixTarget = 0.707;	///< wet gain at the end of the ramp
+	double dryMixTarget = 0.707;	///< dry gain at the end of the ramp
+	double wetMixInc = 0.0;			///< per-sample wet gain increment
+	double dryMixInc = 0.0;			///< per-sample dry gain increment
+	uint32_t mixRampCount = 0;		///< mix ramp samples remaining
+
+	// --- processAudioBlock( ) runs
+	double runDelay[2][kAudioDelayBlockSize];		///< delay trajectories
+	double runDelayed[2][kAudioDelayBlockSize];		///< delay line outputs
+	StorageType runWrite[2][kAudioDelayBlockSize];	///< delay line inputs
+	double runWetMix[kAudioDelayBlockSize];			///< wet gain trajectory
+	double runDryMix[kAudioDelayBlockSize];			///< dry gain trajectory
+
+	// --- delay buffers
+	DelayLine<StorageType> delayBuffer_L;	///< LEFT delay buffer
+	DelayLine<StorageType> delayBuffer_R;	///< RIGHT delay buffer
 };
 
+typedef AudioDelayT<double> AudioDelay;			///< double storage
+typedef AudioDelayT<float> AudioDelayFloat;		///< float storage, double arithmetic
+
 
 /**
 \enum generatorWaveform
@@ -2988,10 +6205,10 @@ Control I/F:
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class LFO : public IAudioSignalGenerator
+class LFO : public IAudioSignalGenerator, public IModulationSource
 {
 public:
-	LFO() {	srand(time(NULL)); }	/* C-TOR */
+	LFO() {}			/* C-TOR */
 	virtual ~LFO() {}				/* D-TOR */
 
 	/** reset members to initialized state */
@@ -3029,6 +6246,9 @@ public:
 	/** render a new audio output structure */
 	virtual const SignalGenData renderAudioOutput();
 
+	/** IModulationSource: render the subscribed outputs, then advance hopSize samples */
+	virtual void renderControlPoint(uint32_t hopSize, uint32_t outputMask, double* values);
+
 protected:
 	// --- parameters
 	OscillatorParameters lfoParameters; ///< obejcgt parameters
@@ -3097,6 +6317,256 @@ protected:
 		y = P * (y * fabs(y) - y) + y;
 		return y;
 	}
+
+	/** the bipolar waveform at a modulo counter position [0.0, +1.0] */
+	inline double getWaveformValue(double moduloCounter)
+	{
+		if (lfoParameters.waveform == generatorWaveform::kSin)
+			return parabolicSine(-(moduloCounter*2.0*kPi - kPi));
+		else if (lfoParameters.waveform == generatorWaveform::kTriangle)
+			return 2.0*fabs(unipolarToBipolar(moduloCounter)) - 1.0;
+		else if (lfoParameters.waveform == generatorWaveform::kSaw)
+			return unipolarToBipolar(moduloCounter);
+
+		return 0.0;
+	}
+};
+
+/**
+\enum modulatorInterpolation
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to set how the ControlRateModulator fills in the samples between control points
+
+- enum class modulatorInterpolation { kLinear, kCubic };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class modulatorInterpolation { kLinear, kCubic };
+
+const uint32_t kModulatorControlPeriod = 16;	///< default samples between modulation source evaluations
+
+/**
+\struct ControlRateModulatorParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the ControlRateModulator object.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct ControlRateModulatorParameters
+{
+	ControlRateModulatorParameters() {}
+
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	ControlRateModulatorParameters& operator=(const ControlRateModulatorParameters& params)
+	{
+		if (this == &params)
+			return *this;
+
+		controlPeriod = params.controlPeriod;
+		interpolation = params.interpolation;
+		outputMask = params.outputMask;
+		return *this;
+	}
+
+	// --- individual parameters
+	uint32_t controlPeriod = kModulatorControlPeriod;	///< samples between source evaluations
+	modulatorInterpolation interpolation = modulatorInterpolation::kLinear; ///< fill between control points
+	uint32_t outputMask = 1u << kModNormal;				///< subscribed outputs, see modulatorOutputMask( )
+};
+
+/**
+\class ControlRateModulator
+\ingroup FX-Objects
+\brief
+The ControlRateModulator object evaluates a modulation source (LFO, SuperLFO, AudioDetector...) once per control period
+and interpolates the subscribed outputs back up to audio rate, so the source is not run every sample.
+
+Audio I/O:
+- Output only object: call advance( ) once per sample, then read the outputs with getOutput( ).
+
+Control I/F:
+- Use ControlRateModulatorParameters structure to get/set object params.
+- The source itself is reached with getSource( ); the modulator owns it.
+
+Interpolation:
+- kLinear ramps from the last control point to the next one; the source is evaluated one period ahead, so
+  generators are not delayed. Detectors cannot look ahead and lag by one period.
+- kCubic is a Catmull-Rom spline through the last four points; it needs one more point and so adds one period of delay.
+- Both run as a forward difference: three adds per subscribed output per sample.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+template <class ModulationSource>
+class ControlRateModulator
+{
+public:
+	ControlRateModulator() { updateActiveOutputs(); }	/* C-TOR */
+	~ControlRateModulator() {}							/* D-TOR */
+
+	/** reset the source and restart the control clock */
+	bool reset(double _sampleRate)
+	{
+		source.reset(_sampleRate);
+		restart();
+		return true;
+	}
+
+	/** restart the control clock; the next advance( ) evaluates the source afresh instead of ramping from the old value */
+	void restart()
+	{
+		controlCounter = 0;
+		primed = false;
+	}
+
+	/** the modulation source, for its parameters and (detectors) its input */
+	ModulationSource& getSource() { return source; }
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return ControlRateModulatorParameters custom data structure
+	*/
+	ControlRateModulatorParameters getParameters() { return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param ControlRateModulatorParameters custom data structure
+	*/
+	void setParameters(const ControlRateModulatorParameters& params)
+	{
+		bool newOutputs = params.outputMask != parameters.outputMask;
+
+		parameters = params;
+		if (parameters.controlPeriod == 0)
+			parameters.controlPeriod = 1;
+
+		// --- newly subscribed outputs have no history
+		if (newOutputs)
+		{
+			updateActiveOutputs();
+			restart();
+		}
+	}
+
+	/** move one sample ahead; the outputs for this sample are then read with getOutput( ) */
+	inline void advance()
+	{
+		if (controlCounter == 0)
+			updateControlPoint();
+
+		for (unsigned int i = 0; i < numActiveOutputs; i++)
+		{
+			unsigned int lane = activeOutputs[i];
+			output[lane] = value[lane];
+			value[lane] += delta1[lane];
+			delta1[lane] += delta2[lane];
+			delta2[lane] += delta3[lane];
+		}
+
+		controlCounter--;
+	}
+
+	/** a subscribed output for the current sample; unsubscribed outputs read 0.0 */
+	inline double getOutput(modulatorOutput which) const { return output[which]; }
+
+private:
+	/** evaluate the source and set up the interpolation to the next control point */
+	void updateControlPoint()
+	{
+		uint32_t hopSize = parameters.controlPeriod;
+		double point[kNumModulatorOutputs] = { 0.0 };
+
+		source.renderControlPoint(hopSize, parameters.outputMask, point);
+
+		// --- first point: nothing to come from, so it fills the history and the source is read one period ahead
+		if (!primed)
+		{
+			for (unsigned int i = 0; i < numActiveOutputs; i++)
+			{
+				unsigned int lane = activeOutputs[i];
+				history[lane][0] = history[lane][1] = history[lane][2] = history[lane][3] = point[lane];
+			}
+
+			source.renderControlPoint(hopSize, parameters.outputMask, point);
+			primed = true;
+		}
+
+		double h = 1.0 / hopSize;
+		double h2 = h * h;
+		double h3 = h2 * h;
+
+		for (unsigned int i = 0; i < numActiveOutputs; i++)
+		{
+			unsigned int lane = activeOutputs[i];
+			double* p = history[lane];
+
+			p[0] = p[1];
+			p[1] = p[2];
+			p[2] = p[3];
+			p[3] = point[lane];
+
+			if (parameters.interpolation == modulatorInterpolation::kCubic)
+			{
+				// --- Catmull-Rom segment p1 -> p2: y(t) = ((a*t + b)*t + c)*t + p1
+				double a = -0.5*p[0] + 1.5*p[1] - 1.5*p[2] + 0.5*p[3];
+				double b = p[0] - 2.5*p[1] + 2.0*p[2] - 0.5*p[3];
+				double c = 0.5*(p[2] - p[0]);
+
+				value[lane] = p[1];
+				delta1[lane] = a*h3 + b*h2 + c*h;
+				delta2[lane] = 6.0*a*h3 + 2.0*b*h2;
+				delta3[lane] = 6.0*a*h3;
+			}
+			else
+			{
+				value[lane] = p[2];
+				delta1[lane] = (p[3] - p[2])*h;
+				delta2[lane] = 0.0;
+				delta3[lane] = 0.0;
+			}
+		}
+
+		controlCounter = hopSize;
+	}
+
+	/** list the subscribed outputs so the per-sample loop skips the others */
+	void updateActiveOutputs()
+	{
+		numActiveOutputs = 0;
+		for (unsigned int i = 0; i < kNumModulatorOutputs; i++)
+		{
+			output[i] = 0.0;
+			if (parameters.outputMask & (1u << i))
+				activeOutputs[numActiveOutputs++] = i;
+		}
+	}
+
+	ControlRateModulatorParameters parameters;	///< object parameters
+	ModulationSource source;					///< the modulation source, evaluated at control rate
+
+	uint32_t controlCounter = 0;		///< samples until the next control point
+	bool primed = false;				///< history holds real control points
+
+	unsigned int activeOutputs[kNumModulatorOutputs] = { 0 };	///< subscribed outputs
+	unsigned int numActiveOutputs = 0;							///< number of subscribed outputs
+
+	// --- per output: the last four control points and the forward difference state
+	double history[kNumModulatorOutputs][4] = { { 0.0 } };	///< control points, oldest first
+	double output[kNumModulatorOutputs] = { 0.0 };			///< value for the current sample
+	double value[kNumModulatorOutputs] = { 0.0 };			///< value for the next sample
+	double delta1[kNumModulatorOutputs] = { 0.0 };			///< first forward difference
+	double delta2[kNumModulatorOutputs] = { 0.0 };			///< second forward difference
+	double delta3[kNumModulatorOutputs] = { 0.0 };			///< third forward difference
 };
 
 /**
@@ -3304,6 +6774,8 @@ struct ModulatedDelayParameters
 		enableSidechain = params.enableSidechain;
 		sidechainThresh_db = params.sidechainThresh_db;
 
+		interpolation = params.interpolation;
+
 		return *this;
 	}
 
@@ -3327,13 +6799,15 @@ struct ModulatedDelayParameters
 	// --- sidechain
 	double sidechainThresh_db = 0.0;
 	bool enableSidechain = false;
+
+	delayInterpolation interpolation = delayInterpolation::kLinear;	///< modulated read interpolator
 };
 
 /**
-\class ModulatedDelay
+\class ModulatedDelayT
 \ingroup FX-Objects
 \brief
-The ModulatedDelay object implements the three basic algorithms: flanger, chorus, vibrato.
+The ModulatedDelayT object implements the three basic algorithms: flanger, chorus, vibrato.
 
 Audio I / O :
 	-Processes mono input to mono OR stereo output.
@@ -3341,17 +6815,36 @@ Audio I / O :
 Control I / F :
 	-Use ModulatedDelayParameters structure to get / set object params.
 
+Storage :
+	-StorageType and DelayLine select the inner AudioDelayT; use the ModulatedDelay (double)
+	 or ModulatedDelayFloat typedefs.
+
 \author Will Pirkle http ://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed.by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class ModulatedDelay : public IAudioSignalProcessor
+template <typename StorageType, template <typename> class DelayLine = CircularBuffer>
+class ModulatedDelayT : public IAudioSignalProcessor
 {
 public:
-	ModulatedDelay() {
+	ModulatedDelayT() {
 	}		/* C-TOR */
-	~ModulatedDelay() {}	/* D-TOR */
+	~ModulatedDelayT() {}	/* D-TOR */
+
+	/** DelayMemoryArena bytes used after reset( ) at this sample rate; for DelayMemoryArena::reserve( ) */
+	static size_t getDelayMemoryBytes(double _sampleRate)
+	{
+		return AudioDelayT<StorageType, DelayLine>::getDelayMemoryBytes(_sampleRate, kModDelayBufferLength_mSec);
+	}
+
+	/** allocate the delay once for the highest sample rate so that resets do not allocate */
+	void reserveDelayBuffers(double _maxSampleRate)
+	{
+		delay.reserveDelayBuffers(_maxSampleRate, kModDelayBufferLength_mSec);
+	}
+
+	static constexpr double kModDelayBufferLength_mSec = 100.0;	///< long enough for the slowest chorus
 
 public:
 	/** reset members to initialized state */
@@ -3359,65 +6852,226 @@ public:
 	{
 		// --- create new buffer, 100mSec long
 		delay.reset(_sampleRate);
-		delay.createDelayBuffers(_sampleRate, 100.0);
+		delay.createDelayBuffers(_sampleRate, kModDelayBufferLength_mSec);
+
+		samplesPerMSec = _sampleRate / 1000.0;
 
 		// --- lfo
 		lfo.reset(_sampleRate);
-		OscillatorParameters params = lfo.getParameters();
-		params.waveform = generatorWaveform::kTriangle;
-		lfo.setParameters(params);
 
-		// --- detector
-		detector.reset(_sampleRate);
-		AudioDetectorParameters detectorParams = detector.getParameters();
-		detectorParams.clampToUnityMax = false;
-		detectorParams.detect_dB = true;
-		detectorParams.attackTime_mSec = 10.0;
-		detectorParams.releaseTime_mSec = 50.0;
-		detector.setParameters(detectorParams);
+		// --- detector
+		detector.reset(_sampleRate);
+		AudioDetectorParameters detectorParams = detector.getParameters();
+		detectorParams.clampToUnityMax = false;
+		detectorParams.detect_dB = false;	// --- compared against linear thresholds; no log/exp round trip
+		detectorParams.attackTime_mSec = 10.0;
+		detectorParams.releaseTime_mSec = 50.0;
+		detector.setParameters(detectorParams);
+
+		modLFO.reset(_sampleRate);
+		OscillatorParameters modparams = modLFO.getParameters();
+		modparams.waveform = generatorWaveform::kTriangle;
+		modLFO.setParameters(modparams);
+
+		// --- setParameters( ) only re-cooks on change, so restore the algorithm's LFO here
+		updateLFOParameters();
+
+		// --- the first control point jumps the delay and gains instead of ramping
+		controlCounter = 0;
+		modulationLive = false;
+
+		return true;
+	}
+
+	/** process input sample */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		float input = xn;
+		float output = 0.0;
+		processAudioFrame(&input, &output, 1, 1);
+		return output;
+	}
+
+	virtual double processAuxInputAudioSample(double xnL, double xnR)
+	{
+		sidechainInputSample[0] = xnL;
+		sidechainInputSample[1] = xnR;
+		return 0.0;
+	}
+
+	/** process the sidechain block by saving the buffer pointers for the upcoming processAudioBlock() call */
+	virtual void processAuxInputAudioBlock(const float* const* auxInputs, uint32_t numAuxChannels)
+	{
+		auxInputBlock = auxInputs;
+		numAuxInputChannels = numAuxChannels;
+	}
+
+	/** return true: this object can process frames */
+	virtual bool canProcessAudioFrame() { return true; }
+
+	/** process STEREO audio delay of frames */
+	virtual bool processAudioFrame(const float* inputFrame,		/* ptr to one frame of data: pInputFrame[0] = left, pInputFrame[1] = right, etc...*/
+		float* outputFrame,
+		uint32_t inputChannels,
+		uint32_t outputChannels)
+	{
+		// --- make sure we have input and outputs
+		if (inputChannels == 0 || outputChannels == 0)
+			return false;
+
+		// --- the envelope is followed at audio rate, everything else at control rate
+		detectFrame(inputFrame[0], inputChannels > 1 ? inputFrame[1] : 0.0);
+
+		// --- new delay and gain targets; the delay ramps to them over the control period
+		if (controlCounter == 0)
+		{
+			updateModulation();
+			controlCounter = kModulatorControlPeriod;
+		}
+		controlCounter--;
+
+		// --- just call the function and pass our info in/out
+		return delay.processAudioFrame(inputFrame, outputFrame, inputChannels, outputChannels);
+	}
+
+	/** process a block of non-interleaved audio; sample-identical to calling processAudioFrame( ) once per frame, but the
+	    delay processes whole control periods with AudioDelayT::processAudioBlock( ) */
+	/**
+	\param inputs input buffers, inputs[channel][frame]
+	\param outputs output buffers, outputs[channel][frame]; may alias inputs
+	\param numFrames number of frames in each buffer
+	\param numChannels 1 = mono (right detector input is silent), 2 = stereo
+	\return true if processed
+	*/
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		if (numChannels == 0 || numChannels > 2)
+			return false;
+
+		uint32_t frame = 0;
+		while (frame < numFrames)
+		{
+			// --- the first frame of a control period is followed before the modulators are evaluated
+			uint32_t firstFrame = 0;
+			if (controlCounter == 0)
+			{
+				detectBlockFrame(inputs, frame, numChannels);
+				updateModulation();
+				controlCounter = kModulatorControlPeriod;
+				firstFrame = 1;
+			}
+
+			// --- runs end at the control points
+			uint32_t runLength = numFrames - frame < controlCounter ? numFrames - frame : controlCounter;
+
+			// --- the rest of the envelope for the run; it only matters at the next control point
+			for (uint32_t i = firstFrame; i < runLength; i++)
+				detectBlockFrame(inputs, frame + i, numChannels);
+
+			const float* runInputs[2] = { inputs[0] + frame, numChannels > 1 ? inputs[1] + frame : nullptr };
+			float* runOutputs[2] = { outputs[0] + frame, numChannels > 1 ? outputs[1] + frame : nullptr };
+
+			// --- qualified call: statically bound
+			delay.AudioDelayT<StorageType, DelayLine>::processAudioBlock(runInputs, runOutputs, runLength, numChannels);
+
+			controlCounter -= runLength;
+			frame += runLength;
+		}
+
+		auxInputBlock = nullptr;
+		return true;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return ModulatedDelayParameters custom data structure
+	*/
+	ModulatedDelayParameters getParameters() { return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param ModulatedDelayParameters custom data structure
+	*/
+	void setParameters(ModulatedDelayParameters params)
+	{
+		// --- only re-cook the sub-objects whose settings actually changed
+		if (parameters.threshold_db != params.threshold_db)
+		{
+			parameters.threshold_db = params.threshold_db;
+			threshold_cooked = pow(10, parameters.threshold_db / 20);
+		}
+
+		if (parameters.sidechainThresh_db != params.sidechainThresh_db)
+		{
+			parameters.sidechainThresh_db = params.sidechainThresh_db;
+			scThreshold_cooked = pow(10, parameters.sidechainThresh_db / 20);
+		}
+
+		bool updateModLFO = parameters.modLFO_rateHz != params.modLFO_rateHz;
+		bool updateLFO = parameters.algorithm != params.algorithm ||
+						 parameters.lfoRate_Hz != params.lfoRate_Hz;
+		bool updateDelay = parameters.algorithm != params.algorithm ||
+						   parameters.feedback_Pct != params.feedback_Pct ||
+						   parameters.interpolation != params.interpolation;
+
+		parameters = params;
+
+		if (updateModLFO)
+		{
+			OscillatorParameters modLFOParams = modLFO.getParameters();
+			modLFOParams.frequency_Hz = params.modLFO_rateHz;
+			modLFO.setParameters(modLFOParams);
+		}
 
-		modLFO.reset(_sampleRate);
-		OscillatorParameters modparams = modLFO.getParameters();
-		modparams.waveform = generatorWaveform::kTriangle;
-		modLFO.setParameters(modparams);
+		if (updateLFO)
+			updateLFOParameters();
 
-		return true;
+		// --- only the flanger uses feedback
+		if (updateDelay)
+		{
+			AudioDelayParameters adParams = delay.getParameters();
+			adParams.feedback_Pct = parameters.algorithm == modDelaylgorithm::kFlanger ? parameters.feedback_Pct : 0.0;
+			adParams.interpolation = parameters.interpolation;
+			delay.setParameters(adParams);
+		}
 	}
 
-	/** process input sample */
-	/**
-	\param xn input
-	\return the processed sample
-	*/
-	virtual double processAudioSample(double xn)
+private:
+	/** follow the input or sidechain envelope for one frame; only needed when it modulates the wet level */
+	inline void detectFrame(double xnL, double xnR)
 	{
-		float input = xn;
-		float output = 0.0;
-		processAudioFrame(&input, &output, 1, 1);
-		return output;
+		if (parameters.enableModLFO)
+			return;
+
+		if (parameters.enableEnv)
+			detector.detectStereoLinkedSample(xnL, xnR);
+		else if (parameters.enableSidechain)
+			detector.detectStereoLinkedSample(sidechainInputSample[0], sidechainInputSample[1]);
 	}
 
-	virtual double processAuxInputAudioSample(double xnL, double xnR)
+	/** detectFrame( ) for one frame of the processAudioBlock( ) buffers; picks up the sidechain frame */
+	inline void detectBlockFrame(const float* const* inputs, uint32_t frame, uint32_t numChannels)
 	{
-		sidechainInputSample[0] = xnL;
-		sidechainInputSample[1] = xnR;
-		return 0.0;
-	}
+		// --- a mono sidechain leaves the right channel silent
+		if (auxInputBlock)
+		{
+			sidechainInputSample[0] = auxInputBlock[0][frame];
+			sidechainInputSample[1] = numAuxInputChannels > 1 ? auxInputBlock[1][frame] : 0.0;
+		}
 
-	/** return true: this object can process frames */
-	virtual bool canProcessAudioFrame() { return true; }
+		detectFrame(inputs[0][frame], numChannels > 1 ? inputs[1][frame] : 0.0);
+	}
 
-	/** process STEREO audio delay of frames */
-	virtual bool processAudioFrame(const float* inputFrame,		/* ptr to one frame of data: pInputFrame[0] = left, pInputFrame[1] = right, etc...*/
-		float* outputFrame,
-		uint32_t inputChannels,
-		uint32_t outputChannels)
+	/** evaluate the modulators at the start of a control period and send the delay its new targets */
+	void updateModulation()
 	{
-		// --- make sure we have input and outputs
-		if (inputChannels == 0 || outputChannels == 0)
-			return false;
-
-		
 		// --- volume modulation variable
 		double modVolume = -3.0;
 
@@ -3425,155 +7079,82 @@ public:
 		// --- Mod LFO
 		if (parameters.enableModLFO)
 		{
-			SignalGenData modLFOOutput = modLFO.renderAudioOutput();
+			double modValues[kNumModulatorOutputs];
+			modLFO.renderControlPoint(kModulatorControlPeriod, modulatorOutputMask(kModNormal), modValues);
+
 			double modDepth = parameters.modLFO_depthpct / 10;
-			double uniModulator = bipolarToUnipolar(modDepth * modLFOOutput.normalOutput);
+			double uniModulator = bipolarToUnipolar(modDepth * modValues[kModNormal]);
 			modVolume = doUnipolarModulationFromMax(uniModulator,
-			 	0, 20);
+				0, 20);
 			modVolume *= -1.0;
 		}
 
-		// --- envelope modulation
-		else if (parameters.enableEnv)
+		// --- envelope or sidechain modulation
+		else if (parameters.enableEnv || parameters.enableSidechain)
 		{
 			modVolume = -20.0;
-			double detect_db[2];
-			double detectValue[2];
-			double deltaValue[2];
+			double deltaValue = detector.getDetectedValue() - (parameters.enableEnv ? threshold_cooked : scThreshold_cooked);
 
-			for (int i = 0; i < 2; i++)
-			{
-				detect_db[i] = detector.processAudioSample(inputFrame[i]);
-				detectValue[i] = pow(10.0, detect_db[i] / 20.0);
-
-				deltaValue[i] = detectValue[i] - threshold_cooked;
-
-				if (deltaValue[i] >= 0.0)
-				{
-					modVolume = doUnipolarModulationFromMin(deltaValue[i] * parameters.envAmount, -20.0, 0.0);
-					//modVolume -= abs(parameters.threshold_db);
-				}
-			}
+			if (deltaValue >= 0.0)
+				modVolume = doUnipolarModulationFromMin(deltaValue * parameters.envAmount, -20.0, 0.0);
 		}
 
-		else if (parameters.enableSidechain)
-		{
-			modVolume = -20.0;
-			double detect_db[2];
-			double detectValue[2];
-			double deltaValue[2];
-
-			for (int i = 0; i < 2; i++)
-			{
-				detect_db[i] = detector.processAudioSample(sidechainInputSample[i]);
-				detectValue[i] = pow(10.0, detect_db[i] / 20.0);
-
-				deltaValue[i] = detectValue[i] - scThreshold_cooked;
+		// --- one dB conversion per control period
+		double wetGain = pow(10.0, modVolume / 20.0);
 
-				if (deltaValue[i] >= 0.0)
-				{
-					modVolume = doUnipolarModulationFromMin(deltaValue[i] * parameters.envAmount, -20.0, 0.0);
-					
-				}
-			}
-		}
-
-		// --- setup delay modulation
-		AudioDelayParameters params = delay.getParameters();
-		double minDelay_mSec = 0.0;
-		double maxDepth_mSec = 0.0;
+		// --- render LFO
+		double lfoValues[kNumModulatorOutputs];
+		lfo.renderControlPoint(kModulatorControlPeriod, modulatorOutputMask(kModNormal), lfoValues);
+		double delayModulator = bipolarToUnipolar(lfoValues[kModNormal] * lfoDepth);
 
+		// --- flanger - unipolar
+		double delay_mSec = 0.0;
+		if (parameters.algorithm == modDelaylgorithm::kFlanger)
+			delay_mSec = doUnipolarModulationFromMin(delayModulator, modulationMin_mSec, modulationMax_mSec);
+		else
+			delay_mSec = doBipolarModulation(unipolarToBipolar(delayModulator), modulationMin_mSec, modulationMax_mSec);
 
-		double depth = parameters.lfoDepth_Pct / 100;
+		// --- right delay matches the left (*Hint Homework!); the interpolator may need a minimum
+		double delayInSamples = fmax(delay_mSec*samplesPerMSec, (double)getInterpolatorNewerTaps(parameters.interpolation));
 
-		// --- set delay times, wet/dry and feedback
-		if (parameters.algorithm == modDelaylgorithm::kFlanger)
-		{
-			minDelay_mSec = 0.1;
-			maxDepth_mSec = 7.0;
-			params.wetLevel_dB = modVolume;
-			params.dryLevel_dB = -3.0;
-			depth = 0.3;
-		}
-		if (parameters.algorithm == modDelaylgorithm::kChorus)
+		if (modulationLive)
 		{
-			minDelay_mSec = 10.0;
-			maxDepth_mSec = 30.0;
-			params.wetLevel_dB = modVolume;
-			params.dryLevel_dB = -0.0;
-			params.feedback_Pct = 0.0;
-			depth = 0.70;
+			delay.rampDelayInSamples(delayInSamples, delayInSamples, kModulatorControlPeriod);
+			delay.rampMixGains(wetGain, dryGain, kModulatorControlPeriod);
 		}
-		if (parameters.algorithm == modDelaylgorithm::kVibrato)
+		else
 		{
-			minDelay_mSec = 0.0;
-			maxDepth_mSec = 7.0;
-			params.wetLevel_dB = modVolume;
-			params.dryLevel_dB = -96.0;
-			params.feedback_Pct = 0.0;
-			depth = 1.0;
+			delay.setDelayInSamples(delayInSamples, delayInSamples);
+			delay.setMixGains(wetGain, dryGain);
+			modulationLive = true;
 		}
-
-		
-		double delayModulator = 0.0;
-
-		// --- calc modulated delay times
-		double modulationMin = minDelay_mSec;
-		double modulationMax = minDelay_mSec + maxDepth_mSec;
-
-		// --- render LFO
-		SignalGenData lfoOutput = lfo.renderAudioOutput();
-		delayModulator = bipolarToUnipolar(lfoOutput.normalOutput * depth);
-	
-		
-		// --- flanger - unipolar
-		if (parameters.algorithm == modDelaylgorithm::kFlanger)
-			params.leftDelay_mSec = doUnipolarModulationFromMin(delayModulator,
-															     modulationMin, modulationMax);
-		else
-			params.leftDelay_mSec = doBipolarModulation(unipolarToBipolar(delayModulator), modulationMin, modulationMax);
-
-
-		// --- set right delay to match (*Hint Homework!)
-		params.rightDelay_mSec = params.leftDelay_mSec;
-
-		// --- modulate the delay
-		delay.setParameters(params);
-
-		// --- just call the function and pass our info in/out
-		return delay.processAudioFrame(inputFrame, outputFrame, inputChannels, outputChannels);
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return ModulatedDelayParameters custom data structure
-	*/
-	ModulatedDelayParameters getParameters() { return parameters; }
-
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param ModulatedDelayParameters custom data structure
-	*/
-	void setParameters(ModulatedDelayParameters params)
+	/** set the LFO waveform and rate, the delay range and the dry level for the current algorithm */
+	void updateLFOParameters()
 	{
-		// --- bulk copy
-		if (parameters.threshold_db != params.threshold_db)
+		// --- delay range, LFO depth and dry level
+		double maxDepth_mSec = 7.0;
+		if (parameters.algorithm == modDelaylgorithm::kFlanger)
 		{
-			parameters.threshold_db = params.threshold_db;
-			threshold_cooked = pow(10, parameters.threshold_db / 20);
+			modulationMin_mSec = 0.1;
+			lfoDepth = 0.3;
+			dryGain = pow(10.0, -3.0 / 20.0);
 		}
-
-		if (parameters.sidechainThresh_db != params.sidechainThresh_db)
+		else if (parameters.algorithm == modDelaylgorithm::kChorus)
 		{
-			parameters.sidechainThresh_db = params.sidechainThresh_db;
-			scThreshold_cooked = pow(10, parameters.sidechainThresh_db / 20);
+			modulationMin_mSec = 10.0;
+			maxDepth_mSec = 30.0;
+			lfoDepth = 0.70;
+			dryGain = 1.0;
 		}
-
-		parameters = params;
-
-		OscillatorParameters modLFOParams = modLFO.getParameters();
-		modLFOParams.frequency_Hz = params.modLFO_rateHz;
-		modLFO.setParameters(modLFOParams);
+		else if (parameters.algorithm == modDelaylgorithm::kVibrato)
+		{
+			modulationMin_mSec = 0.0;
+			lfoDepth = 1.0;
+			dryGain = pow(10.0, -96.0 / 20.0);
+		}
+		modulationMax_mSec = modulationMin_mSec + maxDepth_mSec;
 
 		OscillatorParameters lfoParams = lfo.getParameters();
 		lfoParams.frequency_Hz = parameters.lfoRate_Hz;
@@ -3587,30 +7168,39 @@ public:
 			lfoParams.waveform = generatorWaveform::kSin;
 			lfoParams.frequency_Hz = 0.5;
 		}
-			
-		
-			
 
 		lfo.setParameters(lfoParams);
-
-		AudioDelayParameters adParams = delay.getParameters();
-		adParams.feedback_Pct = parameters.feedback_Pct;
-		delay.setParameters(adParams);
 	}
 
 private:
 	ModulatedDelayParameters parameters; ///< object parameters
-	AudioDelay delay;	///< the delay to modulate
-	LFO lfo;			///< the modulator
+	AudioDelayT<StorageType, DelayLine> delay;	///< the delay to modulate
+	LFO lfo;				///< the modulator, evaluated once per control period
 	AudioDetector detector;
-	LFO modLFO;
+	LFO modLFO;				///< wet level modulator, evaluated once per control period
 
-	double sidechainInputSample[2];
+	double sidechainInputSample[2] = { 0.0, 0.0 };
+	const float* const* auxInputBlock = nullptr;	///< sidechain buffers for the next processAudioBlock( ) call
+	uint32_t numAuxInputChannels = 0;				///< sidechain channel count
 
 	double threshold_cooked = 0.0;
 	double scThreshold_cooked = 0.0;
+
+	// --- cooked per algorithm in updateLFOParameters( )
+	double modulationMin_mSec = 0.1;	///< shortest modulated delay
+	double modulationMax_mSec = 7.1;	///< longest modulated delay
+	double lfoDepth = 0.3;				///< LFO depth
+	double dryGain = 0.707;				///< linear dry level
+
+	// --- control rate
+	double samplesPerMSec = 0.0;		///< for the delay in samples
+	uint32_t controlCounter = 0;		///< samples left in the current control period
+	bool modulationLive = false;		///< false until the first control point after reset( )
 };
 
+typedef ModulatedDelayT<double> ModulatedDelay;			///< double storage
+typedef ModulatedDelayT<float> ModulatedDelayFloat;		///< float storage, double arithmetic
+
 /**
 \struct PhaseShifterParameters
 \ingroup FX-Objects
@@ -3686,9 +7276,9 @@ class PhaseShifter : public IAudioSignalProcessor
 {
 public:
 	PhaseShifter(void) {
-		OscillatorParameters lfoparams = lfo.getParameters();
+		OscillatorParameters lfoparams = lfo.getSource().getParameters();
 		lfoparams.waveform = generatorWaveform::kSin;// sine LFO for phaser
-		lfo.setParameters(lfoparams);
+		lfo.getSource().setParameters(lfoparams);
 
 		AudioFilterParameters params = apf[0].getParameters();
 		params.algorithm = filterAlgorithm::kAPF1;
@@ -3697,6 +7287,9 @@ public:
 		{
 			apf[i].setParameters(params);
 		}
+
+		// --- the APFs run as a cascade in the bank, lane i = APF i
+		apfBank.setNumLanes(PHASER_STAGES);
 	}	/* C-TOR */
 
 	~PhaseShifter(void) {}	/* D-TOR */
@@ -3712,6 +7305,7 @@ public:
 		for (int i = 0; i < PHASER_STAGES; i++){
 			apf[i].reset(_sampleRate);
 		}
+		apfBank.reset();
 
 		return true;
 	}
@@ -3723,66 +7317,46 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		SignalGenData lfoData = lfo.renderAudioOutput();
+		lfo.advance();
 
-		// --- create the bipolar modulator value
-		double lfoValue = lfoData.normalOutput;
-		if (parameters.quadPhaseLFO)
-			lfoValue = lfoData.quadPhaseOutput_pos;
+		// --- create the bipolar modulator value; only the output in use is subscribed
+		double lfoValue = lfo.getOutput(parameters.quadPhaseLFO ? kModQuadPhasePos : kModNormal);
 
 		double depth = parameters.lfoDepth_Pct / 100.0;
 		double modulatorValue = lfoValue*depth;
 
 		// --- calculate modulated values for each APF; note they have different ranges
-		AudioFilterParameters params = apf[0].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf0_minF, apf0_maxF);
-		apf[0].setParameters(params);
-
-		params = apf[1].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf1_minF, apf1_maxF);
-		apf[1].setParameters(params);
-
-		params = apf[2].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf2_minF, apf2_maxF);
-		apf[2].setParameters(params);
-
-		params = apf[3].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf3_minF, apf3_maxF);
-		apf[3].setParameters(params);
-
-		params = apf[4].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf4_minF, apf4_maxF);
-		apf[4].setParameters(params);
+		//     NOTE: setFcFast( ) only recalculates the fc-dependent APF1 coefficient, without tan( )
+		apf[0].setFcFast(doBipolarModulation(modulatorValue, apf0_minF, apf0_maxF));
+		apf[1].setFcFast(doBipolarModulation(modulatorValue, apf1_minF, apf1_maxF));
+		apf[2].setFcFast(doBipolarModulation(modulatorValue, apf2_minF, apf2_maxF));
+		apf[3].setFcFast(doBipolarModulation(modulatorValue, apf3_minF, apf3_maxF));
+		apf[4].setFcFast(doBipolarModulation(modulatorValue, apf4_minF, apf4_maxF));
+		apf[5].setFcFast(doBipolarModulation(modulatorValue, apf5_minF, apf5_maxF));
 
-		params = apf[5].getParameters();
-		params.fc = doBipolarModulation(modulatorValue, apf5_minF, apf5_maxF);
-		apf[5].setParameters(params);
+		for (int i = 0; i < PHASER_STAGES; i++)
+			apfBank.setCoefficients(i, apf[i].getCoefficients());
 
 		// --- calculate gamma values
-		double gamma1 = apf[5].getG_value();
-		double gamma2 = apf[4].getG_value() * gamma1;
-		double gamma3 = apf[3].getG_value() * gamma2;
-		double gamma4 = apf[2].getG_value() * gamma3;
-		double gamma5 = apf[1].getG_value() * gamma4;
-		double gamma6 = apf[0].getG_value() * gamma5;
+		double gamma1 = apfBank.getG_value(5);
+		double gamma2 = apfBank.getG_value(4) * gamma1;
+		double gamma3 = apfBank.getG_value(3) * gamma2;
+		double gamma4 = apfBank.getG_value(2) * gamma3;
+		double gamma5 = apfBank.getG_value(1) * gamma4;
+		double gamma6 = apfBank.getG_value(0) * gamma5;
 
 		// --- set the alpha0 value
 		double K = parameters.intensity_Pct / 100.0;
 		double alpha0 = 1.0 / (1.0 + K*gamma6);
 
 		// --- create combined feedback
-		double Sn = gamma5*apf[0].getS_value() + gamma4*apf[1].getS_value() + gamma3*apf[2].getS_value() + gamma2*apf[3].getS_value() + gamma1*apf[4].getS_value() + apf[5].getS_value();
+		double Sn = gamma5*apfBank.getS_value(0) + gamma4*apfBank.getS_value(1) + gamma3*apfBank.getS_value(2) + gamma2*apfBank.getS_value(3) + gamma1*apfBank.getS_value(4) + apfBank.getS_value(5);
 
 		// --- form input to first APF
 		double u = alpha0*(xn - K*Sn);
 
-		// --- cascade of APFs (could also nest these in one massive line of code)
-		double APF1 = apf[0].processAudioSample(u);
-		double APF2 = apf[1].processAudioSample(APF1);
-		double APF3 = apf[2].processAudioSample(APF2);
-		double APF4 = apf[3].processAudioSample(APF3);
-		double APF5 = apf[4].processAudioSample(APF4);
-		double APF6 = apf[5].processAudioSample(APF5);
+		// --- cascade of APFs; the global feedback through Sn means the stages cannot be interleaved
+		double APF6 = apfBank.processCascade(u);
 
 		// --- sum with -3dB coefficients
 		double output = 0.707*xn + 0.707*APF6;
@@ -3807,9 +7381,17 @@ public:
 		// --- update LFO rate
 		if (params.lfoRate_Hz != parameters.lfoRate_Hz)
 		{
-			OscillatorParameters lfoparams = lfo.getParameters();
+			OscillatorParameters lfoparams = lfo.getSource().getParameters();
 			lfoparams.frequency_Hz = params.lfoRate_Hz;
-			lfo.setParameters(lfoparams);
+			lfo.getSource().setParameters(lfoparams);
+		}
+
+		// --- subscribe to the LFO output that is read
+		if (params.quadPhaseLFO != parameters.quadPhaseLFO)
+		{
+			ControlRateModulatorParameters modulatorParams = lfo.getParameters();
+			modulatorParams.outputMask = modulatorOutputMask(params.quadPhaseLFO ? kModQuadPhasePos : kModNormal);
+			lfo.setParameters(modulatorParams);
 		}
 
 		// --- save new
@@ -3817,8 +7399,9 @@ public:
 	}
 protected:
 	PhaseShifterParameters parameters;  ///< the object parameters
-	AudioFilter apf[PHASER_STAGES];		///< six APF objects
-	LFO lfo;							///< the one and only LFO
+	AudioFilter apf[PHASER_STAGES];		///< six APF coefficient calculators
+	BiquadBank apfBank;					///< runs the six APFs
+	ControlRateModulator<LFO> lfo;		///< the one and only LFO, evaluated at control rate
 };
 
 /**
@@ -3954,10 +7537,10 @@ struct SimpleDelayParameters
 };
 
 /**
-\class SimpleDelay
+\class SimpleDelayT
 \ingroup FX-Objects
 \brief
-The SimpleDelay object implements a basic delay line without feedback.
+The SimpleDelayT object implements a basic delay line without feedback.
 
 Audio I/O:
 - Processes mono input to mono output.
@@ -3965,16 +7548,22 @@ Audio I/O:
 Control I/F:
 - Use SimpleDelayParameters structure to get/set object params.
 
+Storage:
+- StorageType is the delay line sample type; all arithmetic is double. Use the SimpleDelay (double)
+  or SimpleDelayFloat (half the memory) typedefs.
+- DelayLine is CircularBuffer (power of two, the default) or ExactCircularBuffer (exact length).
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-class SimpleDelay : public IAudioSignalProcessor
+template <typename StorageType, template <typename> class DelayLine = CircularBuffer>
+class SimpleDelayT : public IAudioSignalProcessor
 {
 public:
-	SimpleDelay(void) {}	/* C-TOR */
-	~SimpleDelay(void) {}	/* D-TOR */
+	SimpleDelayT(void) {}	/* C-TOR */
+	~SimpleDelayT(void) {}	/* D-TOR */
 
 public:
 	/** reset members to initialized state */
@@ -4052,6 +7641,21 @@ public:
 		delayBuffer.createCircularBuffer(bufferLength);
 	}
 
+	/** allocate the buffer once for the highest sample rate; later resets at any rate up to it only flush
+	    the part in use; also sets the buffer length used by reset( ) */
+	void reserveDelayBuffer(double _maxSampleRate, double _bufferLength_mSec)
+	{
+		bufferLength_mSec = _bufferLength_mSec;
+		delayBuffer.reserveCircularBuffer((unsigned int)(_bufferLength_mSec*(_maxSampleRate / 1000.0)) + 1);
+	}
+
+	/** DelayMemoryArena bytes used by createDelayBuffer( ) with these arguments; for DelayMemoryArena::reserve( ) */
+	static size_t getDelayMemoryBytes(double _sampleRate, double _bufferLength_mSec)
+	{
+		unsigned int length = (unsigned int)(_bufferLength_mSec*(_sampleRate / 1000.0)) + 1;
+		return DelayLine<StorageType>::getAllocationBytes(length);
+	}
+
 	/** read delay at current location */
 	double readDelay()
 	{
@@ -4091,10 +7695,13 @@ private:
 	double bufferLength_mSec = 0.0; ///< total buffer lenth in mSec
 	unsigned int bufferLength = 0;	///< buffer length in samples
 
-	// --- delay buffer of doubles
-	CircularBuffer<double> delayBuffer; ///< circular buffer for delay
+	// --- delay buffer
+	DelayLine<StorageType> delayBuffer; ///< circular buffer for delay
 };
 
+typedef SimpleDelayT<double> SimpleDelay;		///< double storage
+typedef SimpleDelayT<float> SimpleDelayFloat;	///< float storage, double arithmetic
+
 
 /**
 \struct CombFilterParameters
@@ -4362,14 +7969,14 @@ public:
 		// --- for modulated APFs
 		if (delayAPFParameters.enableLFO)
 		{
-			SignalGenData lfoOutput = modLFO.renderAudioOutput();
+			modLFO.advance();
 			double maxDelay = delayParams.delayTime_mSec;
 			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
 			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
 
 			// --- calc max-down modulated value with unipolar converted LFO output
 			//     NOTE: LFO output is scaled by lfoDepth
-			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
+			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*modLFO.getOutput(kModNormal)),
 				minDelay, maxDelay);
 
 			// --- read modulated value to get w(n-D);
@@ -4447,7 +8054,7 @@ protected:
 	SimpleDelay delay;						///< delay
 
 	// --- optional LFO
-	LFO modLFO;								///< LFO
+	ControlRateModulator<LFO> modLFO;		///< LFO, evaluated at control rate
 
 	// --- LPF support
 	double lpf_state = 0.0;					///< LPF state register (z^-1)
@@ -4560,7 +8167,7 @@ public:
 		// --- for modulated APFs
 		if (delayAPFParameters.enableLFO)
 		{
-			SignalGenData lfoOutput = modLFO.renderAudioOutput();
+			modLFO.advance();
 			double maxDelay = delayParams.delayTime_mSec;
 			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
 			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
@@ -4568,7 +8175,7 @@ public:
 
 			// --- calc max-down modulated value with unipolar converted LFO output
 			//     NOTE: LFO output is scaled by lfoDepth
-			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*lfoOutput.normalOutput),
+			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(lfoDepth*modLFO.getOutput(kModNormal)),
 				minDelay, maxDelay);
 
 			// --- read modulated value to get w(n-D);
@@ -4716,6 +8323,10 @@ public:
 		params = highShelfFilter.getParameters();
 		params.algorithm = filterAlgorithm::kHiShelf;
 		highShelfFilter.setParameters(params);
+
+		// --- the shelves are a two stage cascade in the bank: lane 0 = low shelf, lane 1 = high shelf
+		filterBank.setNumLanes(2);
+		updateFilterBank();
 	}		/* C-TOR */
 
 	~TwoBandShelvingFilter() {}		/* D-TOR */
@@ -4725,6 +8336,7 @@ public:
 	{
 		lowShelfFilter.reset(_sampleRate);
 		highShelfFilter.reset(_sampleRate);
+		filterBank.reset();
 		return true;
 	}
 
@@ -4738,11 +8350,21 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
-		// --- all modes do Full Wave Rectification
-		double filteredSignal = lowShelfFilter.processAudioSample(xn);
-		filteredSignal = highShelfFilter.processAudioSample(filteredSignal);
+		// --- low shelf, then high shelf
+		return filterBank.processCascade(xn);
+	}
+
+	/** process a mono block through the two filters; the shelves run interleaved, see BiquadBank::processCascadeBlock( ) */
+	virtual bool processAudioBlock(const float* const* inputs,
+								   float* const* outputs,
+								   uint32_t numFrames,
+								   uint32_t numChannels)
+	{
+		if (numChannels != 1)
+			return false; // NOT handled
 
-		return filteredSignal;
+		filterBank.processCascadeBlock(inputs[0], outputs[0], numFrames);
+		return true;
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
@@ -4770,12 +8392,22 @@ public:
 		filterParams.fc = parameters.highShelf_fc;
 		filterParams.boostCut_dB = parameters.highShelfBoostCut_dB;
 		highShelfFilter.setParameters(filterParams);
+
+		updateFilterBank();
 	}
 
 private:
 	TwoBandShelvingFilterParameters parameters; ///< object parameters
-	AudioFilter lowShelfFilter;					///< filter for low shelf
-	AudioFilter highShelfFilter;				///< filter for high shelf
+	AudioFilter lowShelfFilter;					///< coefficient calculator for low shelf
+	AudioFilter highShelfFilter;				///< coefficient calculator for high shelf
+	BiquadBank filterBank;						///< runs the two shelves in series
+
+	/** load the filter coefficients into the bank */
+	void updateFilterBank()
+	{
+		filterBank.setCoefficients(0, lowShelfFilter.getCoefficients());
+		filterBank.setCoefficients(1, highShelfFilter.getCoefficients());
+	}
 };
 
 /**
@@ -6043,11 +9675,13 @@ struct BitCrusherParameters
 			return *this;
 
 		quantizedBitDepth = params.quantizedBitDepth;
+		enableDither = params.enableDither;
 
 		return *this;
 	}
 
 	double quantizedBitDepth = 4.0; ///< bid depth of quantizer
+	bool enableDither = false;		///< add TPDF dither before quantizing
 };
 
 /**
@@ -6073,8 +9707,19 @@ public:
 	BitCrusher() {}		/* C-TOR */
 	~BitCrusher() {}		/* D-TOR */
 
-	/** reset members to initialized state */
-	virtual bool reset(double _sampleRate){ return true; }
+	/** reset members to initialized state; the dither restarts from its seed */
+	virtual bool reset(double _sampleRate)
+	{
+		ditherNoise.setSeed(seed);
+		return true;
+	}
+
+	/** set the dither seed; takes effect now and on every reset( ) */
+	void setSeed(uint64_t _seed)
+	{
+		seed = _seed;
+		ditherNoise.setSeed(seed);
+	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
@@ -6105,12 +9750,18 @@ public:
 	*/
 	virtual double processAudioSample(double xn)
 	{
+		// --- TPDF dither: two uniform values of +/-0.5 LSB each
+		if (parameters.enableDither)
+			xn += 0.5*QL*(ditherNoise.nextBipolar() + ditherNoise.nextBipolar());
+
 		return QL*(int(xn / QL));
 	}
 
 protected:
 	BitCrusherParameters parameters; ///< object parameters
 	double QL = 1.0;				 ///< the quantization level
+	FastRandom ditherNoise;			 ///< dither source
+	uint64_t seed = kDefaultRandomSeed; ///< dither seed
 };
 
 
@@ -8859,15 +12510,15 @@ inline std::unique_ptr<double[]> makeWindow(unsigned int windowLength, unsigned
 	return windowBuffer;
 }
 
-// --- FFTW ---
-#ifdef HAVE_FFTW
-#include "fftw3.h"
+// --- FFT objects: FFTW with HAVE_FFTW, otherwise the built-in RealFFT ---
 
 /**
 \class FastFFT
 \ingroup FFTW-Objects
 \brief
 The FastFFT provides a simple wrapper for the FFTW FFT operation - it is ultra-thin and simple to use.
+Audio is real valued, so the object uses the real-to-complex and complex-to-real transforms and stores
+only the non-redundant half of the spectrum: bins 0 to N/2, see getNumBins( ).
 
 Audio I/O:
 - processes mono inputs into FFT outputs.
@@ -8892,31 +12543,35 @@ public:
 	/** setup the FFT for a given framelength and window type*/
 	void initialize(unsigned int _frameLength, windowType _window);
 
-	/** destroy FFTW objects and plans */
+	/** destroy FFTW objects and release the shared plans */
 	void destroyFFTW();
 
-	/** do the FFT and return real and imaginary arrays */
-	fftw_complex* doFFT(double* inputReal, double* inputImag = nullptr);
+	/** do the FFT of real input and return the half spectrum: getNumBins( ) real and imaginary pairs */
+	fxfft::complex* doFFT(double* inputReal);
 
-	/** do the IFFT and return real and imaginary arrays */
-	fftw_complex* doInverseFFT(double* inputReal, double* inputImag);
+	/** do the IFFT of a half spectrum (getNumBins( ) real and imaginary parts) and return the real output */
+	double* doInverseFFT(double* inputReal, double* inputImag);
 
 	/** get the current FFT length */
 	unsigned int getFrameLength() { return frameLength; }
 
+	/** get the number of bins in the half spectrum, N/2 + 1 */
+	unsigned int getNumBins() { return numBins; }
+
 protected:
 	// --- setup FFTW
-	fftw_complex*	fft_input = nullptr;		///< array for FFT input
-	fftw_complex*	fft_result = nullptr;		///< array for FFT output
-	fftw_complex*	ifft_input = nullptr;		///< array for IFFT input
-	fftw_complex*	ifft_result = nullptr;		///< array for IFFT output
-	fftw_plan       plan_forward = nullptr;		///< FFTW plan for FFT
-	fftw_plan		plan_backward = nullptr;	///< FFTW plan for IFFT
+	double*			fft_input = nullptr;		///< array for FFT input (real)
+	fxfft::complex*	fft_result = nullptr;		///< array for FFT output (half spectrum)
+	fxfft::complex*	ifft_input = nullptr;		///< array for IFFT input (half spectrum)
+	double*			ifft_result = nullptr;		///< array for IFFT output (real)
+	fxfft::plan       plan_forward = nullptr;		///< FFTW plan for FFT, shared from the FFTWPlanRegistry
+	fxfft::plan		plan_backward = nullptr;	///< FFTW plan for IFFT, shared from the FFTWPlanRegistry
 
 	double* windowBuffer = nullptr;				///< buffer for window (naked)
 	double windowGainCorrection = 1.0;			///< window gain correction
 	windowType window = windowType::kHannWindow; ///< window type
 	unsigned int frameLength = 0;				///< current FFT length
+	unsigned int numBins = 0;					///< N/2 + 1 bins of the half spectrum
 };
 
 
@@ -8926,7 +12581,8 @@ protected:
 \brief
 The PhaseVocoder provides a basic phase vocoder that is initialized to N = 4096 and
 75% overlap; the de-facto standard for PSM algorithms. The analysis and sythesis
-hop sizes are identical.
+hop sizes are identical. The FFT is real-to-complex: the FFT data is the half spectrum
+of getNumBins( ) = N/2 + 1 bins and the IFFT data is the real valued frame.
 
 Audio I/O:
 - processes mono input into mono output.
@@ -8953,7 +12609,7 @@ public:
 	/** setup the FFT for a given framelength and window type*/
 	void initialize(unsigned int _frameLength, unsigned int _hopSize, windowType _window);
 
-	/** destroy FFTW objects and plans */
+	/** destroy FFTW objects and release the shared plans */
 	void destroyFFTW();
 
 	/** process audio sample through vocode; check fftReady flag to access FFT output */
@@ -8965,11 +12621,11 @@ public:
 	/** increment the FFT counter and do the FFT if it is ready */
 	bool advanceAndCheckFFT();
 
-	/** get FFT data for manipulation (yes, naked pointer so you can manipulate) */
-	fftw_complex* getFFTData() { return fft_result; }
+	/** get FFT data for manipulation (yes, naked pointer so you can manipulate); bins 0 to N/2 only */
+	fxfft::complex* getFFTData() { return fft_result; }
 
-	/** get IFFT data for manipulation (yes, naked pointer so you can manipulate) */
-	fftw_complex* getIFFTData() { return ifft_result; }
+	/** get IFFT data for manipulation (yes, naked pointer so you can manipulate); N real values */
+	double* getIFFTData() { return ifft_result; }
 
 	/** do the inverse FFT (optional; will be called automatically if not used) */
 	void doInverseFFT();
@@ -8980,6 +12636,9 @@ public:
 	/** get current FFT length */
 	unsigned int getFrameLength() { return frameLength; }
 
+	/** get the number of bins in the half spectrum, N/2 + 1 */
+	unsigned int getNumBins() { return numBins; }
+
 	/** get current hop size ha = hs */
 	unsigned int getHopSize() { return hopSize; }
 
@@ -8993,11 +12652,12 @@ public:
 
 protected:
 	// --- setup FFTW
-	fftw_complex*	fft_input = nullptr;		///< array for FFT input
-	fftw_complex*	fft_result = nullptr;		///< array for FFT output
-	fftw_complex*	ifft_result = nullptr;		///< array for IFFT output
-	fftw_plan       plan_forward = nullptr;		///< FFTW plan for FFT
-	fftw_plan		plan_backward = nullptr;	///< FFTW plan for IFFT
+	double*			fft_input = nullptr;		///< array for FFT input (real)
+	fxfft::complex*	fft_result = nullptr;		///< array for FFT output (half spectrum)
+	fxfft::complex*	ifft_input = nullptr;		///< copy of fft_result for the IFFT, which overwrites its input
+	double*			ifft_result = nullptr;		///< array for IFFT output (real)
+	fxfft::plan       plan_forward = nullptr;		///< FFTW plan for FFT, shared from the FFTWPlanRegistry
+	fxfft::plan		plan_backward = nullptr;	///< FFTW plan for IFFT, shared from the FFTWPlanRegistry
 
 	// --- linear buffer for window
 	double*			windowBuffer = nullptr;		///< array for window
@@ -9027,6 +12687,7 @@ protected:
 
 	// --- counters
 	unsigned int frameLength = 0;				///< current FFT length
+	unsigned int numBins = 0;					///< N/2 + 1 bins of the half spectrum
 	unsigned int fftCounter = 0;				///< FFT sample counter
 
 	// --- hop-size and overlap (mathematically related)
@@ -9045,7 +12706,8 @@ protected:
 \brief
 The FastConvolver provides a fast convolver - the user supplies the filter IR and the object
 snapshots the FFT of that filter IR. Input audio is fast-convovled with the filter FFT using
-complex multiplication and zero-padding.
+complex multiplication and zero-padding. Only the half spectrum (filterImpulseLength + 1 bins)
+is stored and multiplied.
 
 Audio I/O:
 - processes mono input into mono output.
@@ -9069,7 +12731,7 @@ public:
 			delete[] filterIR;
 
 		if (filterFFT)
-			fftw_free(filterFFT);
+			fxfft::release(filterFFT);
 	}	/* D-TOR */
 
 	/** setup the FFT for a given IR length */
@@ -9096,16 +12758,16 @@ public:
 
 		// --- allocate the filter FFT arrays
 		if(filterFFT)
-			fftw_free(filterFFT);
+			fxfft::release(filterFFT);
 
-		 filterFFT = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * filterImpulseLength * 2);
+		 filterFFT = (fxfft::complex*)fxfft::allocate(sizeof(fxfft::complex) * (filterImpulseLength + 1));
 
 		 // --- reset
 		 inputCount = 0;
 	}
 
 	/** setup the filter IRirBuffer MUST be exactly filterImpulseLength in size, or this will crash! */
-	void setFilterIR(double* irBuffer)
+	void setFilterIR(const double* irBuffer)
 	{
 		if (!irBuffer) return;
 
@@ -9119,19 +12781,12 @@ public:
 		}
 
 		// --- take FFT of the h(n)
-		fftw_complex* fftOfFilter = filterFastFFT.doFFT(&filterIR[0]);
+		fxfft::complex* fftOfFilter = filterFastFFT.doFFT(&filterIR[0]);
 
-		// --- copy the FFT into our local buffer for storage; also
+		// --- copy the half spectrum into our local buffer for storage; also
 		//     we never want to hold a pointer to a FFT output
 		//     for more than one local function's worth
-		//     could replace with memcpy( )
-		for (int i = 0; i < 2; i++)
-		{
-			for (unsigned int j = 0; j < filterImpulseLength * 2; j++)
-			{
-				filterFFT[j][i] = fftOfFilter[j][i];
-			}
-		}
+		memcpy(filterFFT, fftOfFilter, (filterImpulseLength + 1) * sizeof(fxfft::complex));
 	}
 
 	/** process an input sample through convolver */
@@ -9147,25 +12802,11 @@ public:
 			if (fftReady) // should happen on time
 			{
 				// --- multiply our filter IR with the vocoder FFT
-				fftw_complex* signalFFT = vocoder.getFFTData();
+				fxfft::complex* signalFFT = vocoder.getFFTData();
 				if (signalFFT)
 				{
-					unsigned int fff = vocoder.getFrameLength();
-
-					// --- complex multiply with FFT of IR
-					for (unsigned int i = 0; i < filterImpulseLength * 2; i++)
-					{
-						// --- get real/imag parts of each FFT
-						ComplexNumber signal(signalFFT[i][0], signalFFT[i][1]);
-						ComplexNumber filter(filterFFT[i][0], filterFFT[i][1]);
-
-						// --- use complex multiply function; this convolves in the time domain
-						ComplexNumber product = complexMultiply(signal, filter);
-
-						// --- overwrite the FFT bins
-						signalFFT[i][0] = product.real;
-						signalFFT[i][1] = product.imag;
-					}
+					// --- complex multiply with FFT of IR, overwriting the FFT bins; this convolves in the time domain
+					complexMultiply(signalFFT, signalFFT, filterFFT, filterImpulseLength + 1);
 				}
 			}
 
@@ -9189,7 +12830,7 @@ public:
 protected:
 	PhaseVocoder vocoder;				///< vocoder object
 	FastFFT filterFastFFT;				///< FastFFT object
-	fftw_complex* filterFFT = nullptr;	///< filterFFT output arrays
+	fxfft::complex* filterFFT = nullptr;	///< filterFFT output arrays: the half spectrum
 	double* filterIR = nullptr;			///< filter IR
 	unsigned int inputCount = 0;		///< input sample counter
 	unsigned int filterImpulseLength = 0;///< IR length
@@ -9197,6 +12838,7 @@ protected:
 
 // --- PSM Vocoder
 const unsigned int PSM_FFT_LEN = 4096;
+const unsigned int PSM_FFT_BINS = PSM_FFT_LEN / 2 + 1;	///< bins in the half spectrum of the real FFT
 
 /**
 \struct BinData
@@ -9383,7 +13025,7 @@ public:
 
 		int delta = -1;
 		int previousPeak = -1;
-		for (int i = 0; i < PSM_FFT_LEN; i++)
+		for (int i = 0; i < PSM_FFT_BINS; i++)
 		{
 			if (peakBinsPrevious[i] < 0)
 				break;
@@ -9415,7 +13057,7 @@ public:
 		// --- find local maxima in 4-sample window
 		double localWindow[4] = { 0.0 };
 		int m = 0;
-		for (int i = 0; i < PSM_FFT_LEN; i++)
+		for (int i = 0; i < PSM_FFT_BINS; i++)
 		{
 			if (i == 0)
 			{
@@ -9431,14 +13073,14 @@ public:
 				localWindow[2] = binData[i + 1].magnitude;
 				localWindow[3] = binData[i + 2].magnitude;
 			}
-			else  if (i == PSM_FFT_LEN - 1)
+			else  if (i == PSM_FFT_BINS - 1)
 			{
 				localWindow[0] = binData[i - 2].magnitude;
 				localWindow[1] = binData[i - 1].magnitude;
 				localWindow[2] = 0.0;
 				localWindow[3] = 0.0;
 			}
-			else  if (i == PSM_FFT_LEN - 2)
+			else  if (i == PSM_FFT_BINS - 2)
 			{
 				localWindow[0] = binData[i - 2].magnitude;
 				localWindow[1] = binData[i - 1].magnitude;
@@ -9481,7 +13123,7 @@ public:
 
 			if (nextPeak >= 0)
 			{
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					if (i <= bossPeakBin)
 					{
@@ -9498,7 +13140,7 @@ public:
 						if (nextPeak > bossPeakBin)
 							midBoundary = (nextPeak - (double)bossPeakBin) / 2.0 + bossPeakBin;
 						else // nextPeak == -1
-							midBoundary = PSM_FFT_LEN;
+							midBoundary = PSM_FFT_BINS;
 
 						binData[i].localPeakBin = bossPeakBin;
 					}
@@ -9524,12 +13166,12 @@ public:
 			if (fftReady)
 			{
 			// --- get the FFT data
-			fftw_complex* fftData = vocoder.getFFTData();
+			fxfft::complex* fftData = vocoder.getFFTData();
 
 			if (parameters.enablePeakPhaseLocking)
 			{
 				// --- get the magnitudes for searching
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					binData[i].reset();
 					peakBins[i] = -1;
@@ -9546,7 +13188,7 @@ public:
 				// --- now propagate phases accordingly
 				//
 				//     FIRST: set PSI angles of bosses
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					double mag_k = binData[i].magnitude;
 					double phi_k = binData[i].phi;
@@ -9584,7 +13226,7 @@ public:
 				}
 
 				// --- now set non-peaks
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					if (!binData[i].isPeak)
 					{
@@ -9602,7 +13244,7 @@ public:
 					}
 				}
 
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					double mag_k = binData[i].magnitude;
 
@@ -9619,7 +13261,7 @@ public:
 
 			else // ---> old school
 			{
-				for (int i = 0; i < PSM_FFT_LEN; i++)
+				for (int i = 0; i < PSM_FFT_BINS; i++)
 				{
 					double mag_k = getMagnitude(fftData[i][0], fftData[i][1]);
 					double phi_k = getPhase(fftData[i][0], fftData[i][1]);
@@ -9652,13 +13294,8 @@ public:
 			// --- manually so the IFFT (OPTIONAL)
 			vocoder.doInverseFFT();
 
-			// --- can get the iFFT buffers
-			fftw_complex* inv_fftData = vocoder.getIFFTData();
-
-			// --- make copy (can speed this up)
-			double ifft[PSM_FFT_LEN] = { 0.0 };
-			for (int i = 0; i < PSM_FFT_LEN; i++)
-				ifft[i] = inv_fftData[i][0];
+			// --- can get the iFFT buffer; real valued, so no copy is needed
+			double* ifft = vocoder.getIFFTData();
 
 			// --- resample the audio as if it were stretched
 			resample(&ifft[0], outputBuff, PSM_FFT_LEN, outputBufferLength, interpolation::kLinear, windowCorrection, windowBuff);
@@ -9864,6 +13501,86 @@ inline double** decomposeFilter(double* filterIR, unsigned int FIRLength, unsign
 	return polyFilterSet;
 }
 
+/**
+\enum polyphaseFilterMethod
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to choose how the Interpolator and Decimator run their polyphase sub-filters.
+
+- kFastConvolver: one FastConvolver per phase; cost grows slowly with the FIR length but comes in FFT
+  blocks and adds one sub-band block of latency
+- kDirectFIR: a time-domain SIMD dot product per phase; flat per-sample cost and no block latency
+- kAutoSelect: useDirectPolyphaseFIR( ) picks one for the ratio and FIR length
+
+- enum class polyphaseFilterMethod { kAutoSelect, kFastConvolver, kDirectFIR };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class polyphaseFilterMethod { kAutoSelect, kFastConvolver, kDirectFIR };
+const unsigned int kMaxDirectPolyphaseLength = 128;	///< longest sub-band filter run as a direct FIR by kAutoSelect
+
+/**
+@useDirectPolyphaseFIR
+\ingroup FX-Functions
+
+@brief the kAutoSelect rule: the direct FIR is used when each sub-band filter is at most kMaxDirectPolyphaseLength
+taps long, i.e. up to 256 taps at 2x and 512 taps at 4x
+
+\param FIRLength - length of the anti-aliasing FIR
+\param ratio - up or down sampling ratio
+\return true to use polyphaseFilterMethod::kDirectFIR
+*/
+inline bool useDirectPolyphaseFIR(unsigned int FIRLength, rateConversionRatio ratio)
+{
+	unsigned int count = countForRatio(ratio);
+	return count > 0 && FIRLength / count <= kMaxDirectPolyphaseLength;
+}
+
+/**
+\class PolyphaseFilterCache
+\ingroup FX-Objects
+\brief
+The PolyphaseFilterCache object holds the polyphase decompositions of the built-in anti-aliasing filters
+(see getFilterIRTable( )). Each one is made on first use and shared by every Interpolator and Decimator,
+so initialize( ) does not allocate or copy the sub-band filters again.
+
+- a decomposition is one array of count * FIRLength/count coefficients: phase i starts at i * FIRLength/count
+  and holds h(i), h(i + count), h(i + 2*count), ...
+- getPolyphaseFilters( ) locks and may allocate: call it from initialize or reset functions, not the audio thread
+- the arrays are owned by the cache and never freed
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class PolyphaseFilterCache
+{
+public:
+	/** the process-wide cache */
+	static PolyphaseFilterCache& getInstance();
+
+	/** get the decomposition of a built-in filter, making it on first use */
+	/**
+	\param FIRLength the anti-aliasing filter length
+	\param ratio the conversion ratio (see rateConversionRatio)
+	\param sampleRate the base sample rate
+	\return the phases, or nullptr if there is no built-in filter for these settings
+	*/
+	const double* getPolyphaseFilters(unsigned int FIRLength, rateConversionRatio ratio, unsigned int sampleRate);
+
+private:
+	PolyphaseFilterCache() {}
+	PolyphaseFilterCache(const PolyphaseFilterCache&) = delete;
+	PolyphaseFilterCache& operator=(const PolyphaseFilterCache&) = delete;
+
+	std::mutex cacheMutex;		///< guards the map
+	std::map<std::tuple<unsigned int, unsigned int, unsigned int>, std::vector<double>> filters;	///< phases by (FIR length, ratio, sample rate)
+};
+
 /**
 \struct InterpolatorOutput
 \ingroup FFTW-Objects
@@ -9895,6 +13612,9 @@ Audio I/O:
 Control I/F:
 - none.
 
+- the polyphase sub-filters run on FastConvolvers or as direct SIMD FIRs (see polyphaseFilterMethod)
+- getLatency( ) reports the delay, including the filter's group delay, in input samples
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -9912,15 +13632,32 @@ public:
 	\param _ratio the conversion ratio (see rateConversionRatio)
 	\param _sampleRate the actual sample rate
 	\param _polyphase flag to enable polyphase decomposition
+	\param _method how the polyphase sub-filters are run (see polyphaseFilterMethod)
 	*/
-	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true)
+	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true,
+		polyphaseFilterMethod _method = polyphaseFilterMethod::kAutoSelect)
 	{
 		polyphase = _polyphase;
 		sampleRate = _sampleRate;
 		FIRLength = _FIRLength;
 		ratio = _ratio;
 		unsigned int count = countForRatio(ratio);
-		unsigned int subBandLength = FIRLength / count;
+		subBandLength = FIRLength / count;
+
+		if (_method == polyphaseFilterMethod::kAutoSelect)
+			_method = useDirectPolyphaseFIR(FIRLength, ratio) ? polyphaseFilterMethod::kDirectFIR : polyphaseFilterMethod::kFastConvolver;
+		directFIR = polyphase && _method == polyphaseFilterMethod::kDirectFIR;
+
+		// --- the shared decomposition of the built-in filter
+		polyPhaseFilters = PolyphaseFilterCache::getInstance().getPolyphaseFilters(FIRLength, ratio, sampleRate);
+
+		// --- direct FIR: only needs the input history, newest first and mirrored so that it is contiguous
+		if (directFIR)
+		{
+			history.assign(2 * subBandLength, 0.0);
+			historyIndex = 0;
+			return;
+		}
 
 		// --- straight SRC, no polyphase
 		convolver.initialize(FIRLength);
@@ -9932,25 +13669,33 @@ public:
 
 		if (!polyphase) return;
 
-		// --- decompose filter
-		double** polyPhaseFilters = decomposeFilter(filterTable, FIRLength, count);
 		if (!polyPhaseFilters)
 		{
 			polyphase = false;
 			return;
 		}
 
-		// --- set the individual polyphase filter IRs on the convolvers
+		// --- set the individual polyphase filter IRs on the convolvers; polyphase uses "backwards" indexing
 		for (unsigned int i = 0; i < count; i++)
 		{
 			polyPhaseConvolvers[i].initialize(subBandLength);
-			polyPhaseConvolvers[i].setFilterIR(polyPhaseFilters[i]);
-			delete[] polyPhaseFilters[i];
+			polyPhaseConvolvers[i].setFilterIR(&polyPhaseFilters[(count - 1 - i)*subBandLength]);
 		}
+	}
 
-		delete[] polyPhaseFilters;
+	/** the delay from input to output in input samples: the FIR's group delay, plus one sub-band block for the FastConvolvers */
+	double getLatency()
+	{
+		unsigned int count = countForRatio(ratio);
+		double latency = (FIRLength - 1) / (2.0 * count);
+		if (!directFIR)
+			latency += subBandLength;
+		return latency;
 	}
 
+	/** true if the sub-filters are running as direct FIRs */
+	bool isDirectFIR() { return directFIR; }
+
 	/** perform the interpolation; the multiple outputs are in an array in the return structure */
 	inline InterpolatorOutput interpolateAudio(double xn)
 	{
@@ -9963,6 +13708,20 @@ public:
 		// --- interpolators need the amp correction
 		double ampCorrection = double(count);
 
+		// --- direct FIR: output i is phase i convolved with the input
+		if (directFIR)
+		{
+			if (!polyPhaseFilters)
+				return output;
+
+			historyIndex = historyIndex == 0 ? subBandLength - 1 : historyIndex - 1;
+			history[historyIndex] = history[historyIndex + subBandLength] = xn;
+
+			for (unsigned int i = 0; i < count; i++)
+				output.audioData[i] = ampCorrection*dotProduct(&history[historyIndex], &polyPhaseFilters[i*subBandLength], subBandLength);
+			return output;
+		}
+
 		// --- polyphase uses "backwards" indexing for interpolator; see book
 		int m = count-1;
 		for (unsigned int i = 0; i < count; i++)
@@ -9987,6 +13746,13 @@ protected:
 	// --- polyphase: 4x is max right now
 	bool polyphase = true;									///< enable polyphase decomposition
 	FastConvolver polyPhaseConvolvers[maxSamplingRatio];	///< a set of sub-band convolvers for polyphase operation
+
+	// --- direct FIR polyphase
+	bool directFIR = false;						///< sub-filters run as direct FIRs
+	unsigned int subBandLength = 128;			///< taps per phase
+	const double* polyPhaseFilters = nullptr;	///< the shared decomposition (see PolyphaseFilterCache)
+	std::vector<double> history;				///< input history, newest first, mirrored
+	unsigned int historyIndex = 0;				///< newest input in history
 };
 
 /**
@@ -10020,6 +13786,9 @@ Audio I/O:
 Control I/F:
 - none.
 
+- the polyphase sub-filters run on FastConvolvers or as direct SIMD FIRs (see polyphaseFilterMethod)
+- getLatency( ) reports the delay, including the filter's group delay, in output samples
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -10037,15 +13806,32 @@ public:
 	\param _ratio the conversion ratio (see rateConversionRatio)
 	\param _sampleRate the actual sample rate
 	\param _polyphase flag to enable polyphase decomposition
+	\param _method how the polyphase sub-filters are run (see polyphaseFilterMethod)
 	*/
-	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true)
+	inline void initialize(unsigned int _FIRLength, rateConversionRatio _ratio, unsigned int _sampleRate, bool _polyphase = true,
+		polyphaseFilterMethod _method = polyphaseFilterMethod::kAutoSelect)
 	{
 		polyphase = _polyphase;
 		sampleRate = _sampleRate;
 		FIRLength = _FIRLength;
 		ratio = _ratio;
 		unsigned int count = countForRatio(ratio);
-		unsigned int subBandLength = FIRLength / count;
+		subBandLength = FIRLength / count;
+
+		if (_method == polyphaseFilterMethod::kAutoSelect)
+			_method = useDirectPolyphaseFIR(FIRLength, ratio) ? polyphaseFilterMethod::kDirectFIR : polyphaseFilterMethod::kFastConvolver;
+		directFIR = polyphase && _method == polyphaseFilterMethod::kDirectFIR;
+
+		// --- the shared decomposition of the built-in filter
+		polyPhaseFilters = PolyphaseFilterCache::getInstance().getPolyphaseFilters(FIRLength, ratio, sampleRate);
+
+		// --- direct FIR: only needs the input history of each phase, newest first and mirrored so that it is contiguous
+		if (directFIR)
+		{
+			history.assign(count * 2 * subBandLength, 0.0);
+			historyIndex = 0;
+			return;
+		}
 
 		// --- straight SRC, no polyphase
 		convolver.initialize(FIRLength);
@@ -10057,25 +13843,33 @@ public:
 
 		if (!polyphase) return;
 
-		// --- decompose filter
-		double** polyPhaseFilters = decomposeFilter(filterTable, FIRLength, count);
 		if (!polyPhaseFilters)
 		{
 			polyphase = false;
 			return;
 		}
 
-		// --- set the individual polyphase filter IRs on the convolvers
+		// --- set the individual polyphase filter IRs on the convolvers; input i is filtered by phase count - 1 - i
 		for (unsigned int i = 0; i < count; i++)
 		{
 			polyPhaseConvolvers[i].initialize(subBandLength);
-			polyPhaseConvolvers[i].setFilterIR(polyPhaseFilters[i]);
-			delete[] polyPhaseFilters[i];
+			polyPhaseConvolvers[i].setFilterIR(&polyPhaseFilters[(count - 1 - i)*subBandLength]);
 		}
+	}
 
-		delete[] polyPhaseFilters;
+	/** the delay from input to output in output samples: the FIR's group delay, plus one sub-band block for the FastConvolvers */
+	double getLatency()
+	{
+		unsigned int count = countForRatio(ratio);
+		double latency = (FIRLength - 1) / (2.0 * count);
+		if (!directFIR)
+			latency += subBandLength;
+		return latency;
 	}
 
+	/** true if the sub-filters are running as direct FIRs */
+	bool isDirectFIR() { return directFIR; }
+
 	/** decimate audio input samples into one outut sample (return value) */
 	inline double decimateAudio(DecimatorInput data)
 	{
@@ -10084,6 +13878,22 @@ public:
 		// --- setup output
 		double output = 0.0;
 
+		// --- direct FIR: input i is filtered by phase count - 1 - i
+		if (directFIR)
+		{
+			if (!polyPhaseFilters)
+				return output;
+
+			historyIndex = historyIndex == 0 ? subBandLength - 1 : historyIndex - 1;
+			for (unsigned int i = 0; i < count; i++)
+			{
+				double* phaseHistory = &history[i * 2 * subBandLength];
+				phaseHistory[historyIndex] = phaseHistory[historyIndex + subBandLength] = data.audioData[i];
+				output += dotProduct(&phaseHistory[historyIndex], &polyPhaseFilters[(count - 1 - i)*subBandLength], subBandLength);
+			}
+			return output;
+		}
+
 		// --- polyphase uses "forwards" indexing for decimator; see book
 		for (unsigned int i = 0; i < count; i++)
 		{
@@ -10107,6 +13917,11 @@ protected:
 	// --- polyphase: 4x is max right now
 	bool polyphase = true;									///< enable polyphase decomposition
 	FastConvolver polyPhaseConvolvers[maxSamplingRatio];	///< a set of sub-band convolvers for polyphase operation
-};
 
-#endif
+	// --- direct FIR polyphase
+	bool directFIR = false;						///< sub-filters run as direct FIRs
+	unsigned int subBandLength = 128;			///< taps per phase
+	const double* polyPhaseFilters = nullptr;	///< the shared decomposition (see PolyphaseFilterCache)
+	std::vector<double> history;				///< input history of each phase, newest first, mirrored
+	unsigned int historyIndex = 0;				///< newest input in each phase's history
+};
@@ -94,6 +94,165 @@ public:
 	virtual const SignalModulatorOutput renderModulatorOutput() = 0;
 };
 
+// --- wavetable LFO: 2^kLFOWavetableBits points per cycle, linearly interpolated from a 0.32 fixed point phase
+const uint32_t kLFOWavetableBits = 11;
+const uint32_t kLFOWavetableLength = 1u << kLFOWavetableBits;
+const uint32_t kLFOWavetableHarmonics = 256;	///< alias-free up to fs / 512 (94 Hz at 48kHz)
+const uint32_t kLFOPhaseFractionBits = 32 - kLFOWavetableBits;
+const uint32_t kLFOQuarterCycle = 1u << 30;		///< 90 degrees in fixed point phase
+const uint32_t kSuperLFOBlockSize = 64;			///< renderBlock( ) works in chunks of this many samples
+
+/**
+\class SuperLFOWavetables
+\ingroup FX-Objects
+\brief
+The SuperLFOWavetables object holds one band-limited cycle of each periodic LFOWaveform, shared by every SuperLFO.
+The tables are additive (Lanczos sigma-smoothed, so the saw and square do not ring) and normalized to +/-1.0;
+they have a guard point so that interpolation never wraps.
+
+\author <Your Name> <http://www.yourwebsite.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class SuperLFOWavetables
+{
+public:
+	/** the shared tables; built on first use, which takes milliseconds, so the SuperLFO constructor makes that call */
+	static const SuperLFOWavetables& getInstance()
+	{
+		static SuperLFOWavetables wavetables;
+		return wavetables;
+	}
+
+	/** the table for a periodic waveform, or nullptr for the noise and random waveforms */
+	const float* getTable(LFOWaveform waveform) const
+	{
+		if (waveform == LFOWaveform::kSin)
+			return &table[kSinTable][0];
+		else if (waveform == LFOWaveform::kTriangle)
+			return &table[kTriangleTable][0];
+		else if (waveform == LFOWaveform::kSaw)
+			return &table[kSawTable][0];
+		else if (waveform == LFOWaveform::kSquare)
+			return &table[kSquareTable][0];
+
+		return nullptr;
+	}
+
+private:
+	enum { kSinTable, kTriangleTable, kSawTable, kSquareTable, kNumTables };
+
+	SuperLFOWavetables()
+	{
+		// --- one sine cycle; harmonic n of point k is sine[(n*k) mod length]
+		double sine[kLFOWavetableLength];
+		for (uint32_t k = 0; k < kLFOWavetableLength; k++)
+			sine[k] = sin(kTwoPi * k / kLFOWavetableLength);
+
+		const uint32_t mask = kLFOWavetableLength - 1;
+		const uint32_t quarter = kLFOWavetableLength / 4;
+
+		// --- Lanczos sigma factor of each harmonic
+		double sigma[kLFOWavetableHarmonics + 1];
+		for (uint32_t n = 1; n <= kLFOWavetableHarmonics; n++)
+		{
+			double x = kPi * n / (kLFOWavetableHarmonics + 1);
+			sigma[n] = sin(x) / x;
+		}
+
+		for (uint32_t k = 0; k < kLFOWavetableLength; k++)
+		{
+			double triangle = 0.0;
+			double saw = 0.0;
+			double square = 0.0;
+
+			for (uint32_t n = 1; n <= kLFOWavetableHarmonics; n++)
+			{
+				double sinTerm = sigma[n] * sine[(n * k) & mask] / n;
+
+				// --- saw rises -1 to +1 over the cycle: -(2/pi) sum sin(nwt)/n
+				saw -= sinTerm;
+
+				// --- odd harmonics: square (4/pi) sum sin(nwt)/n and triangle (8/pi^2) sum cos(nwt)/n^2
+				if (n & 1)
+				{
+					square += sinTerm;
+					triangle += sigma[n] * sine[(n * k + quarter) & mask] / (n * n);
+				}
+			}
+
+			table[kSinTable][k] = (float)sine[k];
+			table[kTriangleTable][k] = (float)triangle;
+			table[kSawTable][k] = (float)saw;
+			table[kSquareTable][k] = (float)square;
+		}
+
+		// --- normalize to +/-1.0 and set the guard points
+		for (unsigned int t = 0; t < kNumTables; t++)
+		{
+			float peak = 0.0f;
+			for (uint32_t k = 0; k < kLFOWavetableLength; k++)
+				peak = fmax(peak, fabs(table[t][k]));
+
+			for (uint32_t k = 0; k < kLFOWavetableLength; k++)
+				table[t][k] /= peak;
+
+			table[t][kLFOWavetableLength] = table[t][0];
+		}
+	}
+
+	float table[kNumTables][kLFOWavetableLength + 1];	///< one cycle per waveform plus the guard point
+};
+
+/**
+@renderLFOWavetable
+\ingroup FX-Functions
+
+@brief renders a run of an LFO wavetable from a fixed point phase accumulator; uses SSE2 when available
+
+\param table - wavetable with kLFOWavetableLength + 1 points
+\param phase - 0.32 fixed point phase of the first output
+\param phaseInc - fixed point phase increment between outputs (wraps naturally for negative rates)
+\param output - array to receive the values
+\param length - number of values
+*/
+inline void renderLFOWavetable(const float* table, uint32_t phase, uint32_t phaseInc, float* output, uint32_t length)
+{
+	const uint32_t fractionMask = (1u << kLFOPhaseFractionBits) - 1;
+	const float fractionScale = 1.0f / (float)(1u << kLFOPhaseFractionBits);
+	uint32_t i = 0;
+
+#if defined FXOBJECTS_SSE2
+	// --- four phases at a time; the table reads are scalar gathers
+	__m128i phases = _mm_add_epi32(_mm_set1_epi32((int)phase),
+								   _mm_set_epi32((int)(3 * phaseInc), (int)(2 * phaseInc), (int)phaseInc, 0));
+	const __m128i step = _mm_set1_epi32((int)(4 * phaseInc));
+	const __m128i fractionMask4 = _mm_set1_epi32((int)fractionMask);
+	const __m128 fractionScale4 = _mm_set1_ps(fractionScale);
+
+	for (; i + 4 <= length; i += 4)
+	{
+		alignas(16) uint32_t index[4];
+		_mm_store_si128((__m128i*)index, _mm_srli_epi32(phases, kLFOPhaseFractionBits));
+
+		__m128 y0 = _mm_set_ps(table[index[3]], table[index[2]], table[index[1]], table[index[0]]);
+		__m128 y1 = _mm_set_ps(table[index[3] + 1], table[index[2] + 1], table[index[1] + 1], table[index[0] + 1]);
+		__m128 fraction = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(phases, fractionMask4)), fractionScale4);
+
+		_mm_storeu_ps(&output[i], _mm_add_ps(y0, _mm_mul_ps(fraction, _mm_sub_ps(y1, y0))));
+		phases = _mm_add_epi32(phases, step);
+	}
+	phase += i * phaseInc;
+#endif
+	for (; i < length; i++, phase += phaseInc)
+	{
+		uint32_t index = phase >> kLFOPhaseFractionBits;
+		float fraction = (phase & fractionMask) * fractionScale;
+		output[i] = table[index] + fraction * (table[index + 1] - table[index]);
+	}
+}
+
 /**
 \class SuperLFO
 \ingroup FX-Objects
@@ -101,21 +260,32 @@ public:
 The SuperLFO object implements ....
 
 Audio I/O:
-- Processes mono input to mono output.
-- *** Optionally, process frame *** Modify this according to your object functionality
+- Output only object: renderBlock( ) renders whole blocks; renderModulatorOutput( ) is a one sample wrapper around it.
 
 Control I/F:
 - Use SuperLFOParameters structure to get/set object params.
 
+Waveforms:
+- Sin, triangle, saw and square come from the shared band-limited SuperLFOWavetables.
+- The phase is a 0.32 fixed point accumulator, so wrapping is free and quad phase is an add.
+- Noise and random sample & hold come from per-object FastRandom generators (see setSeed( )); S&H fills whole
+  hold runs at once.
+
 \author <Your Name> <http://www.yourwebsite.com>
 \remark <Put any remarks or notes here>
 \version Revision : 1.0
 \date Date : 2019 / 01 / 31
 */
-class SuperLFO : public IAudioSignalModualtor
+class SuperLFO : public IAudioSignalModualtor, public IModulationSource
 {
 public:
-	SuperLFO(void) {}	/* C-TOR */
+	SuperLFO(void)	/* C-TOR */
+	{
+		setSeed(kDefaultRandomSeed);
+
+		// --- build the shared tables here rather than in the first render on the audio thread
+		SuperLFOWavetables::getInstance();
+	}
 	~SuperLFO(void) {}	/* D-TOR */
 
 public:
@@ -125,145 +295,100 @@ public:
 		// --- do any other per-audio-run inits here
 		sampleRate = _sampleRate;
 
-		srand(time(NULL)); // --- seed random number generator
+		// --- restart the noise from the seed so that renders repeat exactly
+		noiseGenerator.setSeed(seed);
+		quadPhaseNoiseGenerator.setSeed(seed + 1);
 
-		// --- randomize the PN register
-		pnRegister = rand();
+		// --- randomize the PN register; doPNSequence( ) scales a 29 bit register (b0 - b28) to [-1, +1]
+		pnRegister = noiseGenerator.nextUInt32() >> 3;
 
-		// --- calculate modulo counter phase incrementer
-		phaseInc = parameters.frequency_Hz / sampleRate;
+		// --- calculate phase incrementer and hold time
+		cookRate();
 
 		// --- timebase variables
-		modCounter = 0.0;			///< modulo counter [0.0, +1.0]
-		modCounterQP = 0.25;		///<Quad Phase modulo counter [0.0, +1.0]
+		phase = 0;
+		renderComplete = false;
+
+		// --- restart the sample & hold
+		randomSHCounter = -1.0;
+		randomSHValue = 0.0;
 
 		return true;
 	}
 
-	/** process MONO input */
+	/** set the seed of the noise and random waveforms; takes effect now and on every reset( ) */
 	/**
-	\param xn input
-	\return the processed sample
+	\param _seed the seed; the quad phase noise uses seed + 1
 	*/
-	virtual const SignalModulatorOutput renderModulatorOutput()
+	void setSeed(uint64_t _seed)
 	{
-		// --- setup for output
-		SignalModulatorOutput lfoOutputData; // should auto-zero on instantiation
-
-		if (renderComplete)
-		{
-			return lfoOutputData;
-		}
-
-		// --- always first!
-		bool bWrapped = checkAndWrapModulo(modCounter, phaseInc);
-		if (bWrapped && parameters.mode == LFOMode::kOneShot)
-		{
-			renderComplete = true;
-			return lfoOutputData;
-		}
-
-		// --- QP output always follows location of current modulo; first set equal
-		modCounterQP = modCounter;
-
-		// --- then, advance modulo by quadPhaseInc = 0.25 = 90 degrees, AND wrap if needed
-		advanceAndCheckWrapModulo(modCounterQP, 0.25);
+		seed = _seed;
+		noiseGenerator.setSeed(seed);
+		quadPhaseNoiseGenerator.setSeed(seed + 1);
+	}
 
-		// --- calculate the oscillator value
-		if (parameters.waveform == LFOWaveform::kSin)
+	/** render a block of the outputs selected by outputMask */
+	/**
+	\param out one run of numSamples for each output in the mask, in modulatorOutput order
+	\param numSamples samples per output
+	\param outputMask subscribed outputs, see modulatorOutputMask( )
+	*/
+	void renderBlock(float* out, uint32_t numSamples, uint32_t outputMask)
+	{
+		// --- where each subscribed output goes
+		float* outputs[kNumModulatorOutputs] = { nullptr };
+		float* nextOutput = out;
+		for (unsigned int i = 0; i < kNumModulatorOutputs; i++)
 		{
-			// --- calculate normal angle
-			double angle = modCounter*2.0*kPi - kPi;
-
-			// --- norm output with parabolicSine approximation
-			lfoOutputData.normalOutput = parabolicSine(-angle);
-
-			// --- calculate QP angle
-			angle = modCounterQP*2.0*kPi - kPi;
-
-			// --- calc QP output
-			lfoOutputData.quadPhaseOutput_pos = parabolicSine(-angle);
+			if (outputMask & (1u << i))
+			{
+				outputs[i] = nextOutput;
+				nextOutput += numSamples;
+			}
 		}
-		else if (parameters.waveform == LFOWaveform::kTriangle)
-		{
-			// --- triv saw
-			lfoOutputData.normalOutput = unipolarToBipolar(modCounter);
 
-			// --- bipolar triagle
-			lfoOutputData.normalOutput = 2.0*fabs(lfoOutputData.normalOutput) - 1.0;
+		bool renderNormal = outputs[kModNormal] || outputs[kModInverted];
+		bool renderQuadPhase = outputs[kModQuadPhasePos] || outputs[kModQuadPhaseNeg];
 
-			// -- quad phase
-			lfoOutputData.quadPhaseOutput_pos = unipolarToBipolar(modCounterQP);
+		float normal[kSuperLFOBlockSize];
+		float quadPhase[kSuperLFOBlockSize];
+		float amplitude = (float)parameters.outputAmplitude;
 
-			// bipolar triagle
-			lfoOutputData.quadPhaseOutput_pos = 2.0*fabs(lfoOutputData.quadPhaseOutput_pos) - 1.0;
-		}
-		else if (parameters.waveform == LFOWaveform::kSaw)
+		for (uint32_t start = 0; start < numSamples; start += kSuperLFOBlockSize)
 		{
-			lfoOutputData.normalOutput = unipolarToBipolar(modCounter);
-			lfoOutputData.quadPhaseOutput_pos = unipolarToBipolar(modCounterQP);
+			uint32_t length = numSamples - start < kSuperLFOBlockSize ? numSamples - start : kSuperLFOBlockSize;
+
+			renderPoints(renderNormal ? normal : nullptr, renderQuadPhase ? quadPhase : nullptr, length, 1);
+
+			// --- scale by amplitude; inverted outputs carry the scaling
+			if (outputs[kModNormal])
+				scaleLFOBlock(normal, amplitude, &outputs[kModNormal][start], length);
+			if (outputs[kModInverted])
+				scaleLFOBlock(normal, -amplitude, &outputs[kModInverted][start], length);
+			if (outputs[kModQuadPhasePos])
+				scaleLFOBlock(quadPhase, amplitude, &outputs[kModQuadPhasePos][start], length);
+			if (outputs[kModQuadPhaseNeg])
+				scaleLFOBlock(quadPhase, -amplitude, &outputs[kModQuadPhaseNeg][start], length);
 		}
-		else if (parameters.waveform == LFOWaveform::kSquare)
-		{
-			// --- generate sine
-			// --- calculate normal angle
-			double angle = modCounter * 2.0*kPi - kPi;
-
-			// --- norm output with parabolicSine approximation
-			lfoOutputData.normalOutput = parabolicSine(-angle);
-
-			// convert to square
-			if (lfoOutputData.normalOutput >= 0)
-				lfoOutputData.normalOutput = 1;
-			else if (lfoOutputData.normalOutput < 0)
-				lfoOutputData.normalOutput = -1;
-				
-		}
-		else if (parameters.waveform == LFOWaveform::kNoise)
-		{
-			lfoOutputData.normalOutput = doWhiteNoise();
-			lfoOutputData.quadPhaseOutput_pos = doWhiteNoise();
-		}
-		else if (parameters.waveform == LFOWaveform::kQRNoise)
-		{
-			lfoOutputData.normalOutput = doPNSequence(pnRegister);
-			lfoOutputData.quadPhaseOutput_pos = doPNSequence(pnRegister);
-		}
-		else if (parameters.waveform == LFOWaveform::kRSH || parameters.waveform == LFOWaveform::kQRSH)
-		{
-			// --- is this is the very first run? if so, form first output sample
-			if (randomSHCounter < 0)
-			{
-				if (parameters.waveform == LFOWaveform::kRSH)
-					randomSHValue = doWhiteNoise();
-				else
-					randomSHValue = doPNSequence(pnRegister);
-
-				// --- init the sample counter, will be advanced below
-				randomSHCounter = 1.0;
-			}
-			// --- has hold time been exceeded? if so, generate next output sample
-			else if (randomSHCounter > (sampleRate / parameters.frequency_Hz))
-			{
-				// --- wrap counter
-				randomSHCounter -= sampleRate / parameters.frequency_Hz;
-
-				if (parameters.waveform == LFOWaveform::kRSH)
-					randomSHValue = doWhiteNoise();
-				else
-					randomSHValue = doPNSequence(pnRegister);
-			}
+	}
 
-			// --- advance the sample counter
-			randomSHCounter += 1.0;
+	/** render one sample of all outputs; a thin wrapper around the block renderer */
+	/**
+	\return the modulator outputs
+	*/
+	virtual const SignalModulatorOutput renderModulatorOutput()
+	{
+		// --- setup for output
+		SignalModulatorOutput lfoOutputData; // should auto-zero on instantiation
 
-			lfoOutputData.normalOutput = randomSHValue;
-			lfoOutputData.quadPhaseOutput_pos = randomSHValue;
-		}
+		float normal = 0.0f;
+		float quadPhase = 0.0f;
+		if (renderPoints(&normal, &quadPhase, 1, 1) == 0)
+			return lfoOutputData;
 
 		// --- scale by amplitude
-		lfoOutputData.normalOutput *= parameters.outputAmplitude;
-		lfoOutputData.quadPhaseOutput_pos *= parameters.outputAmplitude;
+		lfoOutputData.normalOutput = normal * parameters.outputAmplitude;
+		lfoOutputData.quadPhaseOutput_pos = quadPhase * parameters.outputAmplitude;
 
 		// --- invert two main outputs to make the opposite versions, scaling carries over
 		lfoOutputData.invertedOutput = -lfoOutputData.normalOutput;
@@ -286,13 +411,31 @@ public:
 		lfoOutputData.unipolarOutputFromMin = lfoOutputData.unipolarOutputFromMin - (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
 		lfoOutputData.quadPhaseUnipolarOutputFromMin = lfoOutputData.quadPhaseUnipolarOutputFromMin - (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
 
-		// --- setup for next sample period
-		advanceModulo(modCounter, phaseInc);
-
-		// --- scale by amplituded
 		return lfoOutputData;
 	}
 
+	/** IModulationSource: render the subscribed outputs at the current position, then advance hopSize samples;
+	    the noise waveforms are drawn once per control point */
+	/**
+	\param hopSize samples to the next control point
+	\param outputMask subscribed outputs, see modulatorOutputMask( )
+	\param values output array, values[kNumModulatorOutputs]
+	*/
+	virtual void renderControlPoint(uint32_t hopSize, uint32_t outputMask, double* values)
+	{
+		float normal = 0.0f;
+		float quadPhase = 0.0f;
+		bool renderNormal = (outputMask & (modulatorOutputMask(kModNormal) | modulatorOutputMask(kModInverted))) != 0;
+		bool renderQuadPhase = (outputMask & (modulatorOutputMask(kModQuadPhasePos) | modulatorOutputMask(kModQuadPhaseNeg))) != 0;
+
+		renderPoints(renderNormal ? &normal : nullptr, renderQuadPhase ? &quadPhase : nullptr, 1, hopSize);
+
+		// --- scale by amplitude
+		values[kModNormal] = normal * parameters.outputAmplitude;
+		values[kModInverted] = -values[kModNormal];
+		values[kModQuadPhasePos] = quadPhase * parameters.outputAmplitude;
+		values[kModQuadPhaseNeg] = -values[kModQuadPhasePos];
+	}
 
 	/** get parameters: note use of custom structure for passing param data */
 	/**
@@ -316,7 +459,7 @@ public:
 		parameters = params;
 
 		// --- cook parameters here
-		phaseInc = parameters.frequency_Hz / sampleRate;
+		cookRate();
 	}
 
 private:
@@ -326,80 +469,166 @@ private:
 	double sampleRate = 0.0;	///< sample rate
 								
 	// --- timebase variables
-	double modCounter = 0.0;			///< modulo counter [0.0, +1.0]
-	double phaseInc = 0.0;				///< phase inc = fo/fs
-	double modCounterQP = 0.25;			///< Quad Phase modulo counter [0.0, +1.0]
+	uint32_t phase = 0;					///< 0.32 fixed point modulo counter; wraps on overflow
+	int32_t phaseInc = 0;				///< fixed point phase inc = 2^32 * fo/fs
 	bool renderComplete = false;		///< flag for one-shot
 
+	// --- per-object noise: no global rand( ) state, repeatable from the seed
+	FastRandom noiseGenerator;						///< noise and random S&H
+	FastRandom quadPhaseNoiseGenerator;				///< quad phase noise
+	uint64_t seed = kDefaultRandomSeed;				///< seed restored by reset( )
+
 	// --- 32-bit register for RS&H
 	uint32_t pnRegister = 0;			///< 32 bit register for PN oscillator
-	int randomSHCounter = -1;			///< random sample/hold counter;  -1 is reset condition
+	double randomSHCounter = -1.0;		///< random sample/hold counter;  -1 is reset condition
 	double randomSHValue = 0.0;			///< current output, needed because we hold this output for some number of samples = (sampleRate / oscFrequency)
+	double holdSamples = 0.0;			///< sample/hold time = sampleRate / oscFrequency
 
-	/**
-	\struct checkAndWrapModulo
-	\brief Check a modulo counter and wrap it if necessary
-	*/
-	inline bool checkAndWrapModulo(double& moduloCounter, double phaseInc)
+	/** fixed point phase increment and S&H hold time from the frequency */
+	void cookRate()
 	{
-		// --- for positive frequencies
-		if (phaseInc > 0 && moduloCounter >= 1.0)
-		{
-			moduloCounter -= 1.0;
-			return true;
-		}
+		double cyclesPerSample = sampleRate > 0.0 ? parameters.frequency_Hz / sampleRate : 0.0;
 
-		// --- for negative frequencies
-		if (phaseInc < 0 && moduloCounter <= 0.0)
-		{
-			moduloCounter += 1.0;
-			return true;
-		}
+		// --- at most half a cycle per sample either way
+		cyclesPerSample = fmin(fmax(cyclesPerSample, -0.5), 0.5 - 1.0 / 4294967296.0);
+		phaseInc = (int32_t)llround(cyclesPerSample * 4294967296.0);
 
-		return false;
+		holdSamples = sampleRate / parameters.frequency_Hz;
 	}
 
-	/**
-	\struct checkAndWrapModulo
-	\brief Advance, and then check a modulo counter and wrap it if necessary
-	*/
-	inline bool advanceAndCheckWrapModulo(double& moduloCounter, double phaseInc)
+	/** number of points, stepped by pointInc, that can be rendered before the phase wraps */
+	inline uint64_t getPointsUntilWrap(int64_t pointInc)
+	{
+		if (pointInc > 0)
+			return ((1ull << 32) - phase + (uint64_t)pointInc - 1) / (uint64_t)pointInc;
+		if (pointInc < 0)
+			return ((uint64_t)phase + (uint64_t)(-pointInc) - 1) / (uint64_t)(-pointInc);
+
+		return UINT64_MAX;
+	}
+
+	/** render numPoints unscaled points spaced stride samples apart; normal and/or quadPhase may be null.
+	    Points after a one-shot has finished are zero. The waveform branch is taken once for the whole run.
+	\return the number of points rendered before a one-shot finished */
+	uint32_t renderPoints(float* normal, float* quadPhase, uint32_t numPoints, uint32_t stride)
 	{
-		// --- advance counter
-		moduloCounter += phaseInc;
+		int64_t pointInc = (int64_t)phaseInc * stride;
+		uint32_t numRendered = renderComplete ? 0 : numPoints;
 
-		// --- for positive frequencies
-		if (phaseInc > 0 && moduloCounter >= 1.0)
+		// --- a one-shot stops at its first wrap
+		if (!renderComplete && parameters.mode == LFOMode::kOneShot)
 		{
-			moduloCounter -= 1.0;
-			return true;
+			uint64_t pointsUntilWrap = getPointsUntilWrap(pointInc);
+			if (pointsUntilWrap < numPoints)
+			{
+				numRendered = (uint32_t)pointsUntilWrap;
+				renderComplete = true;
+			}
 		}
 
-		// --- for negative frequencies
-		if (phaseInc < 0 && moduloCounter <= 0.0)
+		if (numRendered > 0)
 		{
-			moduloCounter += 1.0;
-			return true;
+			const float* table = SuperLFOWavetables::getInstance().getTable(parameters.waveform);
+
+			if (table)
+			{
+				if (normal)
+					renderLFOWavetable(table, phase, (uint32_t)pointInc, normal, numRendered);
+
+				// --- the square has no quad phase output
+				if (quadPhase && parameters.waveform == LFOWaveform::kSquare)
+					memset(quadPhase, 0, numRendered * sizeof(float));
+				else if (quadPhase)
+					renderLFOWavetable(table, phase + kLFOQuarterCycle, (uint32_t)pointInc, quadPhase, numRendered);
+			}
+			else if (parameters.waveform == LFOWaveform::kNoise)
+			{
+				// --- one generator per output, so blocks and single samples draw the same sequences
+				if (normal)
+					noiseGenerator.fillBipolar(normal, numRendered);
+				if (quadPhase)
+					quadPhaseNoiseGenerator.fillBipolar(quadPhase, numRendered);
+			}
+			else if (parameters.waveform == LFOWaveform::kQRNoise)
+			{
+				for (uint32_t i = 0; i < numRendered; i++)
+				{
+					if (normal) normal[i] = doPNSequence(pnRegister);
+					if (quadPhase) quadPhase[i] = doPNSequence(pnRegister);
+				}
+			}
+			else if (parameters.waveform == LFOWaveform::kRSH || parameters.waveform == LFOWaveform::kQRSH)
+				renderSampleAndHold(normal, quadPhase, numRendered, stride);
+
+			// --- setup for next sample period
+			phase += (uint32_t)(pointInc * numRendered);
 		}
 
-		return false;
+		// --- finished one-shot
+		for (uint32_t i = numRendered; i < numPoints; i++)
+		{
+			if (normal) normal[i] = 0.0f;
+			if (quadPhase) quadPhase[i] = 0.0f;
+		}
+
+		return numRendered;
+	}
+
+	/** random sample & hold: each held value is written as one run */
+	void renderSampleAndHold(float* normal, float* quadPhase, uint32_t numPoints, uint32_t stride)
+	{
+		uint32_t point = 0;
+		while (point < numPoints)
+		{
+			// --- is this is the very first run? if so, form first output sample
+			if (randomSHCounter < 0.0)
+			{
+				nextSampleAndHoldValue();
+
+				// --- init the sample counter
+				randomSHCounter = 1.0;
+			}
+			// --- has hold time been exceeded? if so, generate next output sample
+			else if (randomSHCounter > holdSamples)
+			{
+				// --- wrap counter
+				randomSHCounter = holdSamples > 0.0 ? fmod(randomSHCounter, holdSamples) : 0.0;
+				nextSampleAndHoldValue();
+			}
+
+			// --- points until the counter passes the hold time
+			double holdPoints = floor((holdSamples - randomSHCounter) / stride) + 1.0;
+			uint32_t length = numPoints - point;
+			if (holdPoints < (double)length)
+				length = holdPoints >= 1.0 ? (uint32_t)holdPoints : 1;
+
+			float value = (float)randomSHValue;
+			for (uint32_t i = 0; i < length; i++)
+			{
+				if (normal) normal[point + i] = value;
+				if (quadPhase) quadPhase[point + i] = value;
+			}
+
+			// --- advance the sample counter
+			randomSHCounter += (double)length * stride;
+			point += length;
+		}
 	}
 
-	// --- increment the modulo counter
-	inline void advanceModulo(double& moduloCounter, double phaseInc) { moduloCounter += phaseInc; }
+	/** draw the next random sample & hold value */
+	inline void nextSampleAndHoldValue()
+	{
+		if (parameters.waveform == LFOWaveform::kRSH)
+			randomSHValue = noiseGenerator.nextBipolar();
+		else
+			randomSHValue = doPNSequence(pnRegister);
+	}
 
-	// --- sine approximation with parabolas
-	const double B = 4.0 / kPi;
-	const double C = -4.0 / (kPi* kPi);
-	const double P = 0.225;
-	// http://devmaster.net/posts/9648/fast-and-accurate-sine-cosine
-	//
-	// --- angle is -pi to +pi
-	inline double parabolicSine(double angle)
+	/** out = gain * in */
+	inline void scaleLFOBlock(const float* input, float gain, float* output, uint32_t length)
 	{
-		double y = B * angle + C * angle * fabs(angle);
-		y = P * (y * fabs(y) - y) + y;
-		return y;
+		for (uint32_t i = 0; i < length; i++)
+			output[i] = gain * input[i];
 	}
 
 	#define EXTRACT_BITS(the_val, bits_start, bits_len) ((the_val >> (bits_start - 1)) & ((1 << bits_len) - 1))
@@ -437,4 +666,4 @@ private:
 	}
 };
 
-#endif
\ No newline at end of file
+#endif
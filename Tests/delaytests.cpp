@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Kernel File:  delaytests.cpp
+//
+/**
+    \file   delaytests.cpp
+    \brief  stand-alone check that the block reads of the circular buffers match their per-frame reads
+
+	build and run from the project folder (the kernel headers rely on the IDE's implicit <cstring>/<algorithm>):
+	g++ -std=c++14 -include cstring -include algorithm -IPluginKernel -IPluginObjects
+	    Tests/delaytests.cpp PluginObjects/fxobjects.cpp -o delaytests && ./delaytests
+*/
+// -----------------------------------------------------------------------------
+#include "fxobjects.h"
+#include <stdio.h>
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, double delay)
+{
+	printf("%s: %s, delay %.2f\n", condition ? "pass" : "FAIL", what, delay);
+	if (!condition)
+		failures++;
+}
+
+// --- runs the same input through per-frame reads/writes and block reads/writes of numFrames
+template <typename Buffer>
+static double blockVsFrameError(double delay, unsigned int numFrames)
+{
+	Buffer frameBuffer;
+	Buffer blockBuffer;
+	frameBuffer.createCircularBuffer(1024);
+	blockBuffer.createCircularBuffer(1024);
+	frameBuffer.setInterpolation(delayInterpolation::kThiran);
+	blockBuffer.setInterpolation(delayInterpolation::kThiran);
+
+	FastRandom noise;
+	double maxError = 0.0;
+	double input[16] = { 0.0 };
+	double frameOutput[16] = { 0.0 };
+	double blockOutput[16] = { 0.0 };
+	double* outputs[1] = { &blockOutput[0] };
+
+	for (unsigned int block = 0; block < 1024; block++)
+	{
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			input[i] = noise.nextBipolar();
+			frameOutput[i] = frameBuffer.readBuffer(delay);
+			frameBuffer.writeBuffer(input[i]);
+		}
+
+		if (!blockBuffer.readBuffer(&delay, outputs, 1, numFrames))
+			return 1.0e9;
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			blockBuffer.writeBuffer(input[i]);
+			maxError = fmax(maxError, fabs(frameOutput[i] - blockOutput[i]));
+		}
+	}
+	return maxError;
+}
+
+int main()
+{
+	// --- Thiran below one sample: the allpass cannot borrow a sample from a delay of zero
+	const double delays[] = { 0.0, 0.2, 0.49, 0.5, 0.75 };
+	for (double delay : delays)
+	{
+		check(blockVsFrameError<CircularBuffer<double>>(delay, 1) < 1.0e-12, "CircularBuffer Thiran 1 frame block vs frame", delay);
+		check(blockVsFrameError<ExactCircularBuffer<double>>(delay, 1) < 1.0e-12, "ExactCircularBuffer Thiran 1 frame block vs frame", delay);
+	}
+
+	// --- and at the shortest delays of a longer block (see getShortestBlockDelay( ))
+	const double blockDelays[] = { 7.5, 7.75, 8.2 };
+	for (double delay : blockDelays)
+	{
+		check(blockVsFrameError<CircularBuffer<double>>(delay, 8) < 1.0e-12, "CircularBuffer Thiran 8 frame block vs frame", delay);
+		check(blockVsFrameError<ExactCircularBuffer<double>>(delay, 8) < 1.0e-12, "ExactCircularBuffer Thiran 8 frame block vs frame", delay);
+	}
+
+	return failures == 0 ? 0 : 1;
+}
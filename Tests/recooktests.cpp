@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Kernel File:  recooktests.cpp
+//
+/**
+    \file   recooktests.cpp
+    \brief  stand-alone check that PluginCore re-cooks its member objects only when a parameter changes
+
+	build and run from the project folder (the kernel headers rely on the IDE's implicit <cstring>/<algorithm>):
+	g++ -std=c++14 -include cstring -include algorithm -IPluginKernel -IPluginObjects -ICustomControls
+	    Tests/recooktests.cpp PluginKernel/plugincore.cpp PluginKernel/pluginbase.cpp PluginKernel/pluginparameter.cpp
+	    PluginObjects/fxobjects.cpp -o recooktests && ./recooktests
+*/
+// -----------------------------------------------------------------------------
+#include "plugincore.h"
+#include <stdio.h>
+
+// --- exposes the dirty flags and the updater
+class RecookProbe : public PluginCore
+{
+public:
+	bool isDirty() { return parametersDirty(); }
+	void cook() { updateParameters(); }
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	printf("%s: %s\n", condition ? "pass" : "FAIL", what);
+	if (!condition)
+		failures++;
+}
+
+int main()
+{
+	RecookProbe core;
+	ResetInfo resetInfo;
+	resetInfo.sampleRate = 44100.0;
+	resetInfo.bitDepth = 24;
+	core.reset(resetInfo);
+
+	HostInfo hostInfo;
+	ProcessBufferInfo bufferInfo;
+	bufferInfo.hostInfo = &hostInfo;
+
+	// --- first buffer: everything is new
+	core.preProcessAudioBuffers(bufferInfo);
+	check(core.isDirty(), "first buffer re-cooks");
+	core.cook();
+
+	// --- no control changes: syncInBoundVariables( ) posts the same values again
+	core.preProcessAudioBuffers(bufferInfo);
+	check(!core.isDirty(), "buffer with no control changes does not re-cook");
+
+	// --- a real change re-cooks, once
+	ParameterUpdateInfo updateInfo;
+	core.updatePluginParameter(controlID::delay_ms, 250.0, updateInfo);
+	core.preProcessAudioBuffers(bufferInfo);
+	check(core.isDirty(), "changed parameter re-cooks");
+	core.cook();
+
+	core.preProcessAudioBuffers(bufferInfo);
+	check(!core.isDirty(), "next unchanged buffer does not re-cook");
+
+	// --- a sample rate change always re-cooks
+	resetInfo.sampleRate = 48000.0;
+	core.reset(resetInfo);
+	check(core.isDirty(), "reset re-cooks");
+
+	return failures == 0 ? 0 : 1;
+}
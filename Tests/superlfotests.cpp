@@ -0,0 +1,77 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Kernel File:  superlfotests.cpp
+//
+/**
+    \file   superlfotests.cpp
+    \brief  stand-alone check that SuperLFO renders repeat exactly after reset( ) and stay in [-1, +1]
+
+	build and run from the project folder (the kernel headers rely on the IDE's implicit <cstring>/<algorithm>):
+	g++ -std=c++14 -include cstring -include algorithm -IPluginKernel -IPluginObjects
+	    Tests/superlfotests.cpp PluginObjects/fxobjects.cpp -o superlfotests && ./superlfotests
+*/
+// -----------------------------------------------------------------------------
+#include "superlfo.h"
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, const char* waveform)
+{
+	printf("%s: %s, %s\n", condition ? "pass" : "FAIL", what, waveform);
+	if (!condition)
+		failures++;
+}
+
+static const uint32_t kRenderLength = 10000;
+static const uint32_t kAllOutputs = (1u << kNumModulatorOutputs) - 1;
+
+// --- renders all outputs of one run; the S&H period is a few hundred samples so the runs cross many holds
+static std::vector<float> render(SuperLFO& lfo)
+{
+	std::vector<float> output(kNumModulatorOutputs * kRenderLength);
+	lfo.renderBlock(&output[0], kRenderLength, kAllOutputs);
+	return output;
+}
+
+static void setWaveform(SuperLFO& lfo, LFOWaveform waveform)
+{
+	SuperLFOParameters params = lfo.getParameters();
+	params.waveform = waveform;
+	params.frequency_Hz = 150.0;
+	lfo.setParameters(params);
+}
+
+static void checkWaveform(LFOWaveform waveform, const char* name)
+{
+	// --- a render, another to move the state on, then a reset and the first render again
+	SuperLFO lfo;
+	setWaveform(lfo, waveform);
+	lfo.reset(48000.0);
+	std::vector<float> first = render(lfo);
+	render(lfo);
+	lfo.reset(48000.0);
+	check(render(lfo) == first, "render after reset( ) repeats the first render", name);
+
+	// --- a new object with the same (default) seed
+	SuperLFO fresh;
+	setWaveform(fresh, waveform);
+	fresh.reset(48000.0);
+	check(render(fresh) == first, "render matches a new object with the same seed", name);
+
+	float peak = 0.0f;
+	for (float value : first)
+		peak = fmax(peak, fabs(value));
+	check(peak <= 1.0f, "outputs in [-1, +1]", name);
+}
+
+int main()
+{
+	checkWaveform(LFOWaveform::kRSH, "RSH");
+	checkWaveform(LFOWaveform::kQRSH, "QRSH");
+	checkWaveform(LFOWaveform::kNoise, "noise");
+	checkWaveform(LFOWaveform::kQRNoise, "QR noise");
+
+	printf("%d failure(s)\n", failures);
+	return failures == 0 ? 0 : 1;
+}